@@ -0,0 +1,216 @@
+#include <juce_core/juce_core.h>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include "FlarkDJBatchEngine.h"
+
+/**
+ * FlarkDJBatchBench - FlarkDJBatchEngine throughput in streams per core
+ *
+ * Renders stereo streams through one engine on one thread, with the filter,
+ * reverb, delay and limiter on and different settings in every stream, and
+ * reports how many real-time streams a core sustains: seconds of audio
+ * rendered per second of processing, times the number of streams. Each count
+ * is also rendered with one engine per stream, the way one processor per
+ * stream runs, to show what filling the SIMD lanes gains.
+ *
+ *   FlarkDJBatchBench [--output <file.json>] [--quick] [--pin <cpu>]
+ *                     [--streams 1,16,64,256] [--sample-rate 48000]
+ *                     [--block-size 512] [--seconds <audio per run>]
+ *
+ * Every block is copied from a noise buffer before it is processed, as a
+ * render daemon copies its input in, so the figures include that copy.
+ */
+
+namespace
+{
+    using StreamParameters = FlarkDJBatchEngine::StreamParameters;
+    constexpr int numChannels = 2;
+
+    juce::Array<int> parseList(const juce::String& text)
+    {
+        juce::Array<int> values;
+        for (auto& token : juce::StringArray::fromTokens(text, ",", {}))
+            values.add(token.trim().getIntValue());
+        return values;
+    }
+
+    // Mid-range settings that differ per stream, so no lane takes a bypass
+    StreamParameters makeParameters(juce::Random& random)
+    {
+        StreamParameters p;
+        p.filterOn = p.reverbOn = p.delayOn = true;
+        p.filterType = random.nextInt(3);
+        p.filterCutoff = 200.0f + 4000.0f * random.nextFloat();
+        p.filterResonance = 0.7f + 2.0f * random.nextFloat();
+        p.reverbRoomSize = 0.3f + 0.5f * random.nextFloat();
+        p.reverbDamping = random.nextFloat();
+        p.delayTime = 0.05f + 0.5f * random.nextFloat();
+        p.delayFeedback = 0.2f + 0.5f * random.nextFloat();
+        return p;
+    }
+
+    // Renders numStreams streams as numEngines engines of equal size and
+    // returns the processing time in seconds
+    double render(int numStreams, int numEngines, double sampleRate, int blockSize, int numBlocks)
+    {
+        juce::Random random(42);
+        const int streamsPerEngine = numStreams / numEngines;
+
+        std::vector<std::unique_ptr<FlarkDJBatchEngine>> engines;
+        for (int e = 0; e < numEngines; ++e)
+        {
+            engines.push_back(std::make_unique<FlarkDJBatchEngine>(streamsPerEngine, numChannels));
+            engines.back()->prepare(sampleRate);
+
+            for (int s = 0; s < streamsPerEngine; ++s)
+                engines.back()->setParameters(s, makeParameters(random));
+        }
+
+        // A few seconds of noise to copy blocks from
+        const int noiseLength = 1 << 17;
+        std::vector<float> noise(static_cast<size_t>(noiseLength + blockSize));
+        for (auto& sample : noise)
+            sample = 0.5f * (random.nextFloat() * 2.0f - 1.0f);
+
+        std::vector<std::vector<float>> buffers(static_cast<size_t>(numStreams * numChannels),
+                                                std::vector<float>(static_cast<size_t>(blockSize)));
+        std::vector<float*> channels;
+        for (auto& buffer : buffers)
+            channels.push_back(buffer.data());
+
+        std::vector<float* const*> streams;
+        for (int s = 0; s < numStreams; ++s)
+            streams.push_back(channels.data() + s * numChannels);
+
+        auto runBlock = [&](int block)
+        {
+            for (size_t ch = 0; ch < buffers.size(); ++ch)
+            {
+                const int offset = static_cast<int>((static_cast<size_t>(block) * 7919 + ch * 104729) % static_cast<size_t>(noiseLength));
+                std::copy_n(noise.data() + offset, blockSize, buffers[ch].data());
+            }
+
+            for (int e = 0; e < numEngines; ++e)
+                engines[static_cast<size_t>(e)]->process(streams.data() + e * streamsPerEngine, blockSize);
+        };
+
+        // Warm up the caches and apply the parameters
+        for (int b = 0; b < 4; ++b)
+            runBlock(b);
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int b = 0; b < numBlocks; ++b)
+            runBlock(b);
+
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        std::cout << "Usage: FlarkDJBatchBench [--output <file.json>] [--quick] [--pin <cpu>]\n"
+                     "                         [--streams 1,16,64,256] [--sample-rate 48000]\n"
+                     "                         [--block-size 512] [--seconds <audio per run>]\n";
+        return 0;
+    }
+
+    const bool quick = args.containsOption("--quick");
+
+    auto streamCounts = parseList("1,4,16,64,256");
+    if (args.containsOption("--streams"))
+        streamCounts = parseList(args.getValueForOption("--streams"));
+
+    const double sampleRate = args.containsOption("--sample-rate")
+                                  ? args.getValueForOption("--sample-rate").getDoubleValue() : 48000.0;
+    const int blockSize = args.containsOption("--block-size")
+                              ? juce::jmax(1, args.getValueForOption("--block-size").getIntValue()) : 512;
+
+    double secondsOfAudio = quick ? 1.0 : 5.0;
+    if (args.containsOption("--seconds"))
+        secondsOfAudio = args.getValueForOption("--seconds").getDoubleValue();
+
+    if (args.containsOption("--pin"))
+    {
+        const int core = args.getValueForOption("--pin").getIntValue();
+        if (juce::isPositiveAndBelow(core, 32))
+            juce::Thread::setCurrentThreadAffinityMask(1u << core);
+    }
+
+    const int numBlocks = juce::jmax(1, juce::roundToInt(secondsOfAudio * sampleRate / blockSize));
+    const double renderedSeconds = numBlocks * blockSize / sampleRate;
+
+    juce::Array<juce::var> results;
+
+    for (auto numStreams : streamCounts)
+    {
+        if (numStreams <= 0)
+            continue;
+
+        const double batched = render(numStreams, 1, sampleRate, blockSize, numBlocks);
+        const double separate = render(numStreams, numStreams, sampleRate, blockSize, numBlocks);
+
+        // Real-time streams one core sustains
+        const double streamsPerCore = numStreams * renderedSeconds / batched;
+        const double separateStreamsPerCore = numStreams * renderedSeconds / separate;
+
+        auto* result = new juce::DynamicObject();
+        result->setProperty("streams", numStreams);
+        result->setProperty("streamsPerCore", streamsPerCore);
+        result->setProperty("streamsPerCoreOneEnginePerStream", separateStreamsPerCore);
+        result->setProperty("nsPerStreamSample", batched * 1.0e9 / (numStreams * renderedSeconds * sampleRate));
+        results.add(juce::var(result));
+
+        std::cerr << numStreams << " streams: " << juce::String(streamsPerCore, 1) << " streams/core ("
+                  << juce::String(separateStreamsPerCore, 1) << " with one engine per stream)" << std::endl;
+    }
+
+    auto* build = new juce::DynamicObject();
+    build->setProperty("simd", FlarkDJBatchEngine::getInstructionSet());
+    build->setProperty("lanes", FlarkDJBatchEngine::getLanesPerRegister());
+   #if JUCE_DEBUG
+    build->setProperty("config", "debug");
+   #else
+    build->setProperty("config", "release");
+   #endif
+
+    auto* machine = new juce::DynamicObject();
+    machine->setProperty("cpu", juce::SystemStats::getCpuModel());
+    machine->setProperty("cores", juce::SystemStats::getNumCpus());
+    machine->setProperty("os", juce::SystemStats::getOperatingSystemName());
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("benchmark", "FlarkDJBatchBench");
+    report->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+    report->setProperty("build", juce::var(build));
+    report->setProperty("machine", juce::var(machine));
+    report->setProperty("sampleRate", sampleRate);
+    report->setProperty("blockSize", blockSize);
+    report->setProperty("channels", numChannels);
+    report->setProperty("secondsOfAudio", renderedSeconds);
+    report->setProperty("results", results);
+
+    const auto json = juce::JSON::toString(juce::var(report));
+
+    if (args.containsOption("--output"))
+    {
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+
+        if (! file.replaceWithText(json))
+        {
+            std::cerr << "Cannot write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << json << std::endl;
+    }
+
+    return 0;
+}
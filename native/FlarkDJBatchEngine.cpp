@@ -0,0 +1,776 @@
+#include "FlarkDJBatchEngine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "FlarkDJSIMD.h"
+
+namespace
+{
+    // One stream per lane of the widest register the build targets
+   #if FLARKDJ_SIMD_AVX512
+    using Lanes = FlarkFloat16;
+   #elif FLARKDJ_SIMD_AVX
+    using Lanes = FlarkFloat8;
+   #else
+    using Lanes = FlarkFloat4;
+   #endif
+
+    constexpr int width = Lanes::width;
+    constexpr int maxChannels = FlarkDJBatchEngine::maxChannels;
+    constexpr int maxChunkSize = FlarkDJBatchEngine::maxChunkSize;
+    constexpr int numReverbLines = 8;
+    constexpr float limiterReleaseMs = 80.0f;
+
+    using StreamParameters = FlarkDJBatchEngine::StreamParameters;
+
+    int nextPowerOfTwo(int n)
+    {
+        int power = 1;
+        while (power < n)
+            power <<= 1;
+        return power;
+    }
+
+    // Flushes denormals to zero while in scope, as juce::ScopedNoDenormals
+    // does for the processor. Other targets keep their default mode.
+    struct ScopedFlushDenormals
+    {
+       #if FLARKDJ_SIMD_SSE
+        ScopedFlushDenormals() : previous(_mm_getcsr()) { _mm_setcsr(previous | 0x8040); }  // FTZ | DAZ
+        ~ScopedFlushDenormals() { _mm_setcsr(previous); }
+
+        unsigned int previous;
+       #endif
+    };
+
+    //==============================================================================
+    // Butterworth section coefficients b0, b1, b2, a1, a2
+    enum { B0 = 0, B1, B2, A1, A2, numCoefficients };
+
+    // FlarkButterworthFilter::makeCoefficients, or a pass-through section
+    // while the stream's filter is off
+    void designFilter(const StreamParameters& p, float sampleRate, float* c)
+    {
+        if (! p.filterOn)
+        {
+            c[B0] = 1.0f;
+            c[B1] = c[B2] = c[A1] = c[A2] = 0.0f;
+            return;
+        }
+
+        const float cutoff = std::clamp(p.filterCutoff, 20.0f, 20000.0f);
+        const float freq = std::clamp(cutoff / sampleRate, 0.0001f, 0.499f);
+        const float Q = std::clamp(p.filterResonance, 0.1f, 10.0f);
+
+        // libm rather than FlarkFastMath::tanPi, like the single-stream filter
+        const float K = std::tan(3.14159265358979f * freq);
+        const float norm = 1.0f / (1.0f + K / Q + K * K);
+
+        switch (p.filterType)
+        {
+            case 1:  // highpass
+                c[B0] = 1.0f * norm;
+                c[B1] = -2.0f * norm;
+                c[B2] = 1.0f * norm;
+                break;
+
+            case 2:  // bandpass
+                c[B0] = K / Q * norm;
+                c[B1] = 0.0f;
+                c[B2] = -(K / Q) * norm;
+                break;
+
+            default: // lowpass
+                c[B0] = K * K * norm;
+                c[B1] = 2.0f * c[B0];
+                c[B2] = c[B0];
+                break;
+        }
+
+        c[A1] = 2.0f * (K * K - 1.0f) * norm;
+        c[A2] = (1.0f - K / Q + K * K) * norm;
+    }
+
+    // Kahan-compensated sum += value, so the limiter's moving average does not
+    // drift over hours of audio
+    void addCompensated(Lanes& sum, Lanes& error, Lanes value)
+    {
+        const Lanes y = value - error;
+        const Lanes t = sum + y;
+        error = (t - sum) - y;
+        sum = t;
+    }
+
+    //==============================================================================
+    // The settings and state of `width` streams, lane l holding stream
+    // width * group + l. Everything is stored as lane-interleaved floats: loaded
+    // into registers for a chunk, and addressable per lane when one stream's
+    // parameters change or its slot is reset.
+    struct StreamGroup
+    {
+        // Filter: coefficients shared by the three sections, ramped linearly
+        // as in FlarkBiquadRamp
+        float filterCurrent[numCoefficients][width];
+        float filterTarget[numCoefficients][width];
+        float filterStep[numCoefficients][width];
+        int filterRampRemaining = 0;
+        bool filterJump[width];                       // lanes whose next design applies at once
+        float filterState[maxChannels][3][4][width];  // x1, x2, y1, y2 of each section
+
+        // Reverb
+        float reverbFeedback[width], reverbDamping[width], reverbDry[width], reverbWet[width];
+        float reverbLast[maxChannels][numReverbLines][width];
+        std::vector<float> reverbLines;
+
+        // Delay, read at a different position in each lane
+        float delayFeedback[width], delayDry[width], delayWet[width];
+        float delayFraction[width], delayNextFraction[width];
+        int delayWhole[width];
+        std::vector<float> delayLines;
+
+        // Lookahead limiter, linked across the stream's channels
+        float ceiling[width];
+        float prefixPeak[width], averageSum[width], averageError[width], gain[width];
+        std::vector<float> limiterLines, windowPeaks, suffixPeaks, averageRing;
+
+        // An effect no stream of the group has switched on is skipped. A stream
+        // switching an effect on clears its own lane, so it starts from silence
+        // whether or not the other streams kept the effect running.
+        bool filterLaneOn[width] = {}, reverbLaneOn[width] = {}, delayLaneOn[width] = {};
+        bool filterOn = false, reverbOn = false, delayOn = false;
+        bool filterActive = false;
+        bool parametersChanged = true;
+    };
+
+    template <size_t N>
+    void fillLanes(float (&values)[N], float value) { std::fill(std::begin(values), std::end(values), value); }
+}
+
+//==============================================================================
+struct FlarkDJBatchEngine::Impl
+{
+    Impl(int streams, int channels)
+        : numStreams(std::max(1, streams)),
+          numChannels(std::clamp(channels, 1, maxChannels)),
+          numGroups((numStreams + width - 1) / width),
+          parameters(static_cast<size_t>(numGroups * width)),
+          groups(static_cast<size_t>(numGroups)),
+          work(static_cast<size_t>(maxChannels * maxChunkSize * width))
+    {
+        // Padding lanes past the last stream carry silence with every effect off
+        allocate();
+    }
+
+    //==============================================================================
+    void allocate()
+    {
+        // FlarkReverb's line lengths, specified at 44.1 kHz
+        static constexpr int baseLengths[numReverbLines] = { 1557, 1617, 1491, 1422, 1277, 1356, 1188, 1116 };
+        const float scale = sampleRate / 44100.0f;
+        reverbFrames = 0;
+
+        for (int k = 0; k < numReverbLines; ++k)
+        {
+            reverbLengths[k] = std::max(1, static_cast<int>(std::lround(static_cast<float>(baseLengths[k]) * scale)));
+            reverbOffsets[k] = reverbFrames;
+            reverbFrames += reverbLengths[k];
+        }
+
+        // FlarkDelay's capacity, so a zero delay reads the same stale frame
+        const int maxDelaySamples = static_cast<int>(sampleRate * maxDelaySeconds) + 1;
+        delayMask = nextPowerOfTwo(std::max(2, maxDelaySamples + 2)) - 1;
+
+        maxWindowLength = static_cast<int>(std::ceil(maxLookaheadMs * 0.001f * sampleRate)) + 1;
+        limiterMask = nextPowerOfTwo(maxWindowLength + 1) - 1;
+        releaseCoeff = std::exp(-1.0f / (limiterReleaseMs * 0.001f * sampleRate));
+
+        for (auto& group : groups)
+        {
+            group.reverbLines.assign(static_cast<size_t>(numChannels * reverbFrames * width), 0.0f);
+            group.delayLines.assign(static_cast<size_t>(numChannels * (delayMask + 1) * width), 0.0f);
+            group.limiterLines.assign(static_cast<size_t>(numChannels * (limiterMask + 1) * width), 0.0f);
+            group.windowPeaks.assign(static_cast<size_t>(maxWindowLength * width), 0.0f);
+            group.suffixPeaks.assign(static_cast<size_t>((maxWindowLength + 1) * width), 0.0f);
+            group.averageRing.assign(static_cast<size_t>(maxWindowLength * width), 1.0f);
+
+            for (int k = 0; k < numCoefficients; ++k)
+                fillLanes(group.filterTarget[k], k == B0 ? 1.0f : 0.0f);
+        }
+
+        updateLookahead();
+        reset();
+    }
+
+    void updateLookahead()
+    {
+        latency = static_cast<int>(std::lround(lookaheadMs * 0.001f * sampleRate));
+        windowLength = latency + 1;
+    }
+
+    void reset()
+    {
+        std::fill(std::begin(reverbPositions), std::end(reverbPositions), 0);
+        delayWritePos = 0;
+
+        for (auto& group : groups)
+        {
+            std::copy(&group.filterTarget[0][0], &group.filterTarget[0][0] + numCoefficients * width, &group.filterCurrent[0][0]);
+            std::fill(&group.filterStep[0][0], &group.filterStep[0][0] + numCoefficients * width, 0.0f);
+            std::fill(std::begin(group.filterJump), std::end(group.filterJump), true);
+            group.filterRampRemaining = 0;
+            group.parametersChanged = true;
+
+            clearFilter(group);
+            clearReverb(group);
+            clearDelay(group);
+        }
+
+        resetLimiters();
+    }
+
+    void resetLimiters()
+    {
+        windowPos = 0;
+        limiterWritePos = 0;
+
+        for (auto& group : groups)
+        {
+            std::fill(group.limiterLines.begin(), group.limiterLines.end(), 0.0f);
+            std::fill(group.windowPeaks.begin(), group.windowPeaks.end(), 0.0f);
+            std::fill(group.suffixPeaks.begin(), group.suffixPeaks.end(), 0.0f);
+            std::fill(group.averageRing.begin(), group.averageRing.end(), 1.0f);
+            fillLanes(group.prefixPeak, 0.0f);
+            fillLanes(group.averageSum, static_cast<float>(windowLength));
+            fillLanes(group.averageError, 0.0f);
+            fillLanes(group.gain, 1.0f);
+        }
+    }
+
+    static void clearFilter(StreamGroup& group)
+    {
+        std::fill(&group.filterState[0][0][0][0], &group.filterState[0][0][0][0] + maxChannels * 3 * 4 * width, 0.0f);
+    }
+
+    static void clearReverb(StreamGroup& group)
+    {
+        std::fill(group.reverbLines.begin(), group.reverbLines.end(), 0.0f);
+        std::fill(&group.reverbLast[0][0][0], &group.reverbLast[0][0][0] + maxChannels * numReverbLines * width, 0.0f);
+    }
+
+    static void clearDelay(StreamGroup& group)
+    {
+        std::fill(group.delayLines.begin(), group.delayLines.end(), 0.0f);
+    }
+
+    // Zeroes one lane of lane-interleaved frames
+    static void clearLane(float* frames, size_t numFrames, int lane, float value = 0.0f)
+    {
+        for (size_t f = 0; f < numFrames; ++f)
+            frames[f * width + static_cast<size_t>(lane)] = value;
+    }
+
+    void resetStream(int stream)
+    {
+        auto& group = groups[static_cast<size_t>(stream / width)];
+        const int lane = stream % width;
+
+        clearLane(&group.filterState[0][0][0][0], maxChannels * 3 * 4, lane);
+        clearLane(&group.reverbLast[0][0][0], maxChannels * numReverbLines, lane);
+        clearLane(group.reverbLines.data(), group.reverbLines.size() / width, lane);
+        clearLane(group.delayLines.data(), group.delayLines.size() / width, lane);
+        clearLane(group.limiterLines.data(), group.limiterLines.size() / width, lane);
+        clearLane(group.windowPeaks.data(), group.windowPeaks.size() / width, lane);
+        clearLane(group.suffixPeaks.data(), group.suffixPeaks.size() / width, lane);
+        clearLane(group.averageRing.data(), group.averageRing.size() / width, lane, 1.0f);
+
+        group.prefixPeak[lane] = 0.0f;
+        group.averageSum[lane] = static_cast<float>(windowLength);
+        group.averageError[lane] = 0.0f;
+        group.gain[lane] = 1.0f;
+        group.filterJump[lane] = true;
+        group.parametersChanged = true;
+    }
+
+    //==============================================================================
+    // Turns the parameters of a group's streams into lane settings
+    void updateParameters(StreamGroup& group, const StreamParameters* lanes, int rampSamples)
+    {
+        float design[numCoefficients][width];
+        group.filterOn = group.reverbOn = group.delayOn = false;
+
+        for (int l = 0; l < width; ++l)
+        {
+            const auto& p = lanes[l];
+
+            float c[numCoefficients];
+            designFilter(p, sampleRate, c);
+            for (int k = 0; k < numCoefficients; ++k)
+                design[k][l] = c[k];
+
+            // An effect that is off in a running group has no wet signal, as if
+            // its return were muted
+            const float reverbMix = p.reverbOn ? std::clamp(p.reverbWetDry, 0.0f, 1.0f) : 0.0f;
+            group.reverbFeedback[l] = 0.5f * std::clamp(p.reverbRoomSize, 0.0f, 1.0f);
+            group.reverbDamping[l] = std::clamp(p.reverbDamping, 0.0f, 1.0f);
+            group.reverbDry[l] = 1.0f - reverbMix;
+            group.reverbWet[l] = reverbMix;
+
+            const float delayMix = p.delayOn ? std::clamp(p.delayWetDry, 0.0f, 1.0f) : 0.0f;
+            const float delaySamples = std::clamp(p.delayTime, 0.0f, maxDelaySeconds) * sampleRate;
+            group.delayWhole[l] = static_cast<int>(delaySamples);
+            group.delayFraction[l] = delaySamples - static_cast<float>(group.delayWhole[l]);
+            group.delayNextFraction[l] = 1.0f - group.delayFraction[l];
+            group.delayFeedback[l] = std::clamp(p.delayFeedback, 0.0f, 0.95f);
+            group.delayDry[l] = 1.0f - delayMix;
+            group.delayWet[l] = delayMix;
+
+            group.ceiling[l] = std::clamp(p.limiterCeiling, 0.01f, 1.0f);
+
+            if (p.filterOn && ! group.filterLaneOn[l])
+                clearLane(&group.filterState[0][0][0][0], maxChannels * 3 * 4, l);
+            if (p.reverbOn && ! group.reverbLaneOn[l])
+            {
+                clearLane(&group.reverbLast[0][0][0], maxChannels * numReverbLines, l);
+                clearLane(group.reverbLines.data(), group.reverbLines.size() / width, l);
+            }
+            if (p.delayOn && ! group.delayLaneOn[l])
+                clearLane(group.delayLines.data(), group.delayLines.size() / width, l);
+
+            group.filterLaneOn[l] = p.filterOn;
+            group.reverbLaneOn[l] = p.reverbOn;
+            group.delayLaneOn[l] = p.delayOn;
+            group.filterOn = group.filterOn || p.filterOn;
+            group.reverbOn = group.reverbOn || p.reverbOn;
+            group.delayOn = group.delayOn || p.delayOn;
+        }
+
+        if (std::memcmp(design, group.filterTarget, sizeof(design)) != 0)
+            rampFilter(group, design, rampSamples);
+
+        group.filterActive = group.filterOn || group.filterRampRemaining > 0;
+        group.parametersChanged = false;
+    }
+
+    // FlarkBiquadRamp::rampTo for every lane
+    static void rampFilter(StreamGroup& group, const float (&design)[numCoefficients][width], int rampSamples)
+    {
+        std::copy(&design[0][0], &design[0][0] + numCoefficients * width, &group.filterTarget[0][0]);
+
+        for (int l = 0; l < width; ++l)
+        {
+            if (group.filterJump[l] || rampSamples <= 1)
+                for (int k = 0; k < numCoefficients; ++k)
+                    group.filterCurrent[k][l] = group.filterTarget[k][l];
+
+            group.filterJump[l] = false;
+        }
+
+        const float scale = 1.0f / static_cast<float>(rampSamples);
+        for (int k = 0; k < numCoefficients; ++k)
+            for (int l = 0; l < width; ++l)
+                group.filterStep[k][l] = (group.filterTarget[k][l] - group.filterCurrent[k][l]) * scale;
+
+        group.filterRampRemaining = rampSamples > 1 ? rampSamples : 0;
+    }
+
+    //==============================================================================
+    void process(float* const* const* streams, int numSamples)
+    {
+        const int rampSamples = std::min(numSamples, maxChunkSize);
+
+        for (int g = 0; g < numGroups; ++g)
+        {
+            auto& group = groups[static_cast<size_t>(g)];
+            if (group.parametersChanged)
+                updateParameters(group, parameters.data() + g * width, rampSamples);
+        }
+
+        for (int start = 0; start < numSamples; start += maxChunkSize)
+            processChunk(streams, start, std::min(maxChunkSize, numSamples - start));
+    }
+
+    void processChunk(float* const* const* streams, int offset, int numSamples)
+    {
+        for (int g = 0; g < numGroups; ++g)
+        {
+            auto& group = groups[static_cast<size_t>(g)];
+
+            // Transpose into lanes: frame i of channel c is work[c][i * width, ...]
+            for (int c = 0; c < numChannels; ++c)
+            {
+                float* frames = work.data() + c * maxChunkSize * width;
+
+                for (int l = 0; l < width; ++l)
+                {
+                    const int stream = g * width + l;
+
+                    if (stream < numStreams)
+                    {
+                        const float* source = streams[stream][c] + offset;
+                        for (int i = 0; i < numSamples; ++i)
+                            frames[i * width + l] = source[i];
+                    }
+                    else
+                    {
+                        for (int i = 0; i < numSamples; ++i)
+                            frames[i * width + l] = 0.0f;
+                    }
+                }
+            }
+
+            if (group.filterActive)
+                processFilter(group, numSamples);
+            if (group.reverbOn)
+                processReverb(group, numSamples);
+            if (group.delayOn)
+                processDelay(group, numSamples);
+
+            processLimiter(group, numSamples);
+
+            for (int c = 0; c < numChannels; ++c)
+            {
+                const float* frames = work.data() + c * maxChunkSize * width;
+
+                for (int l = 0; l < width && g * width + l < numStreams; ++l)
+                {
+                    float* dest = streams[g * width + l][c] + offset;
+                    for (int i = 0; i < numSamples; ++i)
+                        dest[i] = frames[i * width + l];
+                }
+            }
+        }
+
+        // Line positions are shared by every group
+        for (int k = 0; k < numReverbLines; ++k)
+            reverbPositions[k] = (reverbPositions[k] + numSamples) % reverbLengths[k];
+
+        delayWritePos = (delayWritePos + numSamples) & delayMask;
+        windowPos = (windowPos + numSamples) % windowLength;
+        limiterWritePos = (limiterWritePos + numSamples) & limiterMask;
+    }
+
+    //==============================================================================
+    // Three cascaded sections sharing each lane's coefficients, as in
+    // FlarkMultichannelButterworthFilter
+    void processFilter(StreamGroup& group, int numSamples)
+    {
+        Lanes target[numCoefficients], step[numCoefficients], current[numCoefficients];
+        for (int k = 0; k < numCoefficients; ++k)
+        {
+            target[k] = Lanes::load(group.filterTarget[k]);
+            step[k] = Lanes::load(group.filterStep[k]);
+        }
+
+        int remaining = 0;
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            for (int k = 0; k < numCoefficients; ++k)
+                current[k] = Lanes::load(group.filterCurrent[k]);
+
+            Lanes s[3][4];
+            for (int n = 0; n < 3; ++n)
+                for (int v = 0; v < 4; ++v)
+                    s[n][v] = Lanes::load(group.filterState[c][n][v]);
+
+            float* frames = work.data() + c * maxChunkSize * width;
+            remaining = group.filterRampRemaining;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                if (remaining > 0)
+                {
+                    if (--remaining == 0)
+                        std::copy(std::begin(target), std::end(target), std::begin(current));
+                    else
+                        for (int k = 0; k < numCoefficients; ++k)
+                            current[k] = current[k] + step[k];
+                }
+
+                Lanes output = Lanes::load(frames + i * width);
+
+                for (auto& section : s)
+                {
+                    const Lanes input = output;
+                    output = current[B0] * input + current[B1] * section[0] + current[B2] * section[1]
+                           - current[A1] * section[2] - current[A2] * section[3];
+                    section[1] = section[0]; section[0] = input;
+                    section[3] = section[2]; section[2] = output;
+                }
+
+                output.store(frames + i * width);
+            }
+
+            for (int n = 0; n < 3; ++n)
+                for (int v = 0; v < 4; ++v)
+                    s[n][v].store(group.filterState[c][n][v]);
+
+            if (c == numChannels - 1)
+                for (int k = 0; k < numCoefficients; ++k)
+                    current[k].store(group.filterCurrent[k]);
+        }
+
+        group.filterRampRemaining = remaining;
+        group.filterActive = group.filterOn || remaining > 0;
+    }
+
+    // FlarkReverb with each lane's room size, damping and mix
+    void processReverb(StreamGroup& group, int numSamples)
+    {
+        const Lanes damp = Lanes::load(group.reverbDamping);
+        const Lanes feedback = Lanes::load(group.reverbFeedback);
+        const Lanes dryGain = Lanes::load(group.reverbDry);
+        const Lanes wetGain = Lanes::load(group.reverbWet);
+        const Lanes scale = Lanes::broadcast(1.0f / numReverbLines);
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            float* lines = group.reverbLines.data() + c * reverbFrames * width;
+            float* frames = work.data() + c * maxChunkSize * width;
+
+            int positions[numReverbLines];
+            std::copy(std::begin(reverbPositions), std::end(reverbPositions), std::begin(positions));
+
+            Lanes last[numReverbLines];
+            for (int k = 0; k < numReverbLines; ++k)
+                last[k] = Lanes::load(group.reverbLast[c][k]);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const Lanes in = Lanes::load(frames + i * width);
+                Lanes delayed[numReverbLines];
+
+                for (int k = 0; k < numReverbLines; ++k)
+                {
+                    float* cell = lines + (reverbOffsets[k] + positions[k]) * width;
+
+                    delayed[k] = last[k] + damp * (Lanes::load(cell) - last[k]);
+                    last[k] = delayed[k];
+                    (in + delayed[k] * feedback).store(cell);
+
+                    const int next = positions[k] + 1;
+                    positions[k] = next & -static_cast<int>(next < reverbLengths[k]);
+                }
+
+                const Lanes sum = ((delayed[0] + delayed[4]) + (delayed[2] + delayed[6]))
+                                + ((delayed[1] + delayed[5]) + (delayed[3] + delayed[7]));
+
+                (in * dryGain + sum * scale * wetGain).store(frames + i * width);
+            }
+
+            for (int k = 0; k < numReverbLines; ++k)
+                last[k].store(group.reverbLast[c][k]);
+        }
+    }
+
+    // FlarkDelay with each lane's time, feedback and mix; the two taps are
+    // gathered from a different position in every lane
+    void processDelay(StreamGroup& group, int numSamples)
+    {
+        const Lanes fraction = Lanes::load(group.delayFraction);
+        const Lanes nextFraction = Lanes::load(group.delayNextFraction);
+        const Lanes feedback = Lanes::load(group.delayFeedback);
+        const Lanes dryGain = Lanes::load(group.delayDry);
+        const Lanes wetGain = Lanes::load(group.delayWet);
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            float* line = group.delayLines.data() + c * (delayMask + 1) * width;
+            float* frames = work.data() + c * maxChunkSize * width;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const int writePos = (delayWritePos + i) & delayMask;
+                int older[width], newer[width];
+
+                for (int l = 0; l < width; ++l)
+                {
+                    older[l] = ((writePos - group.delayWhole[l] - 1) & delayMask) * width + l;
+                    newer[l] = ((writePos - group.delayWhole[l]) & delayMask) * width + l;
+                }
+
+                const Lanes in = Lanes::load(frames + i * width);
+                const Lanes delayed = Lanes::gather(line, older) * fraction + Lanes::gather(line, newer) * nextFraction;
+
+                (in + delayed * feedback).store(line + writePos * width);
+                (in * dryGain + delayed * wetGain).store(frames + i * width);
+            }
+        }
+    }
+
+    // FlarkLookaheadLimiter with each lane's ceiling. The hold window has the
+    // same length in every lane, so its sliding maximum is taken block-wise
+    // (van Herk / Gil-Werman): the maximum of the previous window-length block
+    // from each position on, against the running maximum of the current one.
+    // That needs no per-lane branching, unlike FlarkLookaheadLimiter's deque.
+    void processLimiter(StreamGroup& group, int numSamples)
+    {
+        const Lanes ceiling = Lanes::load(group.ceiling);
+        const Lanes one = Lanes::broadcast(1.0f);
+        const Lanes release = Lanes::broadcast(releaseCoeff);
+        const Lanes inverseLength = Lanes::broadcast(1.0f / static_cast<float>(windowLength));
+
+        Lanes prefix = Lanes::load(group.prefixPeak);
+        Lanes sum = Lanes::load(group.averageSum);
+        Lanes error = Lanes::load(group.averageError);
+        Lanes gain = Lanes::load(group.gain);
+
+        float* peaks = group.windowPeaks.data();
+        float* suffix = group.suffixPeaks.data();
+        float* ring = group.averageRing.data();
+        int pos = windowPos;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            Lanes peak = Lanes::load(work.data() + i * width).abs();
+            for (int c = 1; c < numChannels; ++c)
+                peak = Lanes::max(peak, Lanes::load(work.data() + (c * maxChunkSize + i) * width).abs());
+
+            peak.store(peaks + pos * width);
+            prefix = pos == 0 ? peak : Lanes::max(prefix, peak);
+
+            const Lanes windowPeak = Lanes::max(Lanes::load(suffix + (pos + 1) * width), prefix);
+            const Lanes target = Lanes::min(one, ceiling / windowPeak);
+
+            // Moving average: the gain reaches the target across the lookahead
+            const Lanes oldest = Lanes::load(ring + pos * width);
+            target.store(ring + pos * width);
+            addCompensated(sum, error, target);
+            addCompensated(sum, error, Lanes::zero() - oldest);
+
+            const Lanes attack = sum * inverseLength;
+            gain = Lanes::min(attack, attack + release * (gain - attack));
+
+            if (++pos == windowLength)
+            {
+                for (int j = windowLength - 1; j >= 0; --j)
+                    Lanes::max(Lanes::load(peaks + j * width), Lanes::load(suffix + (j + 1) * width)).store(suffix + j * width);
+
+                pos = 0;
+            }
+
+            const int writePos = (limiterWritePos + i) & limiterMask;
+            const int readPos = (writePos - latency) & limiterMask;
+
+            for (int c = 0; c < numChannels; ++c)
+            {
+                float* line = group.limiterLines.data() + c * (limiterMask + 1) * width;
+                float* frame = work.data() + (c * maxChunkSize + i) * width;
+
+                Lanes::load(frame).store(line + writePos * width);
+                (Lanes::load(line + readPos * width) * gain).store(frame);
+            }
+        }
+
+        prefix.store(group.prefixPeak);
+        sum.store(group.averageSum);
+        error.store(group.averageError);
+        gain.store(group.gain);
+    }
+
+    //==============================================================================
+    const int numStreams, numChannels, numGroups;
+    std::vector<StreamParameters> parameters;  // numGroups * width, padding lanes left off
+    std::vector<StreamGroup> groups;
+    std::vector<float> work;                   // one chunk of every channel, in lanes
+
+    float sampleRate = 44100.0f;
+
+    int reverbLengths[numReverbLines] = {}, reverbOffsets[numReverbLines] = {};
+    int reverbPositions[numReverbLines] = {};  // shared by every group and channel
+    int reverbFrames = 0;                      // frames per channel, all lines
+
+    int delayMask = 0, delayWritePos = 0;
+
+    float lookaheadMs = 1.5f;
+    float releaseCoeff = 0.0f;
+    int latency = 0, windowLength = 1, maxWindowLength = 1, windowPos = 0;
+    int limiterMask = 0, limiterWritePos = 0;
+};
+
+//==============================================================================
+FlarkDJBatchEngine::FlarkDJBatchEngine(int numStreams, int numChannels)
+    : impl(std::make_unique<Impl>(numStreams, numChannels))
+{
+}
+
+FlarkDJBatchEngine::~FlarkDJBatchEngine() = default;
+
+void FlarkDJBatchEngine::prepare(double sampleRate)
+{
+    impl->sampleRate = static_cast<float>(sampleRate);
+    impl->allocate();
+}
+
+void FlarkDJBatchEngine::reset()
+{
+    impl->reset();
+}
+
+void FlarkDJBatchEngine::resetStream(int stream)
+{
+    if (stream >= 0 && stream < impl->numStreams)
+        impl->resetStream(stream);
+}
+
+void FlarkDJBatchEngine::setParameters(int stream, const StreamParameters& parameters)
+{
+    if (stream < 0 || stream >= impl->numStreams)
+        return;
+
+    impl->parameters[static_cast<size_t>(stream)] = parameters;
+    impl->groups[static_cast<size_t>(stream / width)].parametersChanged = true;
+}
+
+const FlarkDJBatchEngine::StreamParameters& FlarkDJBatchEngine::getParameters(int stream) const
+{
+    return impl->parameters[static_cast<size_t>(std::clamp(stream, 0, impl->numStreams - 1))];
+}
+
+void FlarkDJBatchEngine::setLimiterLookahead(float milliseconds)
+{
+    impl->lookaheadMs = std::clamp(milliseconds, 0.0f, maxLookaheadMs);
+    impl->updateLookahead();
+    impl->resetLimiters();
+}
+
+int FlarkDJBatchEngine::getLatencySamples() const
+{
+    return impl->latency;
+}
+
+void FlarkDJBatchEngine::process(float* const* const* streams, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    ScopedFlushDenormals noDenormals;
+    impl->process(streams, numSamples);
+}
+
+int FlarkDJBatchEngine::getNumStreams() const  { return impl->numStreams; }
+int FlarkDJBatchEngine::getNumChannels() const { return impl->numChannels; }
+
+int FlarkDJBatchEngine::getLanesPerRegister()
+{
+    return width;
+}
+
+const char* FlarkDJBatchEngine::getInstructionSet()
+{
+   #if FLARKDJ_SIMD_AVX512
+    return "avx512";
+   #elif FLARKDJ_SIMD_AVX && defined(__AVX2__)
+    return "avx2";
+   #elif FLARKDJ_SIMD_AVX
+    return "avx";
+   #elif FLARKDJ_SIMD_SSE
+    return "sse";
+   #elif FLARKDJ_SIMD_NEON
+    return "neon";
+   #else
+    return "scalar";
+   #endif
+}
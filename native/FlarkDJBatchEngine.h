@@ -0,0 +1,90 @@
+#pragma once
+
+#include <memory>
+
+/**
+ * FlarkDJ Batch Engine
+ *
+ * Renders many independent streams at once, for servers that process
+ * previews or radio channels side by side. Each stream has its own
+ * parameters and state, but the state of all streams is laid out lane-wise:
+ * stream s lives in lane s % width of register group s / width, so every
+ * instruction of the filter, reverb, delay and limiter recurrences advances
+ * `width` streams (4 with SSE/NEON, 8 with AVX, 16 with AVX-512, set by the
+ * build's target flags; see FLARKDJ_BATCH_ARCH).
+ *
+ * The chain is FlarkDJProcessor's without modulation: Butterworth filter,
+ * reverb, delay and lookahead limiter. A stream renders what those effects
+ * from FlarkDJDSP.h would produce on their own (FlarkDJBatchTests checks it).
+ * An effect a stream switches on starts from silence, whatever the streams
+ * sharing its register are doing.
+ *
+ * Plain C++ with no JUCE dependency, so render daemons can link the FlarkDJBatch
+ * library directly. An engine is not thread-safe: run one per core, each with
+ * its own set of streams.
+ */
+class FlarkDJBatchEngine
+{
+public:
+    struct StreamParameters
+    {
+        bool filterOn = false;
+        int filterType = 0;              // 0 lowpass, 1 highpass, 2 bandpass
+        float filterCutoff = 400.0f;     // Hz, 20 to 20000
+        float filterResonance = 3.0f;    // Q, 0.1 to 10
+
+        bool reverbOn = false;
+        float reverbRoomSize = 0.5f, reverbDamping = 0.5f, reverbWetDry = 0.6f;
+
+        bool delayOn = false;
+        float delayTime = 0.5f;          // seconds, up to maxDelaySeconds
+        float delayFeedback = 0.3f;      // 0 to 0.95
+        float delayWetDry = 0.5f;
+
+        float limiterCeiling = 0.95f;    // linear
+    };
+
+    static constexpr int maxChannels = 2;
+    static constexpr float maxDelaySeconds = 2.0f;
+    static constexpr float maxLookaheadMs = 10.0f;
+    static constexpr int maxChunkSize = 256;  // samples per pass through the chain
+
+    // numStreams streams of numChannels channels each (mono or stereo)
+    FlarkDJBatchEngine(int numStreams, int numChannels);
+    ~FlarkDJBatchEngine();
+
+    // Allocates and clears every stream; call before processing
+    void prepare(double sampleRate);
+
+    // Clears every stream, or one stream whose slot is handed to new material
+    void reset();
+    void resetStream(int stream);
+
+    // Applied at the start of the next process() call. Filter changes glide
+    // over its first maxChunkSize samples; the other settings jump.
+    void setParameters(int stream, const StreamParameters& parameters);
+    const StreamParameters& getParameters(int stream) const;
+
+    // Shared by all streams, 0 to maxLookaheadMs. Changes the latency and
+    // clears the limiters.
+    void setLimiterLookahead(float milliseconds);
+    int getLatencySamples() const;
+
+    // streams[s][c] is channel c of stream s, processed in place. Any block
+    // size; the chain runs over chunks of up to maxChunkSize samples.
+    void process(float* const* const* streams, int numSamples);
+
+    int getNumStreams() const;
+    int getNumChannels() const;
+
+    // Streams per register, and the instruction set providing them
+    static int getLanesPerRegister();
+    static const char* getInstructionSet();
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl;
+
+    FlarkDJBatchEngine(const FlarkDJBatchEngine&) = delete;
+    FlarkDJBatchEngine& operator=(const FlarkDJBatchEngine&) = delete;
+};
@@ -0,0 +1,251 @@
+#include <juce_core/juce_core.h>
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include "FlarkDJBatchEngine.h"
+#include "FlarkDJDSP.h"
+
+/**
+ * FlarkDJBatchTests - FlarkDJBatchEngine against the single-stream effects
+ *
+ * Renders streams with different settings through one engine, and each of
+ * them on its own through FlarkDJDSP's filter, reverb, delay and lookahead
+ * limiter, and fails if any sample differs by more than -100 dBFS. The run
+ * covers effects switched off in some streams, reverbs and delays switched
+ * off and back on while other streams keep theirs running, filter glides,
+ * blocks longer than a chunk, a zero delay, a stream slot reset and handed new
+ * settings halfway, and a stream count that leaves padding lanes in the last
+ * register.
+ *
+ *   FlarkDJBatchTests [--verbose]
+ */
+
+namespace
+{
+    using StreamParameters = FlarkDJBatchEngine::StreamParameters;
+
+    constexpr double sampleRate = 48000.0;
+    constexpr int numStreams = 13;
+    constexpr int numChannels = 2;
+    constexpr float lookaheadMs = 1.5f;
+    constexpr float tolerance = 1.0e-5f;  // -100 dBFS
+
+    // One stream through the FlarkDJDSP effects, in FlarkDJProcessor's order
+    struct Reference
+    {
+        explicit Reference(const StreamParameters& p) : params(p)
+        {
+            const auto sr = static_cast<float>(sampleRate);
+
+            filter.setSampleRate(sr);
+            filter.setParameters(static_cast<FlarkButterworthFilter::FilterType>(p.filterType),
+                                 p.filterCutoff, p.filterResonance);
+
+            reverb.setNumChannels(numChannels);
+            reverb.setSampleRate(sr);
+            reverb.setRoomSize(p.reverbRoomSize);
+            reverb.setDamping(p.reverbDamping);
+            reverb.setWetDryMix(p.reverbWetDry);
+
+            delay.setNumChannels(numChannels);
+            delay.setSampleRate(sr);
+            delay.setDelayTime(p.delayTime);
+            delay.setFeedback(p.delayFeedback);
+            delay.setWetDryMix(p.delayWetDry);
+
+            limiter.setSampleRate(sr);
+            limiter.setLookahead(lookaheadMs);
+            limiter.setCeiling(p.limiterCeiling);
+        }
+
+        void setCutoffSmoothed(float cutoff, int rampSamples)
+        {
+            params.filterCutoff = cutoff;
+            filter.setCutoffSmoothed(cutoff, rampSamples);
+        }
+
+        // An effect switched back on starts from silence
+        void setEffects(bool reverbOn, bool delayOn)
+        {
+            if (reverbOn && ! params.reverbOn)
+                reverb.reset();
+            if (delayOn && ! params.delayOn)
+                delay.reset();
+
+            params.reverbOn = reverbOn;
+            params.delayOn = delayOn;
+        }
+
+        void process(float* const* channels, int numSamples)
+        {
+            if (params.filterOn)
+                filter.processBlock(channels, numChannels, numSamples);
+            if (params.reverbOn)
+                reverb.processBlock(channels, numChannels, numSamples);
+            if (params.delayOn)
+                delay.processBlock(channels, numChannels, numSamples);
+
+            limiter.processBlock(channels, numChannels, numSamples);
+        }
+
+        StreamParameters params;
+        FlarkMultichannelButterworthFilter filter;
+        FlarkReverb reverb;
+        FlarkDelay delay;
+        FlarkLookaheadLimiter limiter;
+    };
+
+    StreamParameters makeParameters(int stream, juce::Random& random)
+    {
+        StreamParameters p;
+        p.filterOn = stream % 4 != 3;
+        p.filterType = stream % 3;
+        p.filterCutoff = 100.0f * std::pow(100.0f, random.nextFloat());
+        p.filterResonance = 0.5f + 4.5f * random.nextFloat();
+
+        p.reverbOn = stream % 2 == 0;
+        p.reverbRoomSize = random.nextFloat();
+        p.reverbDamping = random.nextFloat();
+        p.reverbWetDry = random.nextFloat();
+
+        p.delayOn = stream % 3 != 1;
+        p.delayTime = stream == 0 ? 0.0f : 0.3f * random.nextFloat();
+        p.delayFeedback = 0.9f * random.nextFloat();
+        p.delayWetDry = random.nextFloat();
+
+        p.limiterCeiling = 0.5f + 0.5f * random.nextFloat();
+        return p;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+    const bool verbose = args.containsOption("--verbose");
+
+    juce::Random random(1234);
+
+    FlarkDJBatchEngine engine(numStreams, numChannels);
+    engine.prepare(sampleRate);
+    engine.setLimiterLookahead(lookaheadMs);
+
+    std::vector<std::unique_ptr<Reference>> references;
+
+    for (int s = 0; s < numStreams; ++s)
+    {
+        const auto p = makeParameters(s, random);
+        engine.setParameters(s, p);
+        references.push_back(std::make_unique<Reference>(p));
+    }
+
+    // Includes blocks longer than a chunk and a single sample
+    const int blockSizes[] = { 128, 64, 700, 1, 256, 300, 37, 512 };
+    constexpr int numBlocks = 96;
+    constexpr int glideBlock = 24, resetBlock = 48;
+    constexpr int toggleBlocks[] = { 36, 72 };
+    constexpr int resetStream = 5;
+
+    // Channel c of stream s is buffer s * numChannels + c
+    constexpr int numBuffers = numStreams * numChannels;
+    std::vector<std::vector<float>> batch(numBuffers, std::vector<float>(1024));
+    std::vector<std::vector<float>> single(numBuffers);
+
+    std::vector<float*> batchChannels, singleChannels;
+    for (int ch = 0; ch < numBuffers; ++ch)
+        batchChannels.push_back(batch[static_cast<size_t>(ch)].data());
+
+    std::vector<float* const*> streams;
+    for (int s = 0; s < numStreams; ++s)
+        streams.push_back(batchChannels.data() + s * numChannels);
+
+    float worstError = 0.0f;
+    int worstStream = -1;
+
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        const int numSamples = blockSizes[b % juce::numElementsInArray(blockSizes)];
+
+        if (b == glideBlock)
+        {
+            // Filter glides, spread over the first chunk of the block
+            for (int s = 0; s < numStreams; s += 2)
+            {
+                auto p = engine.getParameters(s);
+                p.filterCutoff *= 0.5f + random.nextFloat();
+                engine.setParameters(s, p);
+                references[static_cast<size_t>(s)]->setCutoffSmoothed(p.filterCutoff,
+                                                                       juce::jmin(numSamples, FlarkDJBatchEngine::maxChunkSize));
+            }
+        }
+
+        if (std::find(std::begin(toggleBlocks), std::end(toggleBlocks), b) != std::end(toggleBlocks))
+        {
+            // Every third stream flips its reverb and delay, sharing registers
+            // with streams that leave theirs as they are
+            for (int s = 0; s < numStreams; s += 3)
+            {
+                auto p = engine.getParameters(s);
+                p.reverbOn = ! p.reverbOn;
+                p.delayOn = ! p.delayOn;
+                engine.setParameters(s, p);
+                references[static_cast<size_t>(s)]->setEffects(p.reverbOn, p.delayOn);
+            }
+        }
+
+        if (b == resetBlock)
+        {
+            // The slot is handed to a new stream
+            auto p = makeParameters(resetStream + 1, random);
+            engine.resetStream(resetStream);
+            engine.setParameters(resetStream, p);
+            references[static_cast<size_t>(resetStream)] = std::make_unique<Reference>(p);
+        }
+
+        // Noise with louder bursts, so the limiters work
+        for (int ch = 0; ch < numBuffers; ++ch)
+        {
+            const float level = (b / 4 + ch) % 5 == 0 ? 2.0f : 0.5f;
+            for (int i = 0; i < numSamples; ++i)
+                batch[static_cast<size_t>(ch)][static_cast<size_t>(i)] = level * (random.nextFloat() * 2.0f - 1.0f);
+        }
+
+        single = batch;
+        singleChannels.clear();
+        for (auto& channel : single)
+            singleChannels.push_back(channel.data());
+
+        engine.process(streams.data(), numSamples);
+
+        for (int s = 0; s < numStreams; ++s)
+            references[static_cast<size_t>(s)]->process(singleChannels.data() + s * numChannels, numSamples);
+
+        for (int ch = 0; ch < numBuffers; ++ch)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float error = std::abs(batch[static_cast<size_t>(ch)][static_cast<size_t>(i)]
+                                             - single[static_cast<size_t>(ch)][static_cast<size_t>(i)]);
+                if (error > worstError)
+                {
+                    worstError = error;
+                    worstStream = ch / numChannels;
+                }
+            }
+        }
+
+        if (verbose)
+            std::cout << "block " << b << " (" << numSamples << " samples): worst error so far "
+                      << worstError << std::endl;
+    }
+
+    const bool passed = worstError <= tolerance;
+
+    std::cout << (passed ? "PASS" : "FAIL") << "  " << numStreams << " streams, "
+              << FlarkDJBatchEngine::getLanesPerRegister() << " lanes (" << FlarkDJBatchEngine::getInstructionSet()
+              << "): max error " << worstError;
+    if (worstStream >= 0)
+        std::cout << " in stream " << worstStream;
+    std::cout << std::endl;
+
+    return passed ? 0 : 1;
+}
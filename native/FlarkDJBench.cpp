@@ -0,0 +1,543 @@
+#include <juce_core/juce_core.h>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include "FlarkDJDSP.h"
+#include "FlarkDJMetering.h"
+
+/**
+ * FlarkDJBench - DSP kernel micro-benchmarks
+ *
+ * Measures ns/sample for each FlarkDJDSP kernel across block sizes and sample
+ * rates and prints the results as JSON, so runs from different builds or
+ * machines can be diffed.
+ *
+ *   FlarkDJBench [--output <file.json>] [--filter <kernel substring>] [--quick]
+ *
+ * Every block is copied from a noise buffer before it is processed, so the
+ * figures include one memcpy per sample; "baseline/copy" measures that alone.
+ * Multichannel kernels report ns per frame (one sample of every channel).
+ */
+
+namespace
+{
+    // Processes one block in place
+    using BlockFunction = std::function<void(float* data, int numSamples)>;
+
+    struct Kernel
+    {
+        juce::String name;
+        int numChannels;
+        std::function<BlockFunction(float sampleRate, int maxBlockSize)> create;
+    };
+
+    // Effect settings are typical mid-range values, so no kernel takes a bypass
+    std::vector<Kernel> makeKernels()
+    {
+        std::vector<Kernel> kernels;
+
+        kernels.push_back({ "baseline/copy", 1, [](float, int)
+        {
+            return BlockFunction([](float*, int) {});
+        }});
+
+        const std::pair<const char*, FlarkLFO::Waveform> waveforms[] = {
+            { "sine", FlarkLFO::Sine }, { "square", FlarkLFO::Square },
+            { "triangle", FlarkLFO::Triangle }, { "sawtooth", FlarkLFO::Sawtooth }
+        };
+
+        for (auto& [name, waveform] : waveforms)
+        {
+            kernels.push_back({ juce::String("lfo/") + name, 1, [waveform = waveform](float sr, int)
+            {
+                auto lfo = std::make_shared<FlarkLFO>();
+                lfo->setSampleRate(sr);
+                lfo->setWaveform(waveform);
+                lfo->setRate(2.0f);
+                return BlockFunction([lfo](float* data, int n) { lfo->processBlock(data, n); });
+            }});
+        }
+
+        const std::pair<const char*, FlarkButterworthFilter::FilterType> filterTypes[] = {
+            { "lowpass", FlarkButterworthFilter::Lowpass }, { "highpass", FlarkButterworthFilter::Highpass },
+            { "bandpass", FlarkButterworthFilter::Bandpass }
+        };
+
+        for (auto& [name, type] : filterTypes)
+        {
+            kernels.push_back({ juce::String("butterworth/") + name, 1, [type = type](float sr, int)
+            {
+                auto filter = std::make_shared<FlarkButterworthFilter>();
+                filter->setSampleRate(sr);
+                filter->setType(type);
+                filter->setCutoff(1000.0f);
+                filter->setResonance(0.707f);
+                return BlockFunction([filter](float* data, int n) { filter->processBlock(data, n); });
+            }});
+
+            kernels.push_back({ juce::String("stereo_butterworth/") + name, 2, [type = type](float sr, int maxBlockSize)
+            {
+                auto filter = std::make_shared<FlarkMultichannelButterworthFilter>();
+                auto right = std::make_shared<std::vector<float>>(static_cast<size_t>(maxBlockSize));
+                filter->setSampleRate(sr);
+                filter->setParameters(type, 1000.0f, 0.707f);
+                return BlockFunction([filter, right](float* data, int n)
+                {
+                    std::copy(data, data + n, right->data());
+                    filter->processBlock(data, right->data(), n);
+                });
+            }});
+
+            kernels.push_back({ juce::String("stereo_svf/") + name, 2, [type = type](float sr, int maxBlockSize)
+            {
+                auto filter = std::make_shared<FlarkMultichannelSVF>();
+                auto right = std::make_shared<std::vector<float>>(static_cast<size_t>(maxBlockSize));
+                filter->setSampleRate(sr);
+                filter->setParameters(type, 1000.0f, 0.707f);
+                return BlockFunction([filter, right](float* data, int n)
+                {
+                    std::copy(data, data + n, right->data());
+                    filter->processBlock(data, right->data(), n);
+                });
+            }});
+        }
+
+        // Both stereo filters under the processor's LFO sweep: the biquad
+        // cascade redesigned every 32 samples, the SVF given a cutoff per sample
+        kernels.push_back({ "stereo_butterworth/lowpass_modulated", 2, [](float sr, int maxBlockSize)
+        {
+            auto filter = std::make_shared<FlarkMultichannelButterworthFilter>();
+            auto right = std::make_shared<std::vector<float>>(static_cast<size_t>(maxBlockSize));
+            auto lfo = std::make_shared<FlarkLFO>();
+            auto lfoValues = std::make_shared<std::vector<float>>(static_cast<size_t>(maxBlockSize));
+            filter->setSampleRate(sr);
+            filter->setParameters(FlarkButterworthFilter::Lowpass, 1000.0f, 3.0f);
+            lfo->setSampleRate(sr);
+            lfo->setRate(8.0f);
+            return BlockFunction([filter, right, lfo, lfoValues](float* data, int n)
+            {
+                std::copy(data, data + n, right->data());
+                lfo->processBlock(lfoValues->data(), n);
+                for (int i = 0; i < n; i += 32)
+                {
+                    const int period = juce::jmin(32, n - i);
+                    filter->setCutoffSmoothed(1000.0f * (1.0f + 0.9f * (*lfoValues)[static_cast<size_t>(i + period - 1)]), period);
+                    filter->processBlock(data + i, right->data() + i, period);
+                }
+            });
+        }});
+
+        kernels.push_back({ "stereo_svf/lowpass_modulated", 2, [](float sr, int maxBlockSize)
+        {
+            auto filter = std::make_shared<FlarkMultichannelSVF>();
+            auto right = std::make_shared<std::vector<float>>(static_cast<size_t>(maxBlockSize));
+            auto lfo = std::make_shared<FlarkLFO>();
+            auto cutoff = std::make_shared<std::vector<float>>(static_cast<size_t>(maxBlockSize));
+            filter->setSampleRate(sr);
+            filter->setParameters(FlarkButterworthFilter::Lowpass, 1000.0f, 3.0f);
+            lfo->setSampleRate(sr);
+            lfo->setRate(8.0f);
+            return BlockFunction([filter, right, lfo, cutoff](float* data, int n)
+            {
+                std::copy(data, data + n, right->data());
+                lfo->processBlock(cutoff->data(), n);
+                for (int i = 0; i < n; ++i)
+                    (*cutoff)[static_cast<size_t>(i)] = 1000.0f * (1.0f + 0.9f * (*cutoff)[static_cast<size_t>(i)]);
+                filter->processBlockModulated(data, right->data(), cutoff->data(), n);
+            });
+        }});
+
+        kernels.push_back({ "butterworth/lowpass_modulated", 1, [](float sr, int)
+        {
+            // Cutoff swept every 32 samples, as the LFO does in the processor
+            auto filter = std::make_shared<FlarkButterworthFilter>();
+            auto step = std::make_shared<int>(0);
+            filter->setSampleRate(sr);
+            filter->setCutoff(1000.0f);
+            return BlockFunction([filter, step](float* data, int n)
+            {
+                for (int i = 0; i < n; i += 32)
+                {
+                    const int period = juce::jmin(32, n - i);
+                    filter->setCutoffSmoothed(500.0f + 100.0f * static_cast<float>((*step)++ & 15), period);
+                    filter->processBlock(data + i, period);
+                }
+            });
+        }});
+
+        kernels.push_back({ "delay", 1, [](float sr, int)
+        {
+            auto delay = std::make_shared<FlarkDelay>();
+            delay->setSampleRate(sr);
+            delay->setDelayTime(0.375f);
+            delay->setFeedback(0.5f);
+            delay->setWetDryMix(0.5f);
+            return BlockFunction([delay](float* data, int n) { delay->processBlock(data, n); });
+        }});
+
+        kernels.push_back({ "reverb", 1, [](float sr, int)
+        {
+            auto reverb = std::make_shared<FlarkReverb>();
+            reverb->setSampleRate(sr);
+            reverb->setRoomSize(0.7f);
+            reverb->setDamping(0.5f);
+            reverb->setWetDryMix(0.3f);
+            return BlockFunction([reverb](float* data, int n) { reverb->processBlock(data, n); });
+        }});
+
+        kernels.push_back({ "flanger", 1, [](float sr, int)
+        {
+            auto flanger = std::make_shared<FlarkFlanger>();
+            flanger->setSampleRate(sr);
+            flanger->setRate(0.5f);
+            flanger->setDepth(0.7f);
+            flanger->setFeedback(0.5f);
+            flanger->setWetDryMix(0.5f);
+            return BlockFunction([flanger](float* data, int n) { flanger->processBlock(data, n); });
+        }});
+
+        // The processor's reverb, delay and flanger on every channel of a
+        // layout, four channels per pass. The first channel carries the
+        // noise and the others a copy of it.
+        const std::pair<const char*, int> layouts[] = { { "stereo", 2 }, { "surround_5.1", 6 }, { "surround_7.1", 8 } };
+
+        for (auto& [layout, numChannels] : layouts)
+        {
+            const juce::String prefix = numChannels == 2 ? juce::String("stereo_") : juce::String(layout) + "/";
+
+            const auto addMultichannel = [&kernels, prefix, numChannels = numChannels](const char* effectName, auto makeEffect)
+            {
+                kernels.push_back({ prefix + effectName, numChannels, [numChannels, makeEffect](float sr, int maxBlockSize)
+                {
+                    auto effect = makeEffect(sr, numChannels);
+                    auto others = std::make_shared<std::vector<std::vector<float>>>(
+                        static_cast<size_t>(numChannels), std::vector<float>(static_cast<size_t>(maxBlockSize)));
+                    return BlockFunction([effect, others, numChannels](float* data, int n)
+                    {
+                        float* channels[FlarkChannelGroup::maxChannels] = { data };
+                        for (int c = 1; c < numChannels; ++c)
+                        {
+                            channels[c] = (*others)[static_cast<size_t>(c)].data();
+                            std::copy(data, data + n, channels[c]);
+                        }
+                        effect->processBlock(channels, numChannels, n);
+                    });
+                }});
+            };
+
+            addMultichannel("reverb", [](float sr, int channels)
+            {
+                auto reverb = std::make_shared<FlarkReverb>();
+                reverb->setNumChannels(channels);
+                reverb->setSampleRate(sr);
+                reverb->setRoomSize(0.7f);
+                reverb->setDamping(0.5f);
+                reverb->setWetDryMix(0.3f);
+                return reverb;
+            });
+
+            addMultichannel("delay", [](float sr, int channels)
+            {
+                auto delay = std::make_shared<FlarkDelay>();
+                delay->setNumChannels(channels);
+                delay->setSampleRate(sr);
+                delay->setDelayTime(0.375f);
+                delay->setFeedback(0.5f);
+                delay->setWetDryMix(0.5f);
+                return delay;
+            });
+
+            addMultichannel("flanger", [](float sr, int channels)
+            {
+                auto flanger = std::make_shared<FlarkFlanger>();
+                flanger->setNumChannels(channels);
+                flanger->setSampleRate(sr);
+                flanger->setRate(0.5f);
+                flanger->setDepth(0.7f);
+                flanger->setFeedback(0.5f);
+                flanger->setWetDryMix(0.5f);
+                return flanger;
+            });
+        }
+
+        kernels.push_back({ "isolator", 1, [](float sr, int)
+        {
+            auto isolator = std::make_shared<FlarkIsolator>();
+            isolator->setSampleRate(sr);
+            isolator->setPosition(-0.5f);
+            isolator->setQ(2.0f);
+            return BlockFunction([isolator](float* data, int n) { isolator->processBlock(data, n); });
+        }});
+
+        kernels.push_back({ "stereo_isolator", 2, [](float sr, int maxBlockSize)
+        {
+            auto isolator = std::make_shared<FlarkMultichannelIsolator>();
+            auto right = std::make_shared<std::vector<float>>(static_cast<size_t>(maxBlockSize));
+            isolator->setSampleRate(sr);
+            isolator->setPosition(-0.5f);
+            isolator->setQ(2.0f);
+            return BlockFunction([isolator, right](float* data, int n)
+            {
+                std::copy(data, data + n, right->data());
+                isolator->processBlock(data, right->data(), n);
+            });
+        }});
+
+        // Unity gains skip the band filters, so that pair shows what the skip saves
+        for (const bool killed : { true, false })
+        {
+            kernels.push_back({ killed ? "three_band_isolator/kill" : "three_band_isolator/unity", 2,
+                                [killed](float sr, int maxBlockSize)
+            {
+                auto isolator = std::make_shared<FlarkThreeBandIsolator>();
+                auto right = std::make_shared<std::vector<float>>(static_cast<size_t>(maxBlockSize));
+                isolator->setSampleRate(sr);
+                if (killed)
+                    isolator->setGains(0.0f, 1.0f, 0.5f);
+                isolator->reset();
+                return BlockFunction([isolator, right](float* data, int n)
+                {
+                    std::copy(data, data + n, right->data());
+                    isolator->processBlock(data, right->data(), n);
+                });
+            }});
+        }
+
+        kernels.push_back({ "limiter/tanh", 1, [](float, int)
+        {
+            auto limiter = std::make_shared<FlarkSoftLimiter>();
+            return BlockFunction([limiter](float* data, int n) { limiter->processBlock(data, n); });
+        }});
+
+        for (const bool truePeak : { false, true })
+        {
+            kernels.push_back({ truePeak ? "limiter/truepeak" : "limiter/lookahead", 2, [truePeak](float sr, int maxBlockSize)
+            {
+                auto limiter = std::make_shared<FlarkLookaheadLimiter>();
+                auto right = std::make_shared<std::vector<float>>(static_cast<size_t>(maxBlockSize));
+                limiter->setSampleRate(sr);
+                limiter->setTruePeakEnabled(truePeak);
+                return BlockFunction([limiter, right](float* data, int n)
+                {
+                    std::copy(data, data + n, right->data());
+                    limiter->processBlock(data, right->data(), n);
+                });
+            }});
+        }
+
+        // FlarkFastMath, four lanes at a time, against libm on the same input.
+        // tanPi's argument is folded to [0, 0.4], the range a cutoff maps to.
+        struct MathFunction
+        {
+            const char* name;
+            FlarkFloat4 (*fast)(FlarkFloat4);
+            float (*reference)(float);
+        };
+
+        const MathFunction mathFunctions[] = {
+            { "sin2pi", FlarkFastMath::sin2pi, [](float x) { return std::sin(juce::MathConstants<float>::twoPi * x); } },
+            { "tanPi",  [](FlarkFloat4 x) { return FlarkFastMath::tanPi(x.abs() * FlarkFloat4::broadcast(0.8f)); },
+                        [](float x) { return std::tan(juce::MathConstants<float>::pi * std::abs(x) * 0.8f); } },
+            { "tanh",   FlarkFastMath::tanh, [](float x) { return std::tanh(x); } },
+            { "pow10",  FlarkFastMath::pow10, [](float x) { return std::pow(10.0f, x); } }
+        };
+
+        for (const auto& function : mathFunctions)
+        {
+            kernels.push_back({ juce::String("math/") + function.name, 1, [fast = function.fast](float, int)
+            {
+                return BlockFunction([fast](float* data, int n)
+                {
+                    int i = 0;
+                    for (; i + 4 <= n; i += 4)
+                        fast(FlarkFloat4::load(data + i)).store(data + i);
+                    for (; i < n; ++i)
+                        data[i] = fast(FlarkFloat4::broadcast(data[i])).get0();
+                });
+            }});
+
+            kernels.push_back({ juce::String("math/") + function.name + "_libm", 1, [reference = function.reference](float, int)
+            {
+                return BlockFunction([reference](float* data, int n)
+                {
+                    for (int i = 0; i < n; ++i)
+                        data[i] = reference(data[i]);
+                });
+            }});
+        }
+
+        // Peak, RMS, true peak and loudness, published once per block
+        kernels.push_back({ "meter/stereo", 2, [](float sr, int)
+        {
+            auto meter = std::make_shared<FlarkDJMeter>();
+            meter->prepare(sr, 2);
+            return BlockFunction([meter](float* data, int n)
+            {
+                const float* channels[] = { data, data };
+                for (int i = 0; i < n; ++i)
+                    meter->process(channels, i);
+                meter->publish();
+            });
+        }});
+
+        return kernels;
+    }
+
+    struct Measurement
+    {
+        double medianNsPerSample;
+        double minNsPerSample;
+    };
+
+    volatile float sink = 0.0f;
+
+    Measurement measure(const Kernel& kernel, float sampleRate, int blockSize, int samplesPerTrial, int numTrials)
+    {
+        auto process = kernel.create(sampleRate, blockSize);
+
+        // Noise at -6 dBFS, long enough that consecutive blocks differ
+        std::vector<float> noise(static_cast<size_t>(juce::jmax(8192, blockSize * 4)));
+        juce::Random random(1);
+        for (auto& s : noise)
+            s = (random.nextFloat() * 2.0f - 1.0f) * 0.5f;
+
+        std::vector<float> block(static_cast<size_t>(blockSize));
+        const int numBlocks = juce::jmax(1, samplesPerTrial / blockSize);
+        size_t readPos = 0;
+
+        auto runTrial = [&]
+        {
+            const auto start = std::chrono::steady_clock::now();
+
+            for (int b = 0; b < numBlocks; ++b)
+            {
+                if (readPos + block.size() > noise.size())
+                    readPos = 0;
+
+                std::copy_n(noise.data() + readPos, block.size(), block.data());
+                readPos += block.size();
+
+                process(block.data(), blockSize);
+                sink = sink + block[0];
+            }
+
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+            return elapsed.count() / (static_cast<double>(numBlocks) * blockSize);
+        };
+
+        runTrial(); // warm up caches, branch predictors and clocks
+
+        std::vector<double> trials;
+        for (int t = 0; t < numTrials; ++t)
+            trials.push_back(runTrial());
+
+        std::sort(trials.begin(), trials.end());
+        return { trials[trials.size() / 2], trials.front() };
+    }
+
+    const char* getSimdName()
+    {
+       #if FLARKDJ_SIMD_AVX
+        return "avx";
+       #elif FLARKDJ_SIMD_SSE
+        return "sse";
+       #elif FLARKDJ_SIMD_NEON
+        return "neon";
+       #else
+        return "scalar";
+       #endif
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        std::cout << "Usage: FlarkDJBench [--output <file.json>] [--filter <kernel substring>] [--quick]\n";
+        return 0;
+    }
+
+    const bool quick = args.containsOption("--quick");
+    const auto filter = args.getValueForOption("--filter");
+
+    const int samplesPerTrial = quick ? (1 << 15) : (1 << 18);
+    const int numTrials = quick ? 3 : 7;
+    const float sampleRates[] = { 44100.0f, 48000.0f, 96000.0f, 192000.0f };
+    const int blockSizes[] = { 16, 64, 256, 1024, 4096 };
+
+    juce::Array<juce::var> results;
+
+    for (auto& kernel : makeKernels())
+    {
+        if (filter.isNotEmpty() && ! kernel.name.contains(filter))
+            continue;
+
+        for (auto sampleRate : sampleRates)
+        {
+            for (auto blockSize : blockSizes)
+            {
+                const auto m = measure(kernel, sampleRate, blockSize, samplesPerTrial, numTrials);
+
+                auto* result = new juce::DynamicObject();
+                result->setProperty("kernel", kernel.name);
+                result->setProperty("channels", kernel.numChannels);
+                result->setProperty("sampleRate", sampleRate);
+                result->setProperty("blockSize", blockSize);
+                result->setProperty("nsPerSample", m.medianNsPerSample);
+                result->setProperty("nsPerSampleMin", m.minNsPerSample);
+
+                // Share of one core used by a realtime stream at this rate
+                result->setProperty("cpuPercent", m.medianNsPerSample * sampleRate * 1.0e-7);
+
+                results.add(juce::var(result));
+
+                std::cerr << kernel.name << " @ " << sampleRate << " Hz, " << blockSize << ": "
+                          << juce::String(m.medianNsPerSample, 2) << " ns/sample" << std::endl;
+            }
+        }
+    }
+
+    auto* build = new juce::DynamicObject();
+    build->setProperty("simd", getSimdName());
+   #if JUCE_DEBUG
+    build->setProperty("config", "debug");
+   #else
+    build->setProperty("config", "release");
+   #endif
+    build->setProperty("juce", juce::SystemStats::getJUCEVersion());
+
+    auto* machine = new juce::DynamicObject();
+    machine->setProperty("cpu", juce::SystemStats::getCpuModel());
+    machine->setProperty("cores", juce::SystemStats::getNumCpus());
+    machine->setProperty("os", juce::SystemStats::getOperatingSystemName());
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("benchmark", "FlarkDJBench");
+    report->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+    report->setProperty("build", juce::var(build));
+    report->setProperty("machine", juce::var(machine));
+    report->setProperty("samplesPerTrial", samplesPerTrial);
+    report->setProperty("trials", numTrials);
+    report->setProperty("results", results);
+
+    const auto json = juce::JSON::toString(juce::var(report));
+
+    if (args.containsOption("--output"))
+    {
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+
+        if (! file.replaceWithText(json))
+        {
+            std::cerr << "Cannot write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << json << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,443 @@
+#include "FlarkDJCapture.h"
+
+#if JUCE_WINDOWS
+ #include <process.h>
+#else
+ #include <unistd.h>
+#endif
+
+using namespace FlarkDJCaptureFormat;
+
+namespace
+{
+    template <typename T>
+    void append(std::vector<char>& bytes, T value)
+    {
+        const auto* p = reinterpret_cast<const char*>(&value);
+        bytes.insert(bytes.end(), p, p + sizeof(T));
+    }
+
+    template <typename T>
+    bool readValue(juce::InputStream& input, T& value)
+    {
+        return input.read(&value, static_cast<int>(sizeof(T))) == static_cast<int>(sizeof(T));
+    }
+
+    int getProcessId()
+    {
+       #if JUCE_WINDOWS
+        return _getpid();
+       #else
+        return static_cast<int>(::getpid());
+       #endif
+    }
+}
+
+//==============================================================================
+FlarkDJCaptureRecorder::FlarkDJCaptureRecorder(juce::AudioProcessorValueTreeState& parameters)
+    : juce::Thread("FlarkDJ capture writer")
+{
+    for (auto* parameter : parameters.processor.getParameters())
+    {
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+        {
+            jassert(parameterIDs.size() < maxParameters);
+
+            if (parameterIDs.size() < maxParameters)
+            {
+                parameterIDs.add(ranged->paramID);
+                parameterValues.push_back(parameters.getRawParameterValue(ranged->paramID));
+            }
+        }
+    }
+
+    lastValues.resize(parameterValues.size());
+}
+
+FlarkDJCaptureRecorder::~FlarkDJCaptureRecorder()
+{
+    stop();
+}
+
+juce::File FlarkDJCaptureRecorder::getInstanceFile(const juce::File& file, int instance)
+{
+    return file.getSiblingFile(file.getFileNameWithoutExtension() + "." + juce::String(getProcessId())
+                               + "-" + juce::String(instance) + file.getFileExtension());
+}
+
+bool FlarkDJCaptureRecorder::start(const juce::File& file, bool startedMidSession, int bufferBytes)
+{
+    stop();
+
+    file.deleteFile();
+    auto stream = std::make_unique<juce::FileOutputStream>(file, 1 << 16);
+
+    if (stream->failedToOpen())
+        return false;
+
+    std::vector<char> header;
+    append(header, magic);
+    append(header, version);
+    append(header, startedMidSession ? static_cast<int>(StartedMidSession) : 0);
+    append(header, static_cast<int>(parameterIDs.size()));
+
+    for (auto& id : parameterIDs)
+    {
+        const auto utf8 = id.toStdString();
+        append(header, static_cast<juce::uint16>(utf8.size()));
+        header.insert(header.end(), utf8.begin(), utf8.end());
+    }
+
+    stream->write(header.data(), header.size());
+
+    buffer.allocate(static_cast<size_t>(bufferBytes), false);
+    fifo = std::make_unique<juce::AbstractFifo>(bufferBytes);
+    pendingControl.clear();
+    needsFullParameters = true;
+    truncated.store(false);
+    output = std::move(stream);
+
+    recording.store(true);
+    startThread(juce::Thread::Priority::low);
+    return true;
+}
+
+void FlarkDJCaptureRecorder::stop()
+{
+    recording.store(false);
+
+    if (output == nullptr)
+        return;
+
+    // Let a block that is being recorded finish
+    while (audioBusy.load())
+        juce::Thread::yield();
+
+    stopThread(2000);
+    drain();
+
+    {
+        const juce::SpinLock::ScopedLockType lock(controlLock);
+        output->write(pendingControl.data(), pendingControl.size());
+        pendingControl.clear();
+    }
+
+    std::vector<char> end;
+    append(end, static_cast<juce::uint8>(End));
+    append(end, truncated.load() ? static_cast<int>(Truncated) : 0);
+    output->write(end.data(), end.size());
+
+    if (truncated.load())
+        DBG("FlarkDJ: capture truncated, the writer could not keep up");
+
+    output.reset();
+}
+
+//==============================================================================
+void FlarkDJCaptureRecorder::recordPrepare(double sampleRate, int blockSize, int controlRateInterval)
+{
+    std::vector<char> event;
+    append(event, static_cast<juce::uint8>(Prepare));
+    append(event, sampleRate);
+    append(event, blockSize);
+    append(event, controlRateInterval);
+    queueControlEvent(event);
+}
+
+void FlarkDJCaptureRecorder::recordReset()
+{
+    queueControlEvent({ static_cast<char>(Reset) });
+}
+
+void FlarkDJCaptureRecorder::recordControlRate(int controlRateInterval)
+{
+    std::vector<char> event;
+    append(event, static_cast<juce::uint8>(ControlRate));
+    append(event, controlRateInterval);
+    queueControlEvent(event);
+}
+
+void FlarkDJCaptureRecorder::recordStateRestore(const void* data, int sizeInBytes)
+{
+    std::vector<char> event;
+    append(event, static_cast<juce::uint8>(StateRestore));
+    append(event, sizeInBytes);
+    event.insert(event.end(), static_cast<const char*>(data), static_cast<const char*>(data) + sizeInBytes);
+    queueControlEvent(event);
+}
+
+void FlarkDJCaptureRecorder::queueControlEvent(const std::vector<char>& event)
+{
+    if (! recording.load())
+        return;
+
+    // May allocate, but never on the audio thread, which only try-locks
+    const juce::SpinLock::ScopedLockType lock(controlLock);
+    pendingControl.insert(pendingControl.end(), event.begin(), event.end());
+}
+
+//==============================================================================
+void FlarkDJCaptureRecorder::recordBlockInput(const juce::AudioBuffer<float>& block, juce::AudioPlayHead* playHead)
+{
+    if (! beginAudioWrite())
+        return;
+
+    flushControlEvents();
+
+    bool hasBpm = false;
+    double bpm = 0.0;
+
+    if (playHead != nullptr)
+    {
+        if (auto position = playHead->getPosition())
+        {
+            if (auto hostBpm = position->getBpm())
+            {
+                hasBpm = true;
+                bpm = *hostBpm;
+            }
+        }
+    }
+
+    // Fixed fields and the parameters that changed, staged on the stack
+    char header[1 + 4 + 4 + 1 + 8 + 8 + 4 * maxParameters];
+    int size = 0;
+    auto put = [&header, &size](const auto& value)
+    {
+        std::memcpy(header + size, &value, sizeof(value));
+        size += static_cast<int>(sizeof(value));
+    };
+
+    const int numSamples = block.getNumSamples();
+    const int numChannels = block.getNumChannels();
+
+    put(static_cast<juce::uint8>(Block));
+    put(numSamples);
+    put(numChannels);
+    put(static_cast<juce::uint8>(hasBpm ? 1 : 0));
+    put(bpm);
+
+    const int maskOffset = size;
+    juce::uint64 changedMask = 0;
+    put(changedMask);
+
+    float values[maxParameters];
+
+    for (size_t i = 0; i < parameterValues.size(); ++i)
+    {
+        values[i] = parameterValues[i]->load();
+
+        if (needsFullParameters || std::memcmp(&values[i], &lastValues[i], sizeof(float)) != 0)
+        {
+            changedMask |= juce::uint64 { 1 } << i;
+            put(values[i]);
+        }
+    }
+
+    std::memcpy(header + maskOffset, &changedMask, sizeof(changedMask));
+
+    const int audioBytes = numChannels * numSamples * static_cast<int>(sizeof(float));
+
+    if (recording.load() && writeEvent(header, size, audioBytes))
+    {
+        for (int ch = 0; ch < numChannels; ++ch)
+            writeBytes(block.getReadPointer(ch), numSamples * static_cast<int>(sizeof(float)));
+
+        std::copy(values, values + parameterValues.size(), lastValues.begin());
+
+        needsFullParameters = false;
+    }
+
+    endAudioWrite();
+}
+
+void FlarkDJCaptureRecorder::recordBlockOutput(const juce::AudioBuffer<float>& block)
+{
+    if (! beginAudioWrite())
+        return;
+
+    char event[1 + 8];
+    event[0] = static_cast<char>(Output);
+    const auto hash = checksum(block);
+    std::memcpy(event + 1, &hash, sizeof(hash));
+    writeEvent(event, static_cast<int>(sizeof(event)));
+
+    endAudioWrite();
+}
+
+bool FlarkDJCaptureRecorder::beginAudioWrite()
+{
+    // Pairs with stop(): either stop() sees us busy and waits, or we see it stopped
+    audioBusy.store(true);
+
+    if (recording.load())
+        return true;
+
+    audioBusy.store(false);
+    return false;
+}
+
+void FlarkDJCaptureRecorder::flushControlEvents()
+{
+    const juce::SpinLock::ScopedTryLockType lock(controlLock);
+
+    // If the host thread holds the lock, the events go out with the next block
+    if (! lock.isLocked() || pendingControl.empty())
+        return;
+
+    if (writeEvent(pendingControl.data(), static_cast<int>(pendingControl.size())))
+        pendingControl.clear(); // keeps its capacity, so no deallocation here
+}
+
+bool FlarkDJCaptureRecorder::writeEvent(const void* data, int size, int extraBytes)
+{
+    // The whole event must fit, or the capture ends at the previous one
+    if (fifo->getFreeSpace() < size + extraBytes)
+    {
+        truncated.store(true);
+        recording.store(false);
+        return false;
+    }
+
+    writeBytes(data, size);
+    return true;
+}
+
+void FlarkDJCaptureRecorder::writeBytes(const void* data, int size)
+{
+    const auto scope = fifo->write(size);
+    const auto* bytes = static_cast<const char*>(data);
+
+    std::memcpy(buffer + scope.startIndex1, bytes, static_cast<size_t>(scope.blockSize1));
+    if (scope.blockSize2 > 0)
+        std::memcpy(buffer + scope.startIndex2, bytes + scope.blockSize1, static_cast<size_t>(scope.blockSize2));
+}
+
+//==============================================================================
+void FlarkDJCaptureRecorder::run()
+{
+    while (! threadShouldExit())
+    {
+        drain();
+        wait(10);
+    }
+}
+
+void FlarkDJCaptureRecorder::drain()
+{
+    const int numReady = fifo->getNumReady();
+    if (numReady == 0)
+        return;
+
+    const auto scope = fifo->read(numReady);
+    output->write(buffer + scope.startIndex1, static_cast<size_t>(scope.blockSize1));
+    if (scope.blockSize2 > 0)
+        output->write(buffer + scope.startIndex2, static_cast<size_t>(scope.blockSize2));
+
+    // A capture from a crashed session is still readable up to here
+    output->flush();
+}
+
+//==============================================================================
+juce::String FlarkDJCaptureReader::open(const juce::File& file)
+{
+    auto stream = std::make_unique<juce::FileInputStream>(file);
+    if (! stream->openedOk())
+        return "cannot open " + file.getFullPathName();
+
+    input = std::make_unique<juce::BufferedInputStream>(stream.release(), 1 << 16, true);
+
+    juce::uint32 fileMagic = 0;
+    int fileVersion = 0, numParameters = 0;
+
+    if (! readValue(*input, fileMagic) || fileMagic != magic)
+        return "not a FlarkDJ capture (or written on a machine with a different byte order)";
+
+    if (! readValue(*input, fileVersion) || fileVersion != version)
+        return "unsupported capture version " + juce::String(fileVersion);
+
+    if (! readValue(*input, headerFlags) || ! readValue(*input, numParameters)
+        || ! juce::isPositiveAndNotGreaterThan(numParameters, maxParameters))
+        return "corrupt capture header";
+
+    parameterIDs.clear();
+    for (int i = 0; i < numParameters; ++i)
+    {
+        juce::uint16 length = 0;
+        juce::MemoryBlock utf8;
+
+        if (! readValue(*input, length) || input->readIntoMemoryBlock(utf8, length) != length)
+            return "corrupt capture header";
+
+        parameterIDs.add(utf8.toString());
+    }
+
+    parameterValues.assign(static_cast<size_t>(numParameters), 0.0f);
+    return {};
+}
+
+bool FlarkDJCaptureReader::readNext(Event& event)
+{
+    juce::uint8 type = 0;
+    if (input == nullptr || ! readValue(*input, type))
+        return false;
+
+    event.type = static_cast<EventType>(type);
+
+    switch (type)
+    {
+        case Prepare:
+            return readValue(*input, event.sampleRate) && readValue(*input, event.blockSize)
+                && readValue(*input, event.controlRateInterval);
+
+        case Reset:
+            return true;
+
+        case ControlRate:
+            return readValue(*input, event.controlRateInterval);
+
+        case StateRestore:
+        {
+            int size = 0;
+            return readValue(*input, size) && size >= 0
+                && input->readIntoMemoryBlock(event.state, size) == static_cast<size_t>(size)
+                && static_cast<int>(event.state.getSize()) == size;
+        }
+
+        case Block:
+        {
+            int numSamples = 0, numChannels = 0;
+            juce::uint8 hasBpm = 0;
+
+            if (! readValue(*input, numSamples) || ! readValue(*input, numChannels) || ! readValue(*input, hasBpm)
+                || ! readValue(*input, event.bpm) || ! readValue(*input, event.changedMask)
+                || ! juce::isPositiveAndBelow(numSamples, 1 << 24) || ! juce::isPositiveAndBelow(numChannels, 64))
+                return false;
+
+            event.hasBpm = hasBpm != 0;
+
+            for (size_t i = 0; i < parameterValues.size(); ++i)
+                if ((event.changedMask & (juce::uint64 { 1 } << i)) != 0)
+                    if (! readValue(*input, parameterValues[i]))
+                        return false;
+
+            event.audio.setSize(numChannels, numSamples, false, false, true);
+            const int channelBytes = numSamples * static_cast<int>(sizeof(float));
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                if (input->read(event.audio.getWritePointer(ch), channelBytes) != channelBytes)
+                    return false;
+
+            return true;
+        }
+
+        case Output:
+            return readValue(*input, event.checksum);
+
+        case End:
+            return readValue(*input, event.endFlags);
+
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <atomic>
+#include <vector>
+
+/**
+ * FlarkDJ Session Capture
+ *
+ * Records what the host fed the processor - input blocks, block sizes,
+ * playhead BPM, every parameter value per block and prepare/reset/state
+ * restore events - to a compact binary file, so a glitch seen in a session
+ * can be replayed offline (FlarkDJReplay) under a profiler.
+ *
+ * The audio thread only copies into a preallocated FIFO; a background thread
+ * writes it to disk. If the writer falls behind and the FIFO fills, the
+ * capture stops at the last complete block and is marked truncated.
+ *
+ * Each block also stores a checksum of the processor's output, so a replay
+ * can prove it reproduced the session bit for bit. That holds for captures
+ * started before playback (FLARKDJ_CAPTURE_FILE at construction); one started
+ * mid-session begins with whatever the effects were still holding.
+ *
+ * File layout (native byte order): a header with the parameter IDs, then a
+ * stream of events, each one type byte followed by its fields.
+ */
+namespace FlarkDJCaptureFormat
+{
+    constexpr juce::uint32 magic = 0x434a4446; // "FDJC"
+    constexpr int version = 1;
+    constexpr int maxParameters = 64;          // changed-parameter mask is 64 bits
+
+    enum EventType : juce::uint8
+    {
+        Prepare      = 'P', // double sampleRate, int32 blockSize, int32 controlRateInterval
+        Reset        = 'R',
+        ControlRate  = 'C', // int32 controlRateInterval
+        StateRestore = 'S', // int32 size, state bytes
+        Block        = 'B', // int32 numSamples, int32 numChannels, uint8 hasBpm, double bpm,
+                            // uint64 changedMask, float per changed parameter, float audio[channel][sample]
+        Output       = 'O', // uint64 checksum of the processed block
+        End          = 'E'  // int32 endFlags
+    };
+
+    enum HeaderFlags { StartedMidSession = 1 };
+    enum EndFlags    { Truncated = 1 };
+
+    // FNV-1a over the bit patterns of every sample
+    inline juce::uint64 checksum(const juce::AudioBuffer<float>& buffer)
+    {
+        juce::uint64 hash = 0xcbf29ce484222325ull;
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            const auto* data = buffer.getReadPointer(ch);
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                juce::uint32 bits;
+                std::memcpy(&bits, data + i, sizeof(bits));
+                hash = (hash ^ bits) * 0x100000001b3ull;
+            }
+        }
+
+        return hash;
+    }
+}
+
+//==============================================================================
+// Recorder, owned by the processor
+//==============================================================================
+class FlarkDJCaptureRecorder : private juce::Thread
+{
+public:
+    static constexpr int defaultBufferBytes = 16 << 20; // ~40 s of stereo 48 kHz
+
+    explicit FlarkDJCaptureRecorder(juce::AudioProcessorValueTreeState& parameters);
+    ~FlarkDJCaptureRecorder() override;
+
+    // Message thread. Returns false if the file cannot be written.
+    bool start(const juce::File& file, bool startedMidSession, int bufferBytes = defaultBufferBytes);
+    void stop();
+
+    bool isRecording() const { return recording.load(); }
+
+    // Where a processor records for FLARKDJ_CAPTURE_FILE. Every instance in
+    // every process sees the same path, so each writes its own file beside
+    // it: <name>.<pid>-<instance><extension>.
+    static juce::File getInstanceFile(const juce::File& file, int instance);
+
+    //==============================================================================
+    // Host events, from whichever thread the host calls them on. They are
+    // queued and land in the capture before the next block.
+    void recordPrepare(double sampleRate, int blockSize, int controlRateInterval);
+    void recordReset();
+    void recordControlRate(int controlRateInterval);
+    void recordStateRestore(const void* data, int sizeInBytes);
+
+    //==============================================================================
+    // Audio thread: the block as the processor receives it, then as it leaves
+    void recordBlockInput(const juce::AudioBuffer<float>& buffer, juce::AudioPlayHead* playHead);
+    void recordBlockOutput(const juce::AudioBuffer<float>& buffer);
+
+private:
+    void run() override;
+    void drain();
+    void queueControlEvent(const std::vector<char>& event);
+    void flushControlEvents();
+    bool writeEvent(const void* data, int size, int extraBytes = 0);
+    void writeBytes(const void* data, int size);
+    bool beginAudioWrite();
+    void endAudioWrite() { audioBusy.store(false); }
+
+    // Parameters in AudioProcessor::getParameters() order
+    juce::StringArray parameterIDs;
+    std::vector<std::atomic<float>*> parameterValues;
+    std::vector<float> lastValues;
+    bool needsFullParameters = true;
+
+    // Written by the audio thread, drained by the writer thread
+    juce::HeapBlock<char> buffer;
+    std::unique_ptr<juce::AbstractFifo> fifo;
+
+    // Host events waiting for the next block
+    juce::SpinLock controlLock;
+    std::vector<char> pendingControl;
+
+    std::unique_ptr<juce::OutputStream> output;
+    std::atomic<bool> recording { false }, audioBusy { false }, truncated { false };
+
+    JUCE_DECLARE_NON_COPYABLE(FlarkDJCaptureRecorder)
+};
+
+//==============================================================================
+// Reader, used by the replay tool
+//==============================================================================
+class FlarkDJCaptureReader
+{
+public:
+    struct Event
+    {
+        FlarkDJCaptureFormat::EventType type = FlarkDJCaptureFormat::End;
+
+        double sampleRate = 0.0;          // Prepare
+        int blockSize = 0;
+        int controlRateInterval = 0;      // Prepare, ControlRate
+
+        juce::MemoryBlock state;          // StateRestore
+
+        juce::AudioBuffer<float> audio;   // Block
+        bool hasBpm = false;
+        double bpm = 0.0;
+        juce::uint64 changedMask = 0;     // bit i: parameter i changed; values are in getParameterValues()
+
+        juce::uint64 checksum = 0;        // Output
+        int endFlags = 0;                 // End
+    };
+
+    // Returns an error message, or an empty string on success
+    juce::String open(const juce::File& file);
+
+    const juce::StringArray& getParameterIDs() const { return parameterIDs; }
+    const std::vector<float>& getParameterValues() const { return parameterValues; }
+    bool wasStartedMidSession() const { return (headerFlags & FlarkDJCaptureFormat::StartedMidSession) != 0; }
+
+    // False at the end of the file. A capture cut short without an End event
+    // (e.g. the host crashed) reads as far as its last whole event.
+    bool readNext(Event& event);
+
+private:
+    std::unique_ptr<juce::InputStream> input;
+    juce::StringArray parameterIDs;
+    std::vector<float> parameterValues;
+    int headerFlags = 0;
+};
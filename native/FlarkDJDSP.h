@@ -3,6 +3,9 @@
 #include <juce_core/juce_core.h>
 #include <vector>
 #include <cmath>
+#include <algorithm>
+#include "FlarkDJSIMD.h"
+#include "FlarkDJFastMath.h"
 
 /**
  * FlarkDJ DSP Effects
@@ -10,8 +13,82 @@
  * Native C++ implementations of the audio effects from the TypeScript version.
  */
 
+//==============================================================================
+// Channel Groups
+// Multichannel effects keep their state as structure-of-arrays across
+// channels: lane c of group g is channel 4g + c, so each FlarkFloat4
+// instruction advances four channels and a layout costs one pass per group
+// (one for mono to quad, two for 5.1 and 7.1). Channels are passed as an array
+// of pointers, as in juce::AudioBuffer.
+//
+// Lanes past the last channel carry a copy of the group's first channel. They
+// are computed but never written back, and the peak across all lanes is still
+// the peak of the real channels.
+//==============================================================================
+class FlarkChannelGroup
+{
+public:
+    static constexpr int width = 4;
+    static constexpr int maxChannels = 8;   // 7.1
+    static constexpr int maxGroups = maxChannels / width;
+
+    static int getNumGroups(int numChannels) { return (numChannels + width - 1) / width; }
+
+    // Fills groups (at least maxGroups of them) and returns how many were used
+    static int split(float* const* channels, int numChannels, FlarkChannelGroup* groups)
+    {
+        const int numGroups = getNumGroups(numChannels);
+        for (int g = 0; g < numGroups; ++g)
+            groups[g] = FlarkChannelGroup(channels, numChannels, g);
+        return numGroups;
+    }
+
+    // The same channels starting `offset` samples in
+    static void offset(float* const* channels, int numChannels, int offset, float** result)
+    {
+        for (int c = 0; c < numChannels; ++c)
+            result[c] = channels[c] + offset;
+    }
+
+    FlarkChannelGroup() = default;
+
+    FlarkChannelGroup(float* const* channels, int numChannels, int group)
+    {
+        const int first = group * width;
+        numLanes = juce::jlimit(0, width, numChannels - first);
+
+        for (int c = 0; c < width; ++c)
+            lanes[c] = channels[first + (c < numLanes ? c : 0)];
+    }
+
+    int getNumLanes() const { return numLanes; }
+    float* getChannel(int lane) const { return lanes[lane]; }
+
+    FlarkFloat4 load(int i) const
+    {
+        return FlarkFloat4::set(lanes[0][i], lanes[1][i], lanes[2][i], lanes[3][i]);
+    }
+
+    void store(FlarkFloat4 frame, int i) const
+    {
+        float values[width];
+        frame.store(values);
+
+        for (int c = 0; c < numLanes; ++c)
+            lanes[c][i] = values[c];
+    }
+
+private:
+    float* lanes[width] {};
+    int numLanes = 0;
+};
+
 //==============================================================================
 // LFO (Low Frequency Oscillator)
+// A phasor that generates a block at a time: the phase ramp is accumulated
+// first, then shaped with one loop per waveform (the sine four lanes at a
+// time). The phase increment is only recomputed when the rate, tempo, sync
+// division or sample rate changes.
 //==============================================================================
 class FlarkLFO
 {
@@ -24,11 +101,12 @@ public:
         Sawtooth = 3
     };
 
-    FlarkLFO() : phase(0.0f), sampleRate(44100.0f) {}
+    FlarkLFO() : phase(0.0f), sampleRate(44100.0f) { updateIncrement(); }
 
     void setSampleRate(float sr)
     {
         sampleRate = sr;
+        updateIncrement();
     }
 
     void setWaveform(Waveform wf)
@@ -38,45 +116,95 @@ public:
 
     void setRate(float rateHz)
     {
+        if (rate == rateHz)
+            return;
+
         rate = rateHz;
+        updateIncrement();
     }
 
     void setBPM(double bpm)
     {
+        if (currentBPM == bpm)
+            return;
+
         currentBPM = bpm;
+        updateIncrement();
     }
 
     void setSyncEnabled(bool enabled)
     {
+        if (syncEnabled == enabled)
+            return;
+
         syncEnabled = enabled;
+        updateIncrement();
     }
 
     // Sync rate divisions: 0=1/4, 1=1/8, 2=1/16, 3=1/32, 4=1/2, 5=1bar
     void setSyncRate(int division)
     {
+        if (syncDivision == division)
+            return;
+
         syncDivision = division;
+        updateIncrement();
     }
 
+    // Steps the phase before taking each value instead of after, so the
+    // first value is one increment in (the flanger's sweep has always started
+    // there)
+    void setAdvanceBeforeSampling(bool shouldAdvanceFirst)
+    {
+        advanceFirst = shouldAdvanceFirst;
+    }
+
+    // One value; prefer processBlock
     float process()
     {
-        float output = 0.0f;
+        if (advanceFirst)
+            advance();
 
-        switch (waveform)
+        float output = phase;
+
+        if (! advanceFirst)
+            advance();
+
+        shape(&output, 1);
+        return output;
+    }
+
+    void reset()
+    {
+        phase = 0.0f;
+    }
+
+    // Fills a buffer with consecutive LFO values
+    void processBlock(float* output, int numSamples)
+    {
+        if (advanceFirst)
         {
-            case Sine:
-                output = std::sin(phase * juce::MathConstants<float>::twoPi);
-                break;
-            case Square:
-                output = phase < 0.5f ? 1.0f : -1.0f;
-                break;
-            case Triangle:
-                output = 2.0f * std::abs(2.0f * (phase - std::floor(phase + 0.5f))) - 1.0f;
-                break;
-            case Sawtooth:
-                output = 2.0f * phase - 1.0f;
-                break;
+            for (int i = 0; i < numSamples; ++i)
+            {
+                advance();
+                output[i] = phase;
+            }
         }
+        else
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                output[i] = phase;
+                advance();
+            }
+        }
+
+        shape(output, numSamples);
+    }
 
+private:
+    void updateIncrement()
+    {
         // Calculate actual rate (Hz)
         float actualRate = rate;
         if (syncEnabled && currentBPM > 0.0)
@@ -94,22 +222,231 @@ public:
             }
         }
 
-        // Advance phase
-        phase += actualRate / sampleRate;
+        phaseIncrement = actualRate / sampleRate;
+    }
+
+    void advance()
+    {
+        phase += phaseIncrement;
         if (phase >= 1.0f)
             phase -= 1.0f;
+    }
 
-        return output;
+    // Turns phases in [0, 1) into waveform values in place
+    void shape(float* data, int numSamples) const
+    {
+        switch (waveform)
+        {
+            case Sine:
+            {
+                int i = 0;
+                for (; i + 4 <= numSamples; i += 4)
+                    FlarkFastMath::sin2pi(FlarkFloat4::load(data + i)).store(data + i);
+                for (; i < numSamples; ++i)
+                    data[i] = FlarkFastMath::sin2pi(data[i]);
+                break;
+            }
+            case Square:
+                for (int i = 0; i < numSamples; ++i)
+                    data[i] = data[i] < 0.5f ? 1.0f : -1.0f;
+                break;
+            case Triangle:
+                for (int i = 0; i < numSamples; ++i)
+                    data[i] = 2.0f * std::abs(2.0f * (data[i] - std::floor(data[i] + 0.5f))) - 1.0f;
+                break;
+            case Sawtooth:
+                for (int i = 0; i < numSamples; ++i)
+                    data[i] = 2.0f * data[i] - 1.0f;
+                break;
+        }
     }
 
-private:
     float phase;
+    float phaseIncrement = 0.0f;
     float rate = 1.0f;
     float sampleRate;
     Waveform waveform = Sine;
     double currentBPM = 120.0;
     bool syncEnabled = false;
     int syncDivision = 0; // 0=1/4, 1=1/8, 2=1/16, 3=1/32, 4=1/2, 5=1bar
+    bool advanceFirst = false;
+};
+
+//==============================================================================
+// Tail Tracker
+// Decides when a decaying effect (reverb, delay, flanger) can stop running.
+// An effect stays active until its input has been silent for at least its tail
+// length and its last output block is below the silence threshold. A disabled
+// effect is fed silence, so it rings out the same way and then goes idle.
+//==============================================================================
+class FlarkTailTracker
+{
+public:
+    static constexpr float silenceThreshold = 1.0e-5f; // -100 dB
+
+    // Longest time the effect's output can stay audible after its input stops
+    void setTailLength(int numSamples)
+    {
+        tailLength = juce::jmax(0, numSamples);
+    }
+
+    // Call before processing a block. Returns false if the effect can be skipped.
+    bool beginBlock(bool enabled, float inputPeak, int numSamples)
+    {
+        if (enabled && inputPeak >= silenceThreshold)
+        {
+            silentSamples = 0;
+            active = true;
+            return true;
+        }
+
+        if (! active)
+            return false;
+
+        silentSamples += numSamples;
+        return true;
+    }
+
+    // Call after processing a block with the peak of what the effect produced
+    void endBlock(float outputPeak)
+    {
+        if (silentSamples >= tailLength && outputPeak < silenceThreshold)
+            active = false;
+    }
+
+    bool isActive() const { return active; }
+
+    void reset()
+    {
+        active = false;
+        silentSamples = 0;
+    }
+
+    static float getPeak(const float* data, int numSamples)
+    {
+        float peak = 0.0f;
+        for (int i = 0; i < numSamples; ++i)
+            peak = juce::jmax(peak, std::abs(data[i]));
+        return peak;
+    }
+
+    static float getPeak(const float* const* channels, int numChannels, int numSamples)
+    {
+        float peak = 0.0f;
+        for (int c = 0; c < numChannels; ++c)
+            peak = juce::jmax(peak, getPeak(channels[c], numSamples));
+        return peak;
+    }
+
+    // Time for a loop with the given gain to fall below the silence threshold,
+    // in loop periods
+    static float getDecayPeriods(float loopGain)
+    {
+        if (loopGain <= 0.0f)
+            return 1.0f;
+
+        return 1.0f + std::ceil(std::log(silenceThreshold) / std::log(juce::jmin(loopGain, 0.9999f)));
+    }
+
+private:
+    int tailLength = 0;
+    int silentSamples = 0;
+    bool active = false;
+};
+
+//==============================================================================
+// Mono Detector
+// Decides when a multichannel chain can run its per-channel effects on the
+// first channel only and copy the result to the others. Mono starts once every
+// channel of the input has matched the first for the hold time and the chain's
+// output matches too, so the other channels' effect state holds nothing
+// audible when it is dropped. It ends at the first block whose input differs
+// by more than the (higher) exit threshold; the caller then copies the first
+// channel's effect state to the others.
+//==============================================================================
+class FlarkMonoDetector
+{
+public:
+    static constexpr float enterThreshold = 1.0e-5f; // -100 dB
+    static constexpr float exitThreshold = 1.0e-4f;  // -80 dB
+    static constexpr float holdSeconds = 0.1f;
+
+    void setSampleRate(double sr)
+    {
+        holdSamples = juce::jmax(1, juce::roundToInt(sr * holdSeconds));
+        reset();
+    }
+
+    // Call with the input before processing a block. Returns true if the block
+    // runs as mono.
+    bool beginBlock(const float* const* channels, int numChannels, int numSamples)
+    {
+        if (mono)
+        {
+            mono = matches(channels, numChannels, numSamples, exitThreshold);
+            if (! mono)
+                matchingSamples = 0;
+
+            return mono;
+        }
+
+        matchingSamples = matches(channels, numChannels, numSamples, enterThreshold) ? matchingSamples + numSamples : 0;
+        return false;
+    }
+
+    // Call with the output of a block processed with every channel
+    void endBlock(const float* const* channels, int numChannels, int numSamples)
+    {
+        if (! mono && matchingSamples >= holdSamples && matches(channels, numChannels, numSamples, enterThreshold))
+            mono = true;
+    }
+
+    bool isMono() const { return mono; }
+
+    void reset()
+    {
+        mono = false;
+        matchingSamples = 0;
+    }
+
+    // True if no sample pair differs by more than the threshold. Stops at the
+    // first group of 16 that does, so stereo material is rejected cheaply.
+    static bool matches(const float* left, const float* right, int numSamples, float threshold)
+    {
+        int i = 0;
+
+        for (; i + 16 <= numSamples; i += 16)
+        {
+            auto difference = (FlarkFloat4::load(left + i) - FlarkFloat4::load(right + i)).abs();
+            difference = FlarkFloat4::max(difference, (FlarkFloat4::load(left + i + 4) - FlarkFloat4::load(right + i + 4)).abs());
+            difference = FlarkFloat4::max(difference, (FlarkFloat4::load(left + i + 8) - FlarkFloat4::load(right + i + 8)).abs());
+            difference = FlarkFloat4::max(difference, (FlarkFloat4::load(left + i + 12) - FlarkFloat4::load(right + i + 12)).abs());
+
+            if (difference.maxLane() > threshold)
+                return false;
+        }
+
+        for (; i < numSamples; ++i)
+            if (std::abs(left[i] - right[i]) > threshold)
+                return false;
+
+        return true;
+    }
+
+    // True if every channel matches the first
+    static bool matches(const float* const* channels, int numChannels, int numSamples, float threshold)
+    {
+        for (int c = 1; c < numChannels; ++c)
+            if (! matches(channels[0], channels[c], numSamples, threshold))
+                return false;
+
+        return true;
+    }
+
+private:
+    int holdSamples = 4410;
+    int matchingSamples = 0;
+    bool mono = false;
 };
 
 //==============================================================================
@@ -166,6 +503,30 @@ public:
         return output;
     }
 
+    void processBlock(const float* input, float* output, int numSamples)
+    {
+        // Keep coefficients and state in locals so they live in registers
+        const float c0 = b0, c1 = b1, c2 = b2, d1 = a1, d2 = a2;
+        float sx1 = x1, sx2 = x2, sy1 = y1, sy2 = y2;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float in = input[i];
+            const float out = c0 * in + c1 * sx1 + c2 * sx2 - d1 * sy1 - d2 * sy2;
+
+            sx2 = sx1; sx1 = in;
+            sy2 = sy1; sy1 = out;
+            output[i] = out;
+        }
+
+        x1 = sx1; x2 = sx2; y1 = sy1; y2 = sy2;
+    }
+
+    void processBlock(float* data, int numSamples)
+    {
+        processBlock(data, data, numSamples);
+    }
+
     void reset()
     {
         x1 = x2 = y1 = y2 = 0.0f;
@@ -174,9 +535,9 @@ public:
 private:
     void updateCoefficients()
     {
-        float omega = juce::MathConstants<float>::twoPi * cutoff / sampleRate;
-        float sinOmega = std::sin(omega);
-        float cosOmega = std::cos(omega);
+        float cycles = cutoff / sampleRate;
+        float sinOmega = FlarkFastMath::sin2pi(cycles);
+        float cosOmega = FlarkFastMath::cos2pi(cycles);
         float alpha = sinOmega / (2.0f * resonance);
 
         float a0 = 1.0f + alpha;
@@ -223,8 +584,97 @@ private:
     float y1 = 0.0f, y2 = 0.0f;
 };
 
+//==============================================================================
+// Delay Line
+// Circular buffer of four-channel frames (one channel group) with power-of-two
+// capacity, so wrapping is a bitmask instead of a modulo. Block reads and
+// writes touch at most two contiguous spans. Shared by every delay-based
+// effect.
+//==============================================================================
+class FlarkDelayLine
+{
+public:
+    // Allocates room for delays up to maxDelaySamples (plus one for interpolation)
+    void setMaximumDelay(int maxDelaySamples)
+    {
+        const int capacity = juce::nextPowerOfTwo(juce::jmax(2, maxDelaySamples + 2));
+        buffer.assign(static_cast<size_t>(capacity), FlarkFloat4::zero());
+        mask = capacity - 1;
+        writePos = 0;
+    }
+
+    int getMaximumDelay() const { return mask - 1; }
+
+    // Releases the buffer
+    void clear()
+    {
+        buffer = {};
+        mask = 0;
+        writePos = 0;
+    }
+
+    void reset()
+    {
+        std::fill(buffer.begin(), buffer.end(), FlarkFloat4::zero());
+        writePos = 0;
+    }
+
+    // Takes over another line's contents; both must have the same capacity
+    void copyStateFrom(const FlarkDelayLine& other)
+    {
+        jassert(other.buffer.size() == buffer.size());
+        std::copy(other.buffer.begin(), other.buffer.end(), buffer.begin());
+        writePos = other.writePos;
+    }
+
+    // Frame written `delay` pushes ago (delay 1 is the most recent one)
+    FlarkFloat4 read(int delay) const
+    {
+        return buffer[static_cast<size_t>((writePos - delay) & mask)];
+    }
+
+    // Linear interpolation between the two frames around a fractional delay
+    FlarkFloat4 readInterpolated(float delaySamples) const
+    {
+        const int whole = static_cast<int>(delaySamples);
+        const float frac = delaySamples - static_cast<float>(whole);
+        return read(whole + 1) * FlarkFloat4::broadcast(frac) + read(whole) * FlarkFloat4::broadcast(1.0f - frac);
+    }
+
+    void push(FlarkFloat4 frame)
+    {
+        buffer[static_cast<size_t>(writePos)] = frame;
+        writePos = (writePos + 1) & mask;
+    }
+
+    // Copies numSamples consecutive frames, starting `delay` pushes back
+    void readBlock(FlarkFloat4* dest, int delay, int numSamples) const
+    {
+        const int start = (writePos - delay) & mask;
+        const int firstSpan = juce::jmin(numSamples, mask + 1 - start);
+
+        std::copy_n(buffer.data() + start, firstSpan, dest);
+        std::copy_n(buffer.data(), numSamples - firstSpan, dest + firstSpan);
+    }
+
+    void writeBlock(const FlarkFloat4* source, int numSamples)
+    {
+        const int firstSpan = juce::jmin(numSamples, mask + 1 - writePos);
+
+        std::copy_n(source, firstSpan, buffer.data() + writePos);
+        std::copy_n(source + firstSpan, numSamples - firstSpan, buffer.data());
+        writePos = (writePos + numSamples) & mask;
+    }
+
+private:
+    std::vector<FlarkFloat4> buffer;
+    int mask = 0;
+    int writePos = 0;
+};
+
 //==============================================================================
 // Delay Effect
+// One delay line of FlarkChannelGroup frames per four channels.
 //==============================================================================
 class FlarkDelay
 {
@@ -234,6 +684,13 @@ public:
         setMaxDelayTime(2.0f);
     }
 
+    // Allocates; call before processing
+    void setNumChannels(int newNumChannels)
+    {
+        numChannels = juce::jlimit(1, FlarkChannelGroup::maxChannels, newNumChannels);
+        setMaxDelayTime(maxDelayTime);
+    }
+
     void setSampleRate(float sr)
     {
         sampleRate = sr;
@@ -243,9 +700,15 @@ public:
     void setMaxDelayTime(float seconds)
     {
         maxDelayTime = seconds;
-        int bufferSize = static_cast<int>(sampleRate * maxDelayTime) + 1;
-        buffer.resize(bufferSize, 0.0f);
-        writePos = 0;
+        const int numGroups = FlarkChannelGroup::getNumGroups(numChannels);
+
+        for (int g = 0; g < FlarkChannelGroup::maxGroups; ++g)
+        {
+            if (g < numGroups)
+                lines[g].setMaximumDelay(static_cast<int>(sampleRate * maxDelayTime) + 1);
+            else
+                lines[g].clear();
+        }
     }
 
     void setDelayTime(float seconds)
@@ -263,42 +726,97 @@ public:
         wetDry = juce::jlimit(0.0f, 1.0f, mix);
     }
 
-    float process(float input)
+    // In place, up to the channel count set with setNumChannels
+    void processBlock(float* const* channels, int numChannelsToProcess, int numSamples)
     {
-        if (buffer.empty())
-            return input;
+        jassert(numChannelsToProcess <= numChannels);
 
-        // Calculate read position
-        float delaySamples = delayTime * sampleRate;
-        float readPos = writePos - delaySamples;
-        while (readPos < 0)
-            readPos += buffer.size();
+        FlarkChannelGroup groups[FlarkChannelGroup::maxGroups];
+        const int numGroups = FlarkChannelGroup::split(channels, numChannelsToProcess, groups);
 
-        // Linear interpolation
-        int readPos1 = static_cast<int>(readPos) % buffer.size();
-        int readPos2 = (readPos1 + 1) % buffer.size();
-        float frac = readPos - std::floor(readPos);
-        float delayed = buffer[readPos1] * (1.0f - frac) + buffer[readPos2] * frac;
+        for (int g = 0; g < numGroups; ++g)
+            processGroup(lines[g], groups[g], numSamples);
+    }
 
-        // Write with feedback
-        buffer[writePos] = input + delayed * feedback;
+    void processBlock(float* data, int numSamples)
+    {
+        processBlock(&data, 1, numSamples);
+    }
 
-        // Advance write position
-        writePos = (writePos + 1) % buffer.size();
+    void reset()
+    {
+        for (auto& line : lines)
+            line.reset();
+    }
 
-        // Mix wet/dry
-        return input * (1.0f - wetDry) + delayed * wetDry;
+    // Continues channel group `dest` from the state of group `source`
+    void copyGroupState(int source, int dest)
+    {
+        lines[dest].copyStateFrom(lines[source]);
     }
 
-    void reset()
+    // Each repeat is scaled by the feedback, one delay time apart
+    float getTailLengthSeconds() const
     {
-        std::fill(buffer.begin(), buffer.end(), 0.0f);
-        writePos = 0;
+        return delayTime * FlarkTailTracker::getDecayPeriods(feedback) + 1.0f / sampleRate;
     }
 
 private:
-    std::vector<float> buffer;
-    int writePos = 0;
+    void processGroup(FlarkDelayLine& line, const FlarkChannelGroup& group, int numSamples)
+    {
+        const float delaySamples = delayTime * sampleRate;
+        const int whole = static_cast<int>(delaySamples);
+        const float frac = delaySamples - static_cast<float>(whole);
+
+        const auto fb = FlarkFloat4::broadcast(feedback);
+        const auto dryGain = FlarkFloat4::broadcast(1.0f - wetDry);
+        const auto wetGain = FlarkFloat4::broadcast(wetDry);
+
+        // Once the delay is at least a sub-block long, every tap of that
+        // sub-block was written before it started: read it as one span, mix,
+        // then write the sub-block back as one span
+        constexpr int maxSubBlock = 64;
+        FlarkFloat4 taps[maxSubBlock + 1];
+        FlarkFloat4 writes[maxSubBlock];
+
+        int i = 0;
+        while (i < numSamples)
+        {
+            const int n = juce::jmin(maxSubBlock, numSamples - i);
+
+            if (whole < n)
+            {
+                for (int j = 0; j < n; ++j)
+                {
+                    const auto in = group.load(i + j);
+                    const auto delayed = line.readInterpolated(delaySamples);
+                    line.push(in + delayed * fb);
+                    group.store(in * dryGain + delayed * wetGain, i + j);
+                }
+            }
+            else
+            {
+                const auto fracGain = FlarkFloat4::broadcast(frac);
+                const auto nextGain = FlarkFloat4::broadcast(1.0f - frac);
+                line.readBlock(taps, whole + 1, n + 1);
+
+                for (int j = 0; j < n; ++j)
+                {
+                    const auto in = group.load(i + j);
+                    const auto delayed = taps[j] * fracGain + taps[j + 1] * nextGain;
+                    writes[j] = in + delayed * fb;
+                    group.store(in * dryGain + delayed * wetGain, i + j);
+                }
+
+                line.writeBlock(writes, n);
+            }
+
+            i += n;
+        }
+    }
+
+    FlarkDelayLine lines[FlarkChannelGroup::maxGroups];
+    int numChannels = 1;
     float sampleRate = 44100.0f;
     float maxDelayTime = 2.0f;
     float delayTime = 0.5f;
@@ -308,14 +826,23 @@ private:
 
 //==============================================================================
 // Reverb Effect
+// Eight delay lines per channel, run for four channels at once: each line
+// holds FlarkChannelGroup frames, one copy of the lines per group.
 //==============================================================================
 class FlarkReverb
 {
 public:
+    static constexpr int numLines = 8;
+
     FlarkReverb()
     {
-        // Initialize delay lines with prime number lengths for diffusion
-        delayLengths = { 1557, 1617, 1491, 1422, 1277, 1356, 1188, 1116 };
+        initializeDelayLines();
+    }
+
+    // Allocates; call before processing
+    void setNumChannels(int newNumChannels)
+    {
+        numChannels = juce::jlimit(1, FlarkChannelGroup::maxChannels, newNumChannels);
         initializeDelayLines();
     }
 
@@ -341,62 +868,142 @@ public:
         wetDry = juce::jlimit(0.0f, 1.0f, mix);
     }
 
-    float process(float input)
+    // In place, up to the channel count set with setNumChannels
+    void processBlock(float* const* channels, int numChannelsToProcess, int numSamples)
     {
-        float reverbOutput = 0.0f;
-
-        // Process through parallel delay lines
-        for (size_t i = 0; i < delayLines.size(); ++i)
-        {
-            auto& line = delayLines[i];
-            auto& pos = delayPositions[i];
-            auto& lastOut = lastOutputs[i];
+        jassert(numChannelsToProcess <= numChannels);
 
-            // Read from delay line
-            float delayed = line[pos];
+        FlarkChannelGroup groups[FlarkChannelGroup::maxGroups];
+        const int numGroups = FlarkChannelGroup::split(channels, numChannelsToProcess, groups);
 
-            // Apply damping (simple lowpass)
-            delayed = lastOut + damping * (delayed - lastOut);
-            lastOut = delayed;
+        // Every group starts from the same line positions
+        int startPositions[numLines];
+        std::copy(std::begin(positions), std::end(positions), std::begin(startPositions));
 
-            // Write to delay line with feedback
-            line[pos] = input + delayed * 0.5f * roomSize;
-
-            // Accumulate output
-            reverbOutput += delayed;
-
-            // Advance position
-            pos = (pos + 1) % line.size();
+        for (int g = 0; g < numGroups; ++g)
+        {
+            std::copy(std::begin(startPositions), std::end(startPositions), std::begin(positions));
+            processGroup(g, groups[g], numSamples);
         }
+    }
 
-        // Average the delay lines
-        reverbOutput /= delayLines.size();
-
-        // Mix wet/dry
-        return input * (1.0f - wetDry) + reverbOutput * wetDry;
+    void processBlock(float* data, int numSamples)
+    {
+        processBlock(&data, 1, numSamples);
     }
 
     void reset()
     {
-        for (auto& line : delayLines)
-            std::fill(line.begin(), line.end(), 0.0f);
-        std::fill(delayPositions.begin(), delayPositions.end(), 0);
-        std::fill(lastOutputs.begin(), lastOutputs.end(), 0.0f);
+        std::fill(arena.begin(), arena.end(), FlarkFloat4::zero());
+        std::fill(std::begin(positions), std::end(positions), 0);
+
+        for (auto& group : lastOutputs)
+            std::fill(std::begin(group), std::end(group), FlarkFloat4::zero());
+    }
+
+    // Continues channel group `dest` from the state of group `source`
+    void copyGroupState(int source, int dest)
+    {
+        std::copy_n(getLines(source), groupSize, getLines(dest));
+        std::copy(std::begin(lastOutputs[source]), std::end(lastOutputs[source]), std::begin(lastOutputs[dest]));
+    }
+
+    // Each pass through the longest line is scaled by the feedback; the damping
+    // one-pole adds its own decay on top
+    float getTailLengthSeconds() const
+    {
+        const int longest = *std::max_element(std::begin(lineLengths), std::end(lineLengths));
+        const float loopSeconds = static_cast<float>(longest) / sampleRate;
+
+        // With no damping coefficient the one-pole holds its value indefinitely
+        float poleSeconds = 0.0f;
+        if (damping <= 0.0f)
+            poleSeconds = maxTailSeconds;
+        else if (damping < 1.0f)
+            poleSeconds = std::log(FlarkTailTracker::silenceThreshold) / std::log(1.0f - damping) / sampleRate;
+
+        return juce::jmin(maxTailSeconds,
+                          loopSeconds * FlarkTailTracker::getDecayPeriods(0.5f * roomSize) + poleSeconds);
     }
 
 private:
+    static constexpr float maxTailSeconds = 30.0f;
+
+    FlarkFloat4* getLines(int group) { return lines + group * groupSize; }
+
+    // Runs all eight delay lines of one channel group over the block; the
+    // damping state stays in registers
+    void processGroup(int g, const FlarkChannelGroup& group, int numSamples)
+    {
+        const auto damp = FlarkFloat4::broadcast(damping);
+        const auto feedback = FlarkFloat4::broadcast(0.5f * roomSize);
+        const auto dryGain = FlarkFloat4::broadcast(1.0f - wetDry);
+        const auto wetGain = FlarkFloat4::broadcast(wetDry);
+        const auto scale = FlarkFloat4::broadcast(1.0f / numLines);
+
+        FlarkFloat4* groupLines = getLines(g);
+        FlarkFloat4 last[numLines];
+        std::copy(std::begin(lastOutputs[g]), std::end(lastOutputs[g]), std::begin(last));
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto in = group.load(i);
+            FlarkFloat4 delayed[numLines];
+
+            for (int k = 0; k < numLines; ++k)
+            {
+                FlarkFloat4& cell = groupLines[lineOffsets[k] + positions[k]];
+
+                // Damping (simple lowpass), then write back with feedback
+                delayed[k] = last[k] + damp * (cell - last[k]);
+                last[k] = delayed[k];
+                cell = in + delayed[k] * feedback;
+
+                // Advance position, wrapping to 0 without a branch
+                const int next = positions[k] + 1;
+                positions[k] = next & -static_cast<int>(next < lineLengths[k]);
+            }
+
+            // Average the delay lines, in the order the golden references
+            // were recorded with
+            const auto sum = ((delayed[0] + delayed[4]) + (delayed[2] + delayed[6]))
+                           + ((delayed[1] + delayed[5]) + (delayed[3] + delayed[7]));
+
+            group.store(in * dryGain + sum * scale * wetGain, i);
+        }
+
+        std::copy(std::begin(last), std::end(last), std::begin(lastOutputs[g]));
+    }
+
     void initializeDelayLines()
     {
-        delayLines.clear();
-        delayPositions.clear();
-        lastOutputs.clear();
+        // Prime-ish lengths for diffusion, specified at 44.1 kHz and scaled so
+        // the reverb sounds the same at any sample rate
+        static constexpr int baseLengths[numLines] = { 1557, 1617, 1491, 1422, 1277, 1356, 1188, 1116 };
+        constexpr int alignment = 4; // frames per 64-byte cache line
 
-        for (auto length : delayLengths)
+        const float scale = sampleRate / 44100.0f;
+        int total = 0;
+
+        for (int k = 0; k < numLines; ++k)
         {
-            delayLines.push_back(std::vector<float>(length, 0.0f));
-            delayPositions.push_back(0);
-            lastOutputs.push_back(0.0f);
+            lineLengths[k] = juce::jmax(1, juce::roundToInt(static_cast<float>(baseLengths[k]) * scale));
+            lineOffsets[k] = total;
+            total += (lineLengths[k] + alignment - 1) / alignment * alignment;
         }
+
+        // One contiguous arena for all lines of all groups, with the first
+        // line cache-line aligned
+        groupSize = total;
+        arena.assign(static_cast<size_t>(total * FlarkChannelGroup::getNumGroups(numChannels) + alignment),
+                     FlarkFloat4::zero());
+        auto address = reinterpret_cast<std::uintptr_t>(arena.data());
+        auto misalignment = (address / sizeof(FlarkFloat4)) % alignment;
+        lines = arena.data() + (misalignment == 0 ? 0 : alignment - misalignment);
+
+        std::fill(std::begin(positions), std::end(positions), 0);
+        for (auto& group : lastOutputs)
+            std::fill(std::begin(group), std::end(group), FlarkFloat4::zero());
     }
 
     void updateParameters()
@@ -405,11 +1012,15 @@ private:
         // Could be expanded for more sophisticated control
     }
 
-    std::vector<int> delayLengths;
-    std::vector<std::vector<float>> delayLines;
-    std::vector<int> delayPositions;
-    std::vector<float> lastOutputs;
+    std::vector<FlarkFloat4> arena;
+    FlarkFloat4* lines = nullptr;      // aligned start of the arena
+    int groupSize = 0;                 // frames per group, all lines
+    int lineOffsets[numLines] = {};
+    int lineLengths[numLines] = {};
+    int positions[numLines] = {};      // shared by every group
+    FlarkFloat4 lastOutputs[FlarkChannelGroup::maxGroups][numLines];
 
+    int numChannels = 1;
     float sampleRate = 44100.0f;
     float roomSize = 0.5f;
     float damping = 0.5f;
@@ -418,28 +1029,53 @@ private:
 
 //==============================================================================
 // Flanger Effect
+// One sweep for every channel: the sine moving the delay comes from a
+// FlarkLFO, either the flanger's own or, through processBlockModulated, one
+// generated by the caller at getRate(). The delay lines hold FlarkChannelGroup
+// frames, so all channels read the same fractional delay at once.
 //==============================================================================
 class FlarkFlanger
 {
 public:
     FlarkFlanger()
     {
-        buffer.resize(4410, 0.0f); // 100ms at 44.1kHz
+        setSampleRate(sampleRate);
+        lfo.setRate(rate);
+        lfo.setAdvanceBeforeSampling(true);
+    }
+
+    // Allocates; call before processing
+    void setNumChannels(int newNumChannels)
+    {
+        numChannels = juce::jlimit(1, FlarkChannelGroup::maxChannels, newNumChannels);
+        setSampleRate(sampleRate);
     }
 
     void setSampleRate(float sr)
     {
         sampleRate = sr;
-        int maxDelay = static_cast<int>(sampleRate * 0.01f); // 10ms max delay
-        buffer.resize(maxDelay * 2, 0.0f);
-        lfoPhase = 0.0f;
+        const int numGroups = FlarkChannelGroup::getNumGroups(numChannels);
+
+        for (int g = 0; g < FlarkChannelGroup::maxGroups; ++g)
+        {
+            if (g < numGroups)
+                lines[g].setMaximumDelay(static_cast<int>(std::ceil(sampleRate * 0.01f))); // 10ms max delay
+            else
+                lines[g].clear();
+        }
+
+        lfo.setSampleRate(sr);
+        lfo.reset();
     }
 
     void setRate(float rateHz)
     {
         rate = juce::jlimit(0.1f, 10.0f, rateHz);
+        lfo.setRate(rate);
     }
 
+    float getRate() const { return rate; }
+
     void setDepth(float depthAmount)
     {
         depth = juce::jlimit(0.0f, 1.0f, depthAmount);
@@ -455,58 +1091,155 @@ public:
         wetDry = juce::jlimit(0.0f, 1.0f, mix);
     }
 
-    float process(float input)
+    // In place with the internal LFO, up to the channel count set with setNumChannels
+    void processBlock(float* const* channels, int numChannelsToProcess, int numSamples)
     {
-        // Update LFO
-        lfoPhase += rate / sampleRate;
-        if (lfoPhase >= 1.0f)
-            lfoPhase -= 1.0f;
-
-        // Calculate LFO value (sine wave)
-        float lfoValue = std::sin(lfoPhase * 2.0f * juce::MathConstants<float>::pi);
+        float lfoValues[lfoChunkSize];
+        float* chunk[FlarkChannelGroup::maxChannels];
 
-        // Calculate delay time (1-10ms modulated by LFO)
-        float minDelay = 1.0f;  // 1ms
-        float maxDelay = 10.0f; // 10ms
-        float delayMs = minDelay + (maxDelay - minDelay) * depth * (lfoValue * 0.5f + 0.5f);
-        float delaySamples = (delayMs / 1000.0f) * sampleRate;
+        for (int start = 0; start < numSamples; start += lfoChunkSize)
+        {
+            const int chunkSize = juce::jmin(lfoChunkSize, numSamples - start);
+            lfo.processBlock(lfoValues, chunkSize);
+            FlarkChannelGroup::offset(channels, numChannelsToProcess, start, chunk);
+            processBlockModulated(chunk, numChannelsToProcess, lfoValues, chunkSize);
+        }
+    }
 
-        // Read from delay buffer with interpolation
-        int readPos1 = static_cast<int>(writePos - delaySamples);
-        while (readPos1 < 0) readPos1 += buffer.size();
-        readPos1 %= buffer.size();
+    void processBlock(float* data, int numSamples)
+    {
+        processBlock(&data, 1, numSamples);
+    }
 
-        int readPos2 = (readPos1 + 1) % buffer.size();
-        float frac = delaySamples - std::floor(delaySamples);
+    // Sweeps with externally generated sine values (a Sine FlarkLFO at getRate()),
+    // leaving the internal LFO untouched
+    void processBlockModulated(float* const* channels, int numChannelsToProcess, const float* lfoValues, int numSamples)
+    {
+        jassert(numChannelsToProcess <= numChannels);
 
-        float delayed = buffer[readPos1] * (1.0f - frac) + buffer[readPos2] * frac;
+        FlarkChannelGroup groups[FlarkChannelGroup::maxGroups];
+        const int numGroups = FlarkChannelGroup::split(channels, numChannelsToProcess, groups);
 
-        // Write to buffer with feedback
-        buffer[writePos] = input + delayed * feedback;
+        const auto fb = FlarkFloat4::broadcast(feedback);
+        const auto dryGain = FlarkFloat4::broadcast(1.0f - wetDry);
+        const auto wetGain = FlarkFloat4::broadcast(wetDry);
 
-        // Advance write position
-        writePos = (writePos + 1) % buffer.size();
+        for (int i = 0; i < numSamples; ++i)
+        {
+            // Calculate delay time (1-10ms modulated by LFO)
+            float minDelay = 1.0f;  // 1ms
+            float maxDelay = 10.0f; // 10ms
+            float delayMs = minDelay + (maxDelay - minDelay) * depth * (lfoValues[i] * 0.5f + 0.5f);
+            float delaySamples = (delayMs / 1000.0f) * sampleRate;
 
-        // Mix wet/dry
-        return input * (1.0f - wetDry) + delayed * wetDry;
+            for (int g = 0; g < numGroups; ++g)
+            {
+                // Read with interpolation, write with feedback, mix wet/dry
+                const auto in = groups[g].load(i);
+                const auto delayed = lines[g].readInterpolated(delaySamples);
+                lines[g].push(in + delayed * fb);
+                groups[g].store(in * dryGain + delayed * wetGain, i);
+            }
+        }
     }
 
     void reset()
     {
-        std::fill(buffer.begin(), buffer.end(), 0.0f);
-        writePos = 0;
-        lfoPhase = 0.0f;
+        for (auto& line : lines)
+            line.reset();
+        lfo.reset();
+    }
+
+    // Continues channel group `dest` from the state of group `source`
+    void copyGroupState(int source, int dest)
+    {
+        lines[dest].copyStateFrom(lines[source]);
+    }
+
+    // Worst case: the feedback loop at the longest modulated delay
+    float getTailLengthSeconds() const
+    {
+        const float maxDelaySeconds = (1.0f + 9.0f * depth) / 1000.0f;
+        return maxDelaySeconds * FlarkTailTracker::getDecayPeriods(feedback);
     }
 
 private:
-    std::vector<float> buffer;
-    int writePos = 0;
+    static constexpr int lfoChunkSize = 64;
+
+    FlarkDelayLine lines[FlarkChannelGroup::maxGroups];
+    FlarkLFO lfo;
+    int numChannels = 1;
     float sampleRate = 44100.0f;
     float rate = 0.5f;      // LFO rate in Hz
     float depth = 0.5f;     // Modulation depth
     float feedback = 0.5f;  // Feedback amount
     float wetDry = 0.5f;    // Wet/dry mix
-    float lfoPhase = 0.0f;  // LFO phase
+};
+
+//==============================================================================
+// Biquad coefficients with a linear ramp towards a target set
+// Interpolating between two stable biquads stays stable (the a1/a2 stability
+// triangle is convex), so linear coefficient ramps are safe.
+//==============================================================================
+struct FlarkBiquadCoefficients
+{
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f;
+    float a1 = 0.0f, a2 = 0.0f;
+};
+
+class FlarkBiquadRamp
+{
+public:
+    // Immediate change: cancels any ramp in progress
+    void jumpTo(const FlarkBiquadCoefficients& c)
+    {
+        current = target = c;
+        remaining = 0;
+    }
+
+    void rampTo(const FlarkBiquadCoefficients& c, int rampSamples)
+    {
+        if (rampSamples <= 1)
+        {
+            jumpTo(c);
+            return;
+        }
+
+        target = c;
+
+        const float scale = 1.0f / static_cast<float>(rampSamples);
+        delta.b0 = (target.b0 - current.b0) * scale;
+        delta.b1 = (target.b1 - current.b1) * scale;
+        delta.b2 = (target.b2 - current.b2) * scale;
+        delta.a1 = (target.a1 - current.a1) * scale;
+        delta.a2 = (target.a2 - current.a2) * scale;
+        remaining = rampSamples;
+    }
+
+    bool isRamping() const { return remaining > 0; }
+
+    // Steps one sample along the ramp; the last step lands exactly on target
+    void advance()
+    {
+        if (--remaining == 0)
+        {
+            current = target;
+            return;
+        }
+
+        current.b0 += delta.b0;
+        current.b1 += delta.b1;
+        current.b2 += delta.b2;
+        current.a1 += delta.a1;
+        current.a2 += delta.a2;
+    }
+
+    const FlarkBiquadCoefficients& getCurrent() const { return current; }
+    const FlarkBiquadCoefficients& getTarget() const  { return target; }
+
+private:
+    FlarkBiquadCoefficients current, target, delta;
+    int remaining = 0;
 };
 
 //==============================================================================
@@ -523,9 +1256,13 @@ public:
         Bandpass = 2
     };
 
+    // One biquad section; all 3 stages share the same coefficients
+    using Coefficients = FlarkBiquadCoefficients;
+
     FlarkButterworthFilter() : sampleRate(44100.0f)
     {
         reset();
+        updateCoefficients();
     }
 
     void setSampleRate(float sr)
@@ -553,31 +1290,102 @@ public:
         updateCoefficients();
     }
 
+    // Moves to a new cutoff by interpolating the coefficients linearly over
+    // rampSamples samples instead of jumping. Used for control-rate modulation:
+    // the coefficients are designed once per control period and the ramp
+    // removes the zipper noise between periods.
+    void setCutoffSmoothed(float cutoffHz, int rampSamples)
+    {
+        cutoff = juce::jlimit(20.0f, 20000.0f, cutoffHz);
+        rampToCoefficients(makeCoefficients(filterType, cutoff, resonance, sampleRate), rampSamples);
+    }
+
+    void rampToCoefficients(const Coefficients& newTarget, int rampSamples)
+    {
+        coeffs.rampTo(newTarget, rampSamples);
+    }
+
+    const Coefficients& getTargetCoefficients() const { return coeffs.getTarget(); }
+
     float process(float input)
     {
+        if (coeffs.isRamping())
+            coeffs.advance();
+
+        const auto& c = coeffs.getCurrent();
+        const float b0 = c.b0, b1 = c.b1, b2 = c.b2;
+        const float a1 = c.a1, a2 = c.a2;
+
         // Process through 3 cascaded biquad stages for steep rolloff
         float output = input;
 
         // Stage 1
-        output = b0_1 * output + b1_1 * x1_1 + b2_1 * x2_1 - a1_1 * y1_1 - a2_1 * y2_1;
+        output = b0 * output + b1 * x1_1 + b2 * x2_1 - a1 * y1_1 - a2 * y2_1;
         x2_1 = x1_1; x1_1 = input;
         y2_1 = y1_1; y1_1 = output;
 
         // Stage 2
         float input2 = output;
-        output = b0_2 * output + b1_2 * x1_2 + b2_2 * x2_2 - a1_2 * y1_2 - a2_2 * y2_2;
+        output = b0 * output + b1 * x1_2 + b2 * x2_2 - a1 * y1_2 - a2 * y2_2;
         x2_2 = x1_2; x1_2 = input2;
         y2_2 = y1_2; y1_2 = output;
 
         // Stage 3
         float input3 = output;
-        output = b0_3 * output + b1_3 * x1_3 + b2_3 * x2_3 - a1_3 * y1_3 - a2_3 * y2_3;
+        output = b0 * output + b1 * x1_3 + b2 * x2_3 - a1 * y1_3 - a2 * y2_3;
         x2_3 = x1_3; x1_3 = input3;
         y2_3 = y1_3; y1_3 = output;
 
         return output;
     }
 
+    void processBlock(const float* input, float* output, int numSamples)
+    {
+        // Run any pending coefficient ramp per sample, then the rest of the
+        // block with fixed coefficients
+        int i = 0;
+        for (; i < numSamples && coeffs.isRamping(); ++i)
+            output[i] = process(input[i]);
+
+        if (i == numSamples)
+            return;
+
+        const auto& c = coeffs.getCurrent();
+        const float c0 = c.b0, c1 = c.b1, c2 = c.b2, d1 = c.a1, d2 = c.a2;
+
+        float sx1_1 = x1_1, sx2_1 = x2_1, sy1_1 = y1_1, sy2_1 = y2_1;
+        float sx1_2 = x1_2, sx2_2 = x2_2, sy1_2 = y1_2, sy2_2 = y2_2;
+        float sx1_3 = x1_3, sx2_3 = x2_3, sy1_3 = y1_3, sy2_3 = y2_3;
+
+        for (; i < numSamples; ++i)
+        {
+            const float in = input[i];
+
+            const float out1 = c0 * in + c1 * sx1_1 + c2 * sx2_1 - d1 * sy1_1 - d2 * sy2_1;
+            sx2_1 = sx1_1; sx1_1 = in;
+            sy2_1 = sy1_1; sy1_1 = out1;
+
+            const float out2 = c0 * out1 + c1 * sx1_2 + c2 * sx2_2 - d1 * sy1_2 - d2 * sy2_2;
+            sx2_2 = sx1_2; sx1_2 = out1;
+            sy2_2 = sy1_2; sy1_2 = out2;
+
+            const float out3 = c0 * out2 + c1 * sx1_3 + c2 * sx2_3 - d1 * sy1_3 - d2 * sy2_3;
+            sx2_3 = sx1_3; sx1_3 = out2;
+            sy2_3 = sy1_3; sy1_3 = out3;
+
+            output[i] = out3;
+        }
+
+        x1_1 = sx1_1; x2_1 = sx2_1; y1_1 = sy1_1; y2_1 = sy2_1;
+        x1_2 = sx1_2; x2_2 = sx2_2; y1_2 = sy1_2; y2_2 = sy2_2;
+        x1_3 = sx1_3; x2_3 = sx2_3; y1_3 = sy1_3; y2_3 = sy2_3;
+    }
+
+    void processBlock(float* data, int numSamples)
+    {
+        processBlock(data, data, numSamples);
+    }
+
     void reset()
     {
         x1_1 = x2_1 = y1_1 = y2_1 = 0.0f;
@@ -585,44 +1393,51 @@ public:
         x1_3 = x2_3 = y1_3 = y2_3 = 0.0f;
     }
 
-private:
-    void updateCoefficients()
+    static Coefficients makeCoefficients(FilterType type, float cutoffHz, float q, float sr)
     {
         // Butterworth biquad coefficients using bilinear transform
-        float freq = cutoff / sampleRate;
+        float freq = cutoffHz / sr;
         freq = juce::jlimit(0.0001f, 0.499f, freq);
 
+        // libm rather than FlarkFastMath::tanPi: the three resonant stages
+        // magnify a one-ulp change in K past -60 dBFS, and this only runs at
+        // control rate
         float K = std::tan(juce::MathConstants<float>::pi * freq);
-        float Q = resonance;
+        float Q = q;
         float norm = 1.0f / (1.0f + K / Q + K * K);
 
-        switch (filterType)
+        Coefficients c;
+
+        switch (type)
         {
             case Lowpass:
-                // All 3 stages use same coefficients for Butterworth response
-                b0_1 = b0_2 = b0_3 = K * K * norm;
-                b1_1 = b1_2 = b1_3 = 2.0f * b0_1;
-                b2_1 = b2_2 = b2_3 = b0_1;
-                a1_1 = a1_2 = a1_3 = 2.0f * (K * K - 1.0f) * norm;
-                a2_1 = a2_2 = a2_3 = (1.0f - K / Q + K * K) * norm;
+                c.b0 = K * K * norm;
+                c.b1 = 2.0f * c.b0;
+                c.b2 = c.b0;
                 break;
 
             case Highpass:
-                b0_1 = b0_2 = b0_3 = 1.0f * norm;
-                b1_1 = b1_2 = b1_3 = -2.0f * norm;
-                b2_1 = b2_2 = b2_3 = 1.0f * norm;
-                a1_1 = a1_2 = a1_3 = 2.0f * (K * K - 1.0f) * norm;
-                a2_1 = a2_2 = a2_3 = (1.0f - K / Q + K * K) * norm;
+                c.b0 = 1.0f * norm;
+                c.b1 = -2.0f * norm;
+                c.b2 = 1.0f * norm;
                 break;
 
             case Bandpass:
-                b0_1 = b0_2 = b0_3 = K / Q * norm;
-                b1_1 = b1_2 = b1_3 = 0.0f;
-                b2_1 = b2_2 = b2_3 = -(K / Q) * norm;
-                a1_1 = a1_2 = a1_3 = 2.0f * (K * K - 1.0f) * norm;
-                a2_1 = a2_2 = a2_3 = (1.0f - K / Q + K * K) * norm;
+                c.b0 = K / Q * norm;
+                c.b1 = 0.0f;
+                c.b2 = -(K / Q) * norm;
                 break;
         }
+
+        c.a1 = 2.0f * (K * K - 1.0f) * norm;
+        c.a2 = (1.0f - K / Q + K * K) * norm;
+        return c;
+    }
+
+private:
+    void updateCoefficients()
+    {
+        coeffs.jumpTo(makeCoefficients(filterType, cutoff, resonance, sampleRate));
     }
 
     float sampleRate;
@@ -630,10 +1445,8 @@ private:
     float resonance = 3.0f;
     FilterType filterType = Lowpass;
 
-    // Biquad coefficients for 3 stages
-    float b0_1, b1_1, b2_1, a1_1, a2_1;
-    float b0_2, b1_2, b2_2, a1_2, a2_2;
-    float b0_3, b1_3, b2_3, a1_3, a2_3;
+    // Biquad coefficients shared by the 3 stages
+    FlarkBiquadRamp coeffs;
 
     // State variables for 3 stages
     float x1_1 = 0.0f, x2_1 = 0.0f, y1_1 = 0.0f, y2_1 = 0.0f;
@@ -701,6 +1514,32 @@ public:
         return output;
     }
 
+    void processBlock(const float* input, float* output, int numSamples)
+    {
+        if (std::abs(position) < 0.01f)
+        {
+            // Fullrange bypass
+            if (output != input)
+                std::copy(input, input + numSamples, output);
+            return;
+        }
+
+        auto& filter = position < 0.0f ? lowpassFilter : highpassFilter;
+
+        // Blend with dry based on position
+        const float blend = std::abs(position);
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float dry = input[i];
+            output[i] = dry * (1.0f - blend) + filter.process(dry) * blend;
+        }
+    }
+
+    void processBlock(float* data, int numSamples)
+    {
+        processBlock(data, data, numSamples);
+    }
+
     void reset()
     {
         lowpassFilter.reset();
@@ -712,7 +1551,7 @@ private:
     {
         // Map position to frequency (logarithmic)
         // Center (0) = 1kHz, full left = 100Hz, full right = 10kHz
-        float freq = 1000.0f * std::pow(10.0f, position); // 100Hz to 10kHz range
+        float freq = 1000.0f * FlarkFastMath::pow10(position); // 100Hz to 10kHz range
 
         lowpassFilter.setType(FlarkButterworthFilter::Lowpass);
         lowpassFilter.setCutoff(freq);
@@ -730,3 +1569,1139 @@ private:
     FlarkButterworthFilter lowpassFilter;
     FlarkButterworthFilter highpassFilter;
 };
+
+//==============================================================================
+// Linked Multichannel Butterworth Filter
+// Same 3-stage cascade as FlarkButterworthFilter, but every channel shares one
+// coefficient set and the state is held per FlarkChannelGroup, so four
+// channels run through each stage with one set of vector ops. Coefficient
+// ramps advance once per sample for all groups.
+//==============================================================================
+class FlarkMultichannelButterworthFilter
+{
+public:
+    using FilterType = FlarkButterworthFilter::FilterType;
+    using Coefficients = FlarkBiquadCoefficients;
+
+    FlarkMultichannelButterworthFilter()
+    {
+        reset();
+        updateCoefficients();
+    }
+
+    void setSampleRate(float sr)
+    {
+        sampleRate = sr;
+        updateCoefficients();
+    }
+
+    void setType(FilterType type)
+    {
+        filterType = type;
+        updateCoefficients();
+    }
+
+    void setCutoff(float cutoffHz)
+    {
+        cutoff = juce::jlimit(20.0f, 20000.0f, cutoffHz);
+        updateCoefficients();
+    }
+
+    void setResonance(float q)
+    {
+        resonance = juce::jlimit(0.1f, 10.0f, q);
+        updateCoefficients();
+    }
+
+    // Sets type, cutoff and Q with a single coefficient design
+    void setParameters(FilterType type, float cutoffHz, float q)
+    {
+        filterType = type;
+        cutoff = juce::jlimit(20.0f, 20000.0f, cutoffHz);
+        resonance = juce::jlimit(0.1f, 10.0f, q);
+        updateCoefficients();
+    }
+
+    // See FlarkButterworthFilter::setCutoffSmoothed
+    void setCutoffSmoothed(float cutoffHz, int rampSamples)
+    {
+        cutoff = juce::jlimit(20.0f, 20000.0f, cutoffHz);
+        coeffs.rampTo(FlarkButterworthFilter::makeCoefficients(filterType, cutoff, resonance, sampleRate),
+                      rampSamples);
+    }
+
+    // Moves any coefficient ramp on by one sample; call once per sample,
+    // before processFrame for each group
+    void advance()
+    {
+        if (coeffs.isRamping())
+        {
+            coeffs.advance();
+            loadCoefficients();
+        }
+    }
+
+    // Processes one frame of the given channel group
+    FlarkFloat4 processFrame(FlarkFloat4 input, int group)
+    {
+        FlarkFloat4 output = input;
+
+        for (auto& s : stages[group])
+        {
+            const FlarkFloat4 stageInput = output;
+            output = b0 * stageInput + b1 * s.x1 + b2 * s.x2 - a1 * s.y1 - a2 * s.y2;
+            s.x2 = s.x1; s.x1 = stageInput;
+            s.y2 = s.y1; s.y1 = output;
+        }
+
+        return output;
+    }
+
+    // In place, up to FlarkChannelGroup::maxChannels channels
+    void processBlock(float* const* channels, int numChannels, int numSamples)
+    {
+        FlarkChannelGroup groups[FlarkChannelGroup::maxGroups];
+        const int numGroups = FlarkChannelGroup::split(channels, numChannels, groups);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            advance();
+
+            for (int g = 0; g < numGroups; ++g)
+                groups[g].store(processFrame(groups[g].load(i), g), i);
+        }
+    }
+
+    void processBlock(float* left, float* right, int numSamples)
+    {
+        float* channels[] = { left, right };
+        processBlock(channels, 2, numSamples);
+    }
+
+    void reset()
+    {
+        for (auto& group : stages)
+            for (auto& s : group)
+                s.x1 = s.x2 = s.y1 = s.y2 = FlarkFloat4::zero();
+    }
+
+private:
+    struct Stage
+    {
+        FlarkFloat4 x1, x2, y1, y2;
+    };
+
+    void updateCoefficients()
+    {
+        coeffs.jumpTo(FlarkButterworthFilter::makeCoefficients(filterType, cutoff, resonance, sampleRate));
+        loadCoefficients();
+    }
+
+    void loadCoefficients()
+    {
+        const auto& c = coeffs.getCurrent();
+        b0 = FlarkFloat4::broadcast(c.b0);
+        b1 = FlarkFloat4::broadcast(c.b1);
+        b2 = FlarkFloat4::broadcast(c.b2);
+        a1 = FlarkFloat4::broadcast(c.a1);
+        a2 = FlarkFloat4::broadcast(c.a2);
+    }
+
+    float sampleRate = 44100.0f;
+    float cutoff = 400.0f;
+    float resonance = 3.0f;
+    FilterType filterType = FlarkButterworthFilter::Lowpass;
+
+    FlarkBiquadRamp coeffs;
+    FlarkFloat4 b0, b1, b2, a1, a2;   // current coefficients, broadcast to all lanes
+
+    Stage stages[FlarkChannelGroup::maxGroups][3];
+};
+
+//==============================================================================
+// Linked Multichannel State-Variable Filter
+// Topology-preserving (zero-delay feedback) SVF in the form given by
+// Zavalishin and Simper, cascaded three times like
+// FlarkMultichannelButterworthFilter and with the same response at a fixed
+// cutoff. The state is each section's two integrators rather than past inputs
+// and outputs, so the cutoff can move every sample without the transients a
+// direct-form biquad produces. A new cutoff costs one tan (computed four
+// samples at a time in processBlockModulated) and one division, not a
+// coefficient redesign. Each section computes lowpass, bandpass and highpass
+// in the same pass; the filter type only picks the mix.
+//==============================================================================
+class FlarkMultichannelSVF
+{
+public:
+    using FilterType = FlarkButterworthFilter::FilterType;
+
+    FlarkMultichannelSVF()
+    {
+        reset();
+        updateCoefficients();
+    }
+
+    void setSampleRate(float sr)
+    {
+        sampleRate = sr;
+        updateCoefficients();
+    }
+
+    void setType(FilterType type)
+    {
+        filterType = type;
+        updateCoefficients();
+    }
+
+    void setCutoff(float cutoffHz)
+    {
+        cutoff = juce::jlimit(20.0f, 20000.0f, cutoffHz);
+        updateCoefficients();
+    }
+
+    void setResonance(float q)
+    {
+        resonance = juce::jlimit(0.1f, 10.0f, q);
+        updateCoefficients();
+    }
+
+    void setParameters(FilterType type, float cutoffHz, float q)
+    {
+        filterType = type;
+        cutoff = juce::jlimit(20.0f, 20000.0f, cutoffHz);
+        resonance = juce::jlimit(0.1f, 10.0f, q);
+        updateCoefficients();
+    }
+
+    // Glides to a new cutoff over rampSamples samples, moving g (the prewarped
+    // cutoff) linearly, so no tan is needed per sample
+    void setCutoffSmoothed(float cutoffHz, int rampSamples)
+    {
+        cutoff = juce::jlimit(20.0f, 20000.0f, cutoffHz);
+        const float target = prewarp(cutoff);
+
+        if (rampSamples <= 1)
+        {
+            setG(target);
+            rampRemaining = 0;
+            return;
+        }
+
+        gTarget = target;
+        gStep = (target - g) / static_cast<float>(rampSamples);
+        rampRemaining = rampSamples;
+    }
+
+    // Moves any glide on by one sample; call once per sample, before
+    // processFrame for each group
+    void advance()
+    {
+        if (rampRemaining > 0)
+            setG(--rampRemaining == 0 ? gTarget : g + gStep);
+    }
+
+    // Processes one frame of the given channel group
+    FlarkFloat4 processFrame(FlarkFloat4 input, int group)
+    {
+        return processFrame(input, group, FlarkFloat4::broadcast(a1), FlarkFloat4::broadcast(a2),
+                            FlarkFloat4::broadcast(a3));
+    }
+
+    // In place, up to FlarkChannelGroup::maxChannels channels
+    void processBlock(float* const* channels, int numChannels, int numSamples)
+    {
+        FlarkChannelGroup groups[FlarkChannelGroup::maxGroups];
+        const int numGroups = FlarkChannelGroup::split(channels, numChannels, groups);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            advance();
+
+            for (int g = 0; g < numGroups; ++g)
+                groups[g].store(processFrame(groups[g].load(i), g), i);
+        }
+    }
+
+    void processBlock(float* left, float* right, int numSamples)
+    {
+        float* channels[] = { left, right };
+        processBlock(channels, 2, numSamples);
+    }
+
+    // Audio-rate modulation: a cutoff in Hz for every sample. Any glide in
+    // progress is dropped; the last cutoff stays in effect afterwards.
+    void processBlockModulated(float* const* channels, int numChannels, const float* cutoffHz, int numSamples)
+    {
+        if (numSamples <= 0)
+            return;
+
+        FlarkChannelGroup groups[FlarkChannelGroup::maxGroups];
+        const int numGroups = FlarkChannelGroup::split(channels, numChannels, groups);
+
+        const auto one = FlarkFloat4::broadcast(1.0f);
+        const auto k4 = FlarkFloat4::broadcast(k);
+        const auto scale = FlarkFloat4::broadcast(1.0f / sampleRate);
+        float a1s[4], a2s[4], a3s[4];
+
+        for (int i = 0; i < numSamples; i += 4)
+        {
+            const int count = juce::jmin(4, numSamples - i);
+
+            float cutoffs[4];
+            for (int j = 0; j < 4; ++j)
+                cutoffs[j] = cutoffHz[i + juce::jmin(j, count - 1)];
+
+            // Same limits as setCutoff and prewarp, four samples per tan
+            const auto freq = FlarkFloat4::min(FlarkFloat4::max(FlarkFloat4::load(cutoffs), FlarkFloat4::broadcast(20.0f)),
+                                               FlarkFloat4::broadcast(20000.0f)) * scale;
+            const auto gs = FlarkFastMath::tanPi(FlarkFloat4::min(FlarkFloat4::max(freq, FlarkFloat4::broadcast(0.0001f)),
+                                                                  FlarkFloat4::broadcast(0.499f)));
+            const auto a1v = one / (one + gs * (gs + k4));
+            const auto a2v = gs * a1v;
+            a1v.store(a1s);
+            a2v.store(a2s);
+            (gs * a2v).store(a3s);
+
+            for (int j = 0; j < count; ++j)
+            {
+                const auto c1 = FlarkFloat4::broadcast(a1s[j]);
+                const auto c2 = FlarkFloat4::broadcast(a2s[j]);
+                const auto c3 = FlarkFloat4::broadcast(a3s[j]);
+
+                for (int g = 0; g < numGroups; ++g)
+                    groups[g].store(processFrame(groups[g].load(i + j), g, c1, c2, c3), i + j);
+            }
+
+            if (i + count == numSamples)
+            {
+                float lastG[4];
+                gs.store(lastG);
+                cutoff = juce::jlimit(20.0f, 20000.0f, cutoffs[count - 1]);
+                setG(lastG[count - 1]);
+            }
+        }
+
+        rampRemaining = 0;
+    }
+
+    void processBlockModulated(float* left, float* right, const float* cutoffHz, int numSamples)
+    {
+        float* channels[] = { left, right };
+        processBlockModulated(channels, 2, cutoffHz, numSamples);
+    }
+
+    void reset()
+    {
+        for (auto& group : sections)
+            for (auto& s : group)
+                s.ic1 = s.ic2 = FlarkFloat4::zero();
+    }
+
+private:
+    struct Section
+    {
+        FlarkFloat4 ic1, ic2;   // integrator states
+    };
+
+    // The three cascaded sections; output = m0 * input + m1 * band + m2 * low
+    FlarkFloat4 processFrame(FlarkFloat4 input, int group, FlarkFloat4 c1, FlarkFloat4 c2, FlarkFloat4 c3)
+    {
+        const auto two = FlarkFloat4::broadcast(2.0f);
+        FlarkFloat4 output = input;
+
+        for (auto& s : sections[group])
+        {
+            const FlarkFloat4 x = output;
+            const FlarkFloat4 v3 = x - s.ic2;
+            const FlarkFloat4 band = c1 * s.ic1 + c2 * v3;
+            const FlarkFloat4 low = s.ic2 + c2 * s.ic1 + c3 * v3;
+            s.ic1 = two * band - s.ic1;
+            s.ic2 = two * low - s.ic2;
+            output = m0 * x + m1 * band + m2 * low;
+        }
+
+        return output;
+    }
+
+    float prewarp(float cutoffHz) const
+    {
+        return FlarkFastMath::tanPi(juce::jlimit(0.0001f, 0.499f, cutoffHz / sampleRate));
+    }
+
+    void setG(float newG)
+    {
+        g = newG;
+        a1 = 1.0f / (1.0f + g * (g + k));
+        a2 = g * a1;
+        a3 = g * a2;
+    }
+
+    void updateCoefficients()
+    {
+        k = 1.0f / resonance;
+
+        // Lowpass is the low output, highpass what is left of the input,
+        // bandpass the band output scaled to unity gain at the centre
+        float mix[3] = { 0.0f, 0.0f, 1.0f };
+        switch (filterType)
+        {
+            case FlarkButterworthFilter::Lowpass:  break;
+            case FlarkButterworthFilter::Highpass: mix[0] = 1.0f; mix[1] = -k; mix[2] = -1.0f; break;
+            case FlarkButterworthFilter::Bandpass: mix[1] = k; mix[2] = 0.0f; break;
+        }
+
+        m0 = FlarkFloat4::broadcast(mix[0]);
+        m1 = FlarkFloat4::broadcast(mix[1]);
+        m2 = FlarkFloat4::broadcast(mix[2]);
+
+        rampRemaining = 0;
+        setG(prewarp(cutoff));
+    }
+
+    float sampleRate = 44100.0f;
+    float cutoff = 400.0f;
+    float resonance = 3.0f;
+    FilterType filterType = FlarkButterworthFilter::Lowpass;
+
+    float k = 1.0f / 3.0f;                  // damping, 1 / Q
+    float g = 0.0f, a1 = 1.0f, a2 = 0.0f, a3 = 0.0f;
+    float gTarget = 0.0f, gStep = 0.0f;
+    int rampRemaining = 0;
+    FlarkFloat4 m0, m1, m2;
+
+    Section sections[FlarkChannelGroup::maxGroups][3];
+};
+
+//==============================================================================
+// Linked Multichannel DJ Isolator
+// FlarkIsolator for every channel of a layout, built on
+// FlarkMultichannelButterworthFilter or, in StateVariable mode,
+// FlarkMultichannelSVF, whose cutoff glides over a few milliseconds when the
+// position moves instead of jumping.
+//==============================================================================
+class FlarkMultichannelIsolator
+{
+public:
+    enum Topology
+    {
+        Biquad = 0,
+        StateVariable = 1
+    };
+
+    FlarkMultichannelIsolator()
+    {
+        updateFilters();
+    }
+
+    void setSampleRate(float sr)
+    {
+        lowpassFilter.setSampleRate(sr);
+        highpassFilter.setSampleRate(sr);
+        svf.setSampleRate(sr);
+        glideSamples = juce::jmax(1, juce::roundToInt(sr * 0.005f));
+    }
+
+    // Switching clears the filter state
+    void setTopology(Topology newTopology)
+    {
+        if (topology == newTopology)
+            return;
+
+        topology = newTopology;
+        svfType = FlarkButterworthFilter::Bandpass; // forces a fresh design
+        reset();
+        updateFilters();
+    }
+
+    // Position: -1.0 (full lowpass) to +1.0 (full highpass), 0.0 = fullrange
+    void setPosition(float pos)
+    {
+        position = juce::jlimit(-1.0f, 1.0f, pos);
+        updateFilters();
+    }
+
+    void setQ(float q)
+    {
+        qValue = juce::jlimit(0.5f, 10.0f, q);
+        updateFilters();
+    }
+
+    // In place, up to FlarkChannelGroup::maxChannels channels
+    void processBlock(float* const* channels, int numChannels, int numSamples)
+    {
+        if (std::abs(position) < 0.01f)
+            return; // Fullrange bypass
+
+        if (topology == StateVariable)
+            processBlock(svf, channels, numChannels, numSamples);
+        else
+            processBlock(position < 0.0f ? lowpassFilter : highpassFilter, channels, numChannels, numSamples);
+    }
+
+    void processBlock(float* left, float* right, int numSamples)
+    {
+        float* channels[] = { left, right };
+        processBlock(channels, 2, numSamples);
+    }
+
+    void reset()
+    {
+        lowpassFilter.reset();
+        highpassFilter.reset();
+        svf.reset();
+    }
+
+private:
+    template <typename Filter>
+    void processBlock(Filter& filter, float* const* channels, int numChannels, int numSamples)
+    {
+        FlarkChannelGroup groups[FlarkChannelGroup::maxGroups];
+        const int numGroups = FlarkChannelGroup::split(channels, numChannels, groups);
+
+        // Blend with dry based on position
+        const float blend = std::abs(position);
+        const auto dryGain = FlarkFloat4::broadcast(1.0f - blend);
+        const auto wetGain = FlarkFloat4::broadcast(blend);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            filter.advance();
+
+            for (int g = 0; g < numGroups; ++g)
+            {
+                const auto dry = groups[g].load(i);
+                groups[g].store(dry * dryGain + filter.processFrame(dry, g) * wetGain, i);
+            }
+        }
+    }
+
+    void updateFilters()
+    {
+        // Center (0) = 1kHz, full left = 100Hz, full right = 10kHz
+        float freq = 1000.0f * FlarkFastMath::pow10(position);
+
+        if (topology == StateVariable)
+        {
+            const auto type = position < 0.0f ? FlarkButterworthFilter::Lowpass : FlarkButterworthFilter::Highpass;
+
+            if (type != svfType || qValue != svfQ)
+            {
+                svfType = type;
+                svfQ = qValue;
+                svf.setParameters(type, freq, qValue);
+            }
+            else
+            {
+                svf.setCutoffSmoothed(freq, glideSamples);
+            }
+            return;
+        }
+
+        lowpassFilter.setParameters(FlarkButterworthFilter::Lowpass, freq, qValue);
+        highpassFilter.setParameters(FlarkButterworthFilter::Highpass, freq, qValue);
+    }
+
+    float position = 0.0f;  // -1 to +1
+    float qValue = 2.0f;
+    Topology topology = Biquad;
+
+    FlarkMultichannelButterworthFilter lowpassFilter;
+    FlarkMultichannelButterworthFilter highpassFilter;
+
+    FlarkMultichannelSVF svf;
+    FlarkButterworthFilter::FilterType svfType = FlarkButterworthFilter::Bandpass; // none yet
+    float svfQ = 0.0f;
+    int glideSamples = 221;
+};
+
+//==============================================================================
+// Three-Band Isolator
+// DJ-mixer style low/mid/high gains (0 = full kill) on every channel of a
+// layout, split by two 4th-order Linkwitz-Riley crossovers. The output is written as
+//
+//   gMid * allpass(x) + (gLow - gMid) * low + (gHigh - gMid) * high
+//
+// where allpass(x) is what the three bands sum to (both crossovers' allpass
+// responses). The mid band is never computed, and the low/high filters are
+// skipped entirely while both match the mid gain (all three at unity, say),
+// leaving two allpass sections. Band weights start from zero when the filters
+// come back in, and gains glide over 10 ms, so neither clicks.
+//
+// The dry path runs per FlarkChannelGroup. The low and high bands run
+// together for each channel pair: one four-lane pass holds
+// [low L, low R, high L, high R], each lane with its own coefficients. Each
+// band also goes through the other crossover's allpass so the bands stay in
+// phase with allpass(x).
+//==============================================================================
+class FlarkThreeBandIsolator
+{
+public:
+    static constexpr float defaultLowCrossover = 300.0f;
+    static constexpr float defaultHighCrossover = 3000.0f;
+
+    enum Band { Low = 0, Mid, High };
+
+    FlarkThreeBandIsolator()
+    {
+        updateFilters();
+    }
+
+    void setSampleRate(float sr)
+    {
+        sampleRate = sr;
+        rampLength = juce::jmax(1, juce::roundToInt(sr * 0.01f));
+        updateFilters();
+    }
+
+    void setCrossovers(float lowHz, float highHz)
+    {
+        lowCrossover = juce::jlimit(20.0f, 20000.0f, lowHz);
+        highCrossover = juce::jlimit(lowCrossover, 20000.0f, highHz);
+        updateFilters();
+    }
+
+    // Linear band gains, 0 = kill; glides from the current gains
+    void setGains(float low, float mid, float high)
+    {
+        const float newTargets[] = { juce::jmax(0.0f, low), juce::jmax(0.0f, mid), juce::jmax(0.0f, high) };
+
+        if (std::equal(std::begin(newTargets), std::end(newTargets), std::begin(targets)))
+            return;
+
+        std::copy(std::begin(newTargets), std::end(newTargets), std::begin(targets));
+        rampRemaining = rampLength;
+    }
+
+    float getGain(Band band) const { return targets[band]; }
+
+    // In place, up to FlarkChannelGroup::maxChannels channels
+    void processBlock(float* const* channels, int numChannels, int numSamples)
+    {
+        FlarkChannelGroup groups[FlarkChannelGroup::maxGroups];
+        const int numGroups = FlarkChannelGroup::split(channels, numChannels, groups);
+
+        const bool bandsNeeded = rampRemaining > 0 || gains[Low] != gains[Mid] || gains[High] != gains[Mid];
+
+        if (bandsNeeded && ! bandsActive)
+            resetBands(); // their weights are zero here, so they fade in from silence
+
+        bandsActive = bandsNeeded;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (rampRemaining > 0)
+                advanceRamp();
+
+            const auto mid = FlarkFloat4::broadcast(gains[Mid]);
+            const auto bandGains = FlarkFloat4::set(gains[Low], gains[Low], gains[High], gains[High]);
+
+            for (int g = 0; g < numGroups; ++g)
+            {
+                const auto& group = groups[g];
+                FlarkFloat4 out = mid * allpassHigh[g].process(allpassLow[g].process(group.load(i)));
+
+                if (bandsActive)
+                {
+                    // Lanes 0/1 of the group add the first pair's low then
+                    // high band, lanes 2/3 the second pair's, in that order
+                    FlarkFloat4 weighted[2] = { FlarkFloat4::zero(), FlarkFloat4::zero() };
+                    const int numPairs = (group.getNumLanes() + 1) / 2;
+
+                    for (int q = 0; q < numPairs; ++q)
+                    {
+                        const int pair = g * 2 + q;
+                        const float a = group.getChannel(q * 2)[i];
+                        const float b = group.getChannel(q * 2 + 1)[i];
+                        const auto bands = align[pair].process(split[pair][1].process(split[pair][0].process(
+                            FlarkFloat4::set(a, b, a, b))));
+                        weighted[q] = bands * bandGains - bands * mid;
+                    }
+
+                    out = out + FlarkFloat4::joinHalves(weighted[0], weighted[1].swapHalves())
+                              + FlarkFloat4::joinHalves(weighted[0].swapHalves(), weighted[1]);
+                }
+
+                group.store(out, i);
+            }
+        }
+    }
+
+    void processBlock(float* left, float* right, int numSamples)
+    {
+        float* channels[] = { left, right };
+        processBlock(channels, 2, numSamples);
+    }
+
+    void reset()
+    {
+        for (int g = 0; g < FlarkChannelGroup::maxGroups; ++g)
+        {
+            allpassLow[g].reset();
+            allpassHigh[g].reset();
+        }
+
+        resetBands();
+        std::copy(std::begin(targets), std::end(targets), std::begin(gains));
+        rampRemaining = 0;
+    }
+
+private:
+    // A biquad section with its own coefficients in each lane (transposed
+    // direct form II)
+    struct Section
+    {
+        FlarkFloat4 b0, b1, b2, a1, a2;
+        FlarkFloat4 s1 = FlarkFloat4::zero(), s2 = FlarkFloat4::zero();
+
+        void setLanes(const FlarkBiquadCoefficients& lanes01, const FlarkBiquadCoefficients& lanes23)
+        {
+            b0 = FlarkFloat4::set(lanes01.b0, lanes01.b0, lanes23.b0, lanes23.b0);
+            b1 = FlarkFloat4::set(lanes01.b1, lanes01.b1, lanes23.b1, lanes23.b1);
+            b2 = FlarkFloat4::set(lanes01.b2, lanes01.b2, lanes23.b2, lanes23.b2);
+            a1 = FlarkFloat4::set(lanes01.a1, lanes01.a1, lanes23.a1, lanes23.a1);
+            a2 = FlarkFloat4::set(lanes01.a2, lanes01.a2, lanes23.a2, lanes23.a2);
+        }
+
+        FlarkFloat4 process(FlarkFloat4 x)
+        {
+            const FlarkFloat4 y = b0 * x + s1;
+            s1 = b1 * x - a1 * y + s2;
+            s2 = b2 * x - a2 * y;
+            return y;
+        }
+
+        void reset() { s1 = s2 = FlarkFloat4::zero(); }
+    };
+
+    // A 4th-order Linkwitz-Riley filter is a Butterworth biquad (Q = 1/sqrt 2)
+    // run twice; its lowpass and highpass sum to this allpass
+    static FlarkBiquadCoefficients makeAllpass(const FlarkBiquadCoefficients& butterworth)
+    {
+        FlarkBiquadCoefficients c;
+        c.b0 = butterworth.a2;
+        c.b1 = butterworth.a1;
+        c.b2 = 1.0f;
+        c.a1 = butterworth.a1;
+        c.a2 = butterworth.a2;
+        return c;
+    }
+
+    void updateFilters()
+    {
+        const float q = juce::MathConstants<float>::sqrt2 * 0.5f;
+        const auto lowpass = FlarkButterworthFilter::makeCoefficients(FlarkButterworthFilter::Lowpass, lowCrossover, q, sampleRate);
+        const auto highpass = FlarkButterworthFilter::makeCoefficients(FlarkButterworthFilter::Highpass, highCrossover, q, sampleRate);
+        const auto lowAllpass = makeAllpass(lowpass);
+        const auto highAllpass = makeAllpass(highpass);
+
+        for (int pair = 0; pair < maxPairs; ++pair)
+        {
+            split[pair][0].setLanes(lowpass, highpass);
+            split[pair][1].setLanes(lowpass, highpass);
+            align[pair].setLanes(highAllpass, lowAllpass);
+        }
+
+        for (int g = 0; g < FlarkChannelGroup::maxGroups; ++g)
+        {
+            allpassLow[g].setLanes(lowAllpass, lowAllpass);
+            allpassHigh[g].setLanes(highAllpass, highAllpass);
+        }
+    }
+
+    void resetBands()
+    {
+        for (int pair = 0; pair < maxPairs; ++pair)
+        {
+            split[pair][0].reset();
+            split[pair][1].reset();
+            align[pair].reset();
+        }
+    }
+
+    void advanceRamp()
+    {
+        if (--rampRemaining == 0)
+        {
+            std::copy(std::begin(targets), std::end(targets), std::begin(gains));
+            return;
+        }
+
+        for (int band = 0; band < 3; ++band)
+            gains[band] += (targets[band] - gains[band]) / static_cast<float>(rampRemaining + 1);
+    }
+
+    float sampleRate = 44100.0f;
+    float lowCrossover = defaultLowCrossover;
+    float highCrossover = defaultHighCrossover;
+
+    float gains[3] = { 1.0f, 1.0f, 1.0f };
+    float targets[3] = { 1.0f, 1.0f, 1.0f };
+    int rampLength = 441;
+    int rampRemaining = 0;
+    bool bandsActive = false;
+
+    static constexpr int maxPairs = FlarkChannelGroup::maxChannels / 2;
+
+    Section split[maxPairs][2];     // [lowpass L, R, highpass L, R], twice
+    Section align[maxPairs];        // the other crossover's allpass on each band
+    Section allpassLow[FlarkChannelGroup::maxGroups];    // the dry path
+    Section allpassHigh[FlarkChannelGroup::maxGroups];
+};
+
+//==============================================================================
+// Soft Limiter
+// tanh saturation scaled so the output never exceeds the threshold.
+//==============================================================================
+class FlarkSoftLimiter
+{
+public:
+    // Output ceiling, linear (0.95 is about -0.5 dB)
+    void setThreshold(float newThreshold)
+    {
+        threshold = juce::jlimit(0.01f, 1.0f, newThreshold);
+        makeup = 1.0f / threshold; // Compensate for threshold reduction
+    }
+
+    float getThreshold() const { return threshold; }
+
+    float process(float input) const
+    {
+        return FlarkFastMath::tanh(input * makeup) * threshold;
+    }
+
+    FlarkFloat4 process(FlarkFloat4 input) const
+    {
+        return FlarkFastMath::tanh(input * FlarkFloat4::broadcast(makeup)) * FlarkFloat4::broadcast(threshold);
+    }
+
+    void processBlock(float* data, int numSamples) const
+    {
+        int i = 0;
+        for (; i + 4 <= numSamples; i += 4)
+            process(FlarkFloat4::load(data + i)).store(data + i);
+
+        for (; i < numSamples; ++i)
+            data[i] = process(data[i]);
+    }
+
+private:
+    float threshold = 0.95f;
+    float makeup = 1.0f / 0.95f;
+};
+
+//==============================================================================
+// True-Peak Detector
+// 4x polyphase interpolator for ITU-R BS.1770 style true-peak detection. The
+// Kaiser-windowed sinc is centred on a tap of phase 0, so lane 0 reproduces
+// the input exactly and lanes 1-3 are the points in between, all computed as
+// one four-lane multiply-add per tap. Output lags the input by `delay` samples.
+//==============================================================================
+class FlarkTruePeakDetector
+{
+public:
+    static constexpr int tapsPerPhase = 12;
+    static constexpr int delay = tapsPerPhase / 2;
+
+    FlarkTruePeakDetector() : coefficients(getCoefficients()) {}
+
+    void reset()
+    {
+        std::fill(std::begin(history), std::end(history), 0.0f);
+        position = 0;
+    }
+
+    // The four interpolated values around the sample `delay` steps back
+    FlarkFloat4 process(float input)
+    {
+        // Newest first; written twice so the read never wraps
+        position = position == 0 ? tapsPerPhase - 1 : position - 1;
+        history[position] = history[position + tapsPerPhase] = input;
+
+        const float* x = history + position;
+        FlarkFloat4 sum = FlarkFloat4::zero();
+
+        for (int k = 0; k < tapsPerPhase; ++k)
+            sum = sum + FlarkFloat4::broadcast(x[k]) * coefficients[k];
+
+        return sum;
+    }
+
+    float processPeak(float input) { return process(input).abs().maxLane(); }
+
+private:
+    // Lane p of coefficient k is tap 4k + p of the 48-tap prototype
+    static const FlarkFloat4* getCoefficients()
+    {
+        struct Table
+        {
+            FlarkFloat4 taps[tapsPerPhase];
+
+            Table()
+            {
+                constexpr double centre = tapsPerPhase * 2;  // tap 4 * delay
+                constexpr double beta = 6.0;
+                const double pi = juce::MathConstants<double>::pi;
+
+                auto besselI0 = [](double x)
+                {
+                    double sum = 1.0, term = 1.0;
+                    for (int i = 1; i < 32; ++i)
+                    {
+                        term *= (x * 0.5 / i) * (x * 0.5 / i);
+                        sum += term;
+                    }
+                    return sum;
+                };
+
+                float values[4][tapsPerPhase];
+
+                for (int phase = 0; phase < 4; ++phase)
+                {
+                    double phaseTaps[tapsPerPhase];
+                    double phaseSum = 0.0;
+
+                    for (int k = 0; k < tapsPerPhase; ++k)
+                    {
+                        const double n = 4 * k + phase - centre;
+                        const double t = n / 4.0;
+                        const double sinc = t == 0.0 ? 1.0 : std::sin(pi * t) / (pi * t);
+                        const double r = n / centre;
+
+                        phaseTaps[k] = sinc * besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / besselI0(beta);
+                        phaseSum += phaseTaps[k];
+                    }
+
+                    // Unity gain at DC for every phase
+                    for (int k = 0; k < tapsPerPhase; ++k)
+                        values[phase][k] = static_cast<float>(phaseTaps[k] / phaseSum);
+                }
+
+                for (int k = 0; k < tapsPerPhase; ++k)
+                    taps[k] = FlarkFloat4::set(values[0][k], values[1][k], values[2][k], values[3][k]);
+            }
+        };
+
+        static const Table table;
+        return table.taps;
+    }
+
+    const FlarkFloat4* coefficients;
+    float history[tapsPerPhase * 2] {};
+    int position = 0;
+};
+
+//==============================================================================
+// Lookahead Limiter
+// Linked brickwall limiter for every channel of a layout. The audio is delayed by the lookahead while
+// the gain needed for the loudest sample in the window (a sliding maximum
+// kept in a monotonic deque, O(1) per sample) is smoothed with a moving
+// average of the same length, so the gain has fully dropped by the time the
+// peak leaves the delay line. Releases exponentially. The delay line holds
+// FlarkChannelGroup frames.
+//
+// With true-peak detection on, the 4x interpolated peaks are limited too, at
+// the cost of FlarkTruePeakDetector::delay samples more latency.
+//==============================================================================
+class FlarkLookaheadLimiter
+{
+public:
+    static constexpr float maxLookaheadMs = 10.0f;
+
+    FlarkLookaheadLimiter() { setSampleRate(44100.0f); }
+
+    // Allocates; call before processing
+    void setSampleRate(float newSampleRate)
+    {
+        sampleRate = newSampleRate;
+
+        // Room for the longest hold window plus the sample entering it
+        const int maxWindow = static_cast<int>(std::ceil(maxLookaheadMs * 0.001f * sampleRate)) + FlarkTruePeakDetector::delay + 2;
+        delayLength = static_cast<int>(juce::nextPowerOfTwo(maxWindow));
+
+        delayFrames.assign(static_cast<size_t>(delayLength * FlarkChannelGroup::maxGroups), FlarkFloat4::zero());
+        averageRing.assign(static_cast<size_t>(delayLength), 1.0f);
+        dequeIndices.assign(static_cast<size_t>(delayLength), 0);
+        dequePeaks.assign(static_cast<size_t>(delayLength), 0.0f);
+
+        updateRelease();
+        updateWindows();
+    }
+
+    // 0 to maxLookaheadMs. Changes the latency and clears the limiter.
+    void setLookahead(float milliseconds)
+    {
+        lookaheadMs = juce::jlimit(0.0f, maxLookaheadMs, milliseconds);
+        updateWindows();
+    }
+
+    // Changes the latency and clears the limiter
+    void setTruePeakEnabled(bool shouldDetectTruePeaks)
+    {
+        truePeak = shouldDetectTruePeaks;
+        updateWindows();
+    }
+
+    void setReleaseTime(float milliseconds)
+    {
+        releaseMs = juce::jmax(1.0f, milliseconds);
+        updateRelease();
+    }
+
+    // Output ceiling, linear (0.95 is about -0.5 dB)
+    void setCeiling(float newCeiling) { ceiling = juce::jlimit(0.01f, 1.0f, newCeiling); }
+
+    int getLatencySamples() const { return latency; }
+    float getGain() const { return gain; }
+
+    void reset()
+    {
+        std::fill(delayFrames.begin(), delayFrames.end(), FlarkFloat4::zero());
+        std::fill(averageRing.begin(), averageRing.end(), 1.0f);
+
+        for (auto& detector : truePeakDetectors)
+            detector.reset();
+
+        writePos = 0;
+        averagePos = 0;
+        averageSum = averageLength;
+        dequeHead = dequeTail = 0;
+        sampleIndex = 0;
+        gain = 1.0f;
+    }
+
+    // One frame of every channel group in place, for numChannels channels
+    // (up to FlarkChannelGroup::maxChannels)
+    void process(FlarkFloat4* frames, int numChannels)
+    {
+        const int numGroups = FlarkChannelGroup::getNumGroups(numChannels);
+
+        auto peaks = frames[0].abs();
+        for (int g = 1; g < numGroups; ++g)
+            peaks = FlarkFloat4::max(peaks, frames[g].abs());
+
+        float peak = peaks.maxLane();
+
+        if (truePeak)
+        {
+            float samples[FlarkChannelGroup::maxChannels];
+            for (int g = 0; g < numGroups; ++g)
+                frames[g].store(samples + g * FlarkChannelGroup::width);
+
+            auto truePeaks = FlarkFloat4::zero();
+            for (int c = 0; c < numChannels; ++c)
+                truePeaks = FlarkFloat4::max(truePeaks, truePeakDetectors[c].process(samples[c]).abs());
+
+            peak = std::max(peak, truePeaks.maxLane());
+        }
+
+        // Sliding maximum over the hold window: drop smaller entries from the
+        // back, expired ones from the front
+        const int mask = delayLength - 1;
+
+        while (dequeTail != dequeHead && dequePeaks[static_cast<size_t>((dequeTail - 1) & mask)] <= peak)
+            dequeTail = (dequeTail - 1) & mask;
+
+        dequeIndices[static_cast<size_t>(dequeTail)] = sampleIndex;
+        dequePeaks[static_cast<size_t>(dequeTail)] = peak;
+        dequeTail = (dequeTail + 1) & mask;
+
+        // Indices only advance by one, so at most one entry expires
+        if (sampleIndex - dequeIndices[static_cast<size_t>(dequeHead)] >= static_cast<juce::uint32>(holdLength))
+            dequeHead = (dequeHead + 1) & mask;
+
+        ++sampleIndex;
+
+        const float windowPeak = dequePeaks[static_cast<size_t>(dequeHead)];
+        const float target = windowPeak > ceiling ? ceiling / windowPeak : 1.0f;
+
+        // Moving average: the gain reaches the target across the lookahead
+        auto& oldest = averageRing[static_cast<size_t>(averagePos)];
+        averageSum += static_cast<double>(target) - oldest;
+        oldest = target;
+        averagePos = averagePos + 1 == averageLength ? 0 : averagePos + 1;
+
+        const float attack = static_cast<float>(averageSum * inverseAverageLength);
+        gain = attack < gain ? attack : attack + releaseCoeff * (gain - attack);
+
+        // Delay line, one stretch of delayLength frames per group
+        const int readPos = (writePos - latency) & mask;
+        const auto gains = FlarkFloat4::broadcast(gain);
+
+        for (int g = 0; g < numGroups; ++g)
+        {
+            FlarkFloat4* line = delayFrames.data() + g * delayLength;
+            line[writePos] = frames[g];
+            frames[g] = line[readPos] * gains;
+        }
+
+        writePos = (writePos + 1) & mask;
+    }
+
+    // In place, up to FlarkChannelGroup::maxChannels channels
+    void processBlock(float* const* channels, int numChannels, int numSamples)
+    {
+        FlarkChannelGroup groups[FlarkChannelGroup::maxGroups];
+        const int numGroups = FlarkChannelGroup::split(channels, numChannels, groups);
+        FlarkFloat4 frames[FlarkChannelGroup::maxGroups];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            for (int g = 0; g < numGroups; ++g)
+                frames[g] = groups[g].load(i);
+
+            process(frames, numChannels);
+
+            for (int g = 0; g < numGroups; ++g)
+                groups[g].store(frames[g], i);
+        }
+    }
+
+    void processBlock(float* left, float* right, int numSamples)
+    {
+        float* channels[] = { left, right };
+        processBlock(channels, 2, numSamples);
+    }
+
+private:
+    void updateWindows()
+    {
+        const int lookahead = juce::roundToInt(lookaheadMs * 0.001f * sampleRate);
+
+        latency = lookahead + (truePeak ? FlarkTruePeakDetector::delay : 0);
+        holdLength = latency + 1;
+        averageLength = lookahead + 1;
+        inverseAverageLength = 1.0 / averageLength;
+        reset();
+    }
+
+    void updateRelease()
+    {
+        releaseCoeff = std::exp(-1.0f / (releaseMs * 0.001f * sampleRate));
+    }
+
+    float sampleRate = 44100.0f;
+    float lookaheadMs = 1.5f;
+    float releaseMs = 80.0f;
+    float ceiling = 0.95f;
+    float releaseCoeff = 0.0f;
+    bool truePeak = false;
+
+    int latency = 0, holdLength = 1, averageLength = 1;
+    double inverseAverageLength = 1.0;
+
+    std::vector<FlarkFloat4> delayFrames;
+    int delayLength = 0, writePos = 0;
+
+    std::vector<float> averageRing;
+    int averagePos = 0;
+    double averageSum = 1.0;
+
+    // Monotonic deque of (sample index, peak), decreasing peaks from head to tail
+    std::vector<juce::uint32> dequeIndices;
+    std::vector<float> dequePeaks;
+    int dequeHead = 0, dequeTail = 0;
+    juce::uint32 sampleIndex = 0;
+
+    FlarkTruePeakDetector truePeakDetectors[FlarkChannelGroup::maxChannels];
+    float gain = 1.0f;
+};
@@ -27,6 +27,11 @@ FlarkDJEditor::FlarkDJEditor(FlarkDJProcessor& p)
     filterTypeCombo.addItemList(juce::StringArray{"Lowpass", "Highpass", "Bandpass"}, 1);
     filterTypeAttachment.reset(new ComboBoxAttachment(params, "filterType", filterTypeCombo));
 
+    addAndMakeVisible(filterTopologyCombo);
+    setupComboBox(filterTopologyCombo);
+    filterTopologyCombo.addItemList(juce::StringArray{"Biquad", "State Variable"}, 1);
+    filterTopologyAttachment.reset(new ComboBoxAttachment(params, "filterTopology", filterTopologyCombo));
+
     // ========== REVERB SECTION ==========
     addAndMakeVisible(reverbEnabledButton);
     setupButton(reverbEnabledButton);
@@ -106,6 +111,29 @@ FlarkDJEditor::FlarkDJEditor(FlarkDJProcessor& p)
     isolatorQAttachment.reset(new SliderAttachment(params, "isolatorQ", isolatorQSlider));
     createLabel("Q / Bandwidth", isolatorQSlider);
 
+    addAndMakeVisible(isolatorModeCombo);
+    setupComboBox(isolatorModeCombo);
+    isolatorModeCombo.addItemList(juce::StringArray{"Sweep", "3-Band"}, 1);
+    isolatorModeAttachment.reset(new ComboBoxAttachment(params, "isolatorMode", isolatorModeCombo));
+    isolatorModeCombo.onChange = [this] { updateIsolatorControls(); };
+
+    addAndMakeVisible(isolatorLowSlider);
+    setupSlider(isolatorLowSlider);
+    isolatorLowAttachment.reset(new SliderAttachment(params, "isolatorLow", isolatorLowSlider));
+    createLabel("Low", isolatorLowSlider);
+
+    addAndMakeVisible(isolatorMidSlider);
+    setupSlider(isolatorMidSlider);
+    isolatorMidAttachment.reset(new SliderAttachment(params, "isolatorMid", isolatorMidSlider));
+    createLabel("Mid", isolatorMidSlider);
+
+    addAndMakeVisible(isolatorHighSlider);
+    setupSlider(isolatorHighSlider);
+    isolatorHighAttachment.reset(new SliderAttachment(params, "isolatorHigh", isolatorHighSlider));
+    createLabel("High", isolatorHighSlider);
+
+    updateIsolatorControls();
+
     // ========== LFO SECTION ==========
     addAndMakeVisible(lfoRateSlider);
     setupSlider(lfoRateSlider);
@@ -132,6 +160,22 @@ FlarkDJEditor::FlarkDJEditor(FlarkDJProcessor& p)
     lfoSyncRateCombo.addItemList(juce::StringArray{"1/4", "1/8", "1/16", "1/32", "1/2", "1 Bar"}, 1);
     lfoSyncRateAttachment.reset(new ComboBoxAttachment(params, "lfoSyncRate", lfoSyncRateCombo));
 
+    // ========== LIMITER ==========
+    addAndMakeVisible(limiterModeCombo);
+    setupComboBox(limiterModeCombo);
+    limiterModeCombo.addItemList(juce::StringArray{"Soft Clip", "Lookahead", "Lookahead True Peak"}, 1);
+    limiterModeAttachment.reset(new ComboBoxAttachment(params, "limiterMode", limiterModeCombo));
+    limiterModeCombo.onChange = [this] { updateLimiterControls(); };
+    createLabel("Limiter", limiterModeCombo);
+
+    addAndMakeVisible(limiterLookaheadSlider);
+    setupSlider(limiterLookaheadSlider, juce::Slider::LinearHorizontal);
+    limiterLookaheadSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 60, 18);
+    limiterLookaheadAttachment.reset(new SliderAttachment(params, "limiterLookahead", limiterLookaheadSlider));
+    createLabel("Lookahead (ms)", limiterLookaheadSlider);
+
+    updateLimiterControls();
+
     // ========== PRESET MANAGER ==========
     addAndMakeVisible(presetCombo);
     setupComboBox(presetCombo);
@@ -192,23 +236,37 @@ FlarkDJEditor::FlarkDJEditor(FlarkDJProcessor& p)
     xyPadYParam.addItemList(juce::StringArray{"Filter Resonance", "Reverb Damping", "Delay Feedback", "LFO Depth", "Isolator Q"}, 1);
     xyPadYParam.setSelectedId(2, juce::dontSendNotification);
 
+    // DSP load readout
+    addAndMakeVisible(performanceLabel);
+    performanceLabel.setFont(juce::Font(12.0f));
+    performanceLabel.setColour(juce::Label::textColourId, juce::Colour(0xffdddddd));
+    performanceLabel.setJustificationType(juce::Justification::topLeft);
+
+    // Output spectrum; the analyzer only runs while the editor is open
+    addAndMakeVisible(spectrumDisplay);
+    audioProcessor.getSpectrumAnalyzer().setActive(true);
+
     // Start timer for XY pad updates
     startTimer(50);
 
     // Enable resizing with constraints (AFTER all components are initialized)
     setResizable(true, true);
     setResizeLimits(800, 750, 1400, 1100);
-    setSize(950, 900);
+    setSize(950, 935);
 }
 
 FlarkDJEditor::~FlarkDJEditor()
 {
     stopTimer();
+    audioProcessor.getSpectrumAnalyzer().setActive(false);
 }
 
 //==============================================================================
 void FlarkDJEditor::paint(juce::Graphics& g)
 {
+    FLARKDJ_TRACE_THREAD("message");
+    FLARKDJ_TRACE_SCOPE("editorPaint");
+
     // Background gradient
     auto bounds = getLocalBounds();
     juce::ColourGradient bgGradient(
@@ -366,7 +424,10 @@ void FlarkDJEditor::resized()
     filterArea.removeFromTop(smallSpacing);
     filterResonanceSlider.setBounds(filterArea.removeFromTop(largeKnobSize));
     filterArea.removeFromTop(smallSpacing);
-    filterTypeCombo.setBounds(filterArea.removeFromLeft(static_cast<int>(270 * scale)).removeFromTop(comboHeight));
+    auto filterComboArea = filterArea.removeFromLeft(static_cast<int>(270 * scale));
+    filterTypeCombo.setBounds(filterComboArea.removeFromTop(comboHeight));
+    filterComboArea.removeFromTop(smallSpacing);
+    filterTopologyCombo.setBounds(filterComboArea.removeFromTop(comboHeight));
     firstRow.removeFromLeft(spacing);
 
     // Reverb section
@@ -414,9 +475,21 @@ void FlarkDJEditor::resized()
     isolatorArea.removeFromTop(titleSpace);
     isolatorEnabledButton.setBounds(isolatorArea.removeFromTop(buttonHeight));
     isolatorArea.removeFromTop(mediumSpacing);
+    isolatorModeCombo.setBounds(isolatorArea.removeFromTop(comboHeight));
+
+    // Only one mode's controls are visible, so both use the space below the combo
+    auto bandArea = isolatorArea;
+    isolatorArea.removeFromTop(mediumSpacing);
     isolatorPositionSlider.setBounds(isolatorArea.removeFromTop(sliderHeight));
     isolatorArea.removeFromTop(static_cast<int>(20 * scale));
     isolatorQSlider.setBounds(isolatorArea.removeFromTop(largeKnobSize));
+
+    bandArea.removeFromTop(mediumSpacing);
+    isolatorLowSlider.setBounds(bandArea.removeFromTop(mediumKnobSize));
+    bandArea.removeFromTop(smallSpacing);
+    isolatorMidSlider.setBounds(bandArea.removeFromTop(mediumKnobSize));
+    bandArea.removeFromTop(smallSpacing);
+    isolatorHighSlider.setBounds(bandArea.removeFromTop(mediumKnobSize));
     secondRow.removeFromLeft(spacing);
 
     // LFO section (with BPM sync)
@@ -432,6 +505,14 @@ void FlarkDJEditor::resized()
     lfoArea.removeFromTop(mediumSpacing);
     lfoSyncRateCombo.setBounds(lfoArea.removeFromTop(comboHeight));
 
+    // ========== LIMITER STRIP ==========
+    area.removeFromTop(spacing);
+    auto limiterStrip = area.removeFromTop(static_cast<int>(25 * scale)).reduced(static_cast<int>(10 * scale), 0);
+    limiterStrip.removeFromLeft(static_cast<int>(70 * scale));   // "Limiter" label
+    limiterModeCombo.setBounds(limiterStrip.removeFromLeft(static_cast<int>(200 * scale)).reduced(0, 3));
+    limiterStrip.removeFromLeft(static_cast<int>(130 * scale));  // "Lookahead (ms)" label
+    limiterLookaheadSlider.setBounds(limiterStrip.removeFromLeft(static_cast<int>(300 * scale)));
+
     // ========== XY PAD SECTION ==========
     area.removeFromTop(static_cast<int>(10 * scale));
     auto xyPadSection = area.removeFromTop(static_cast<int>(150 * scale));
@@ -449,6 +530,15 @@ void FlarkDJEditor::resized()
     xyPadXParam.setBounds(xyControlArea.removeFromTop(static_cast<int>(25 * scale)));
     xyControlArea.removeFromTop(static_cast<int>(8 * scale));
     xyPadYParam.setBounds(xyControlArea.removeFromTop(static_cast<int>(25 * scale)));
+
+    // DSP load readout (right of the XY controls)
+    xyPadSection.removeFromLeft(static_cast<int>(30 * scale));
+    performanceLabel.setBounds(xyPadSection.removeFromLeft(static_cast<int>(210 * scale))
+                                           .withTrimmedTop(static_cast<int>(30 * scale)));
+
+    // Spectrum fills the rest of the row
+    xyPadSection.removeFromLeft(static_cast<int>(10 * scale));
+    spectrumDisplay.setBounds(xyPadSection.withTrimmedBottom(static_cast<int>(10 * scale)));
 }
 
 //==============================================================================
@@ -508,12 +598,85 @@ juce::Label* FlarkDJEditor::createLabel(const juce::String& text, juce::Componen
     labels.push_back(std::move(label));
     return labelPtr;
 }
+
+void FlarkDJEditor::updateLimiterControls()
+{
+    limiterLookaheadSlider.setEnabled(limiterModeCombo.getSelectedItemIndex() != 0);
+}
+
+void FlarkDJEditor::updateIsolatorControls()
+{
+    // Sweep uses position and Q, 3-Band the band gains; attached labels follow
+    const bool threeBand = isolatorModeCombo.getSelectedItemIndex() == 1;
+
+    isolatorPositionSlider.setVisible(! threeBand);
+    isolatorQSlider.setVisible(! threeBand);
+    isolatorLowSlider.setVisible(threeBand);
+    isolatorMidSlider.setVisible(threeBand);
+    isolatorHighSlider.setVisible(threeBand);
+}
 //==============================================================================
 // Timer callback for XY pad updates
 void FlarkDJEditor::timerCallback()
 {
+    FLARKDJ_TRACE_THREAD("message");
+    FLARKDJ_TRACE_SCOPE("timerCallback");
+
     // Update XY pad when parameters change externally
     // This keeps the visual position in sync with actual parameter values
+
+    // Spectrum, whenever the analyzer has a new frame
+    const auto lastFrame = spectrum.frameIndex;
+    audioProcessor.getSpectrumAnalyzer().getSpectrum(spectrum);
+    if (spectrum.frameIndex != lastFrame)
+        spectrumDisplay.setSpectrum(spectrum);
+
+    // DSP load readout, four times a second
+    if (++performanceUpdateCounter >= 5)
+    {
+        performanceUpdateCounter = 0;
+        updatePerformanceLabel();
+    }
+}
+
+void FlarkDJEditor::updatePerformanceLabel()
+{
+    const auto stats = audioProcessor.getPerformanceSnapshot();
+
+    if (stats.numBlocks == 0)
+    {
+        performanceLabel.setText("DSP: idle", juce::dontSendNotification);
+        return;
+    }
+
+    // Most expensive stage on average
+    int topStage = 0;
+    for (int i = 1; i < FlarkDJPerformanceMonitor::numStages; ++i)
+        if (stats.stageTotalSeconds[i] > stats.stageTotalSeconds[topStage])
+            topStage = i;
+
+    const double topShare = stats.totalAudioSeconds > 0.0 ? stats.stageTotalSeconds[topStage] / stats.totalAudioSeconds : 0.0;
+
+    juce::String text;
+    text << "DSP load " << juce::String(stats.recentLoad * 100.0, 1) << "% (peak "
+         << juce::String(stats.maxLoad * 100.0, 1) << "%)\n"
+         << "Overruns: " << stats.numOverruns << "\n"
+         << "Heaviest: " << FlarkDJPerformanceMonitor::getStageName(topStage) << " "
+         << juce::String(topShare * 100.0, 1) << "%";
+
+    if (stats.worstOverrun.block >= 0)
+        text << "\nWorst overrun: " << juce::String(stats.worstOverrun.load * 100.0, 0) << "% at block "
+             << stats.worstOverrun.block;
+
+    // Loudness, and the highest true peak of either channel
+    const auto meter = audioProcessor.getMeterReadings();
+    const float maxTruePeak = juce::jmax(meter.maxTruePeak[0], meter.maxTruePeak[1]);
+    auto lufs = [](float value) { return value > FlarkDJMeter::floorLufs ? juce::String(value, 1) : juce::String("-inf"); };
+
+    text << "\nLUFS S " << lufs(meter.shortTermLufs) << " / I " << lufs(meter.integratedLufs)
+         << ", TP " << juce::String(juce::Decibels::gainToDecibels(maxTruePeak), 1) << " dB";
+
+    performanceLabel.setText(text, juce::dontSendNotification);
 }
 
 //==============================================================================
@@ -573,6 +736,8 @@ void FlarkDJEditor::savePreset()
 
                 if (presetName.isNotEmpty())
                 {
+                    FLARKDJ_TRACE_SCOPE("presetSave");
+
                     auto presetDir = getPresetDirectory();
                     auto presetFile = presetDir.getChildFile(presetName + ".fxp");
 
@@ -601,6 +766,8 @@ void FlarkDJEditor::loadPreset(const juce::String& presetName)
     if (presetName.isEmpty() || presetName == "-- No Presets --")
         return;
 
+    FLARKDJ_TRACE_SCOPE("presetLoad");
+
     auto presetDir = getPresetDirectory();
     auto presetFile = presetDir.getChildFile(presetName + ".fxp");
 
@@ -286,6 +286,62 @@ private:
     float yValue = 0.5f;
 };
 
+//==============================================================================
+// Output spectrum on a log-frequency axis, from FlarkDJSpectrumAnalyzer
+class SpectrumDisplay : public juce::Component
+{
+public:
+    void setSpectrum(const FlarkDJSpectrumAnalyzer::Spectrum& spectrum)
+    {
+        bands = spectrum.displayDb;
+        peakFrequency = spectrum.peakFrequency;
+        repaint();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat().reduced(2);
+
+        g.setColour(juce::Colour(0xff0a0a0a));
+        g.fillRoundedRectangle(bounds, 5);
+
+        if (bands.size() > 1)
+        {
+            // -90 dBFS at the bottom, 0 dBFS at the top
+            auto area = bounds.reduced(4);
+            juce::Path path;
+            path.startNewSubPath(area.getX(), area.getBottom());
+
+            for (size_t i = 0; i < bands.size(); ++i)
+            {
+                const float x = area.getX() + area.getWidth() * static_cast<float>(i) / static_cast<float>(bands.size() - 1);
+                const float level = juce::jlimit(0.0f, 1.0f, (bands[i] + 90.0f) / 90.0f);
+                path.lineTo(x, area.getBottom() - level * area.getHeight());
+            }
+
+            path.lineTo(area.getRight(), area.getBottom());
+            path.closeSubPath();
+
+            g.setColour(juce::Colour(0xffff6600).withAlpha(0.35f));
+            g.fillPath(path);
+            g.setColour(juce::Colour(0xffff6600));
+            g.strokePath(path, juce::PathStrokeType(1.5f));
+
+            g.setColour(juce::Colour(0xffdddddd));
+            g.setFont(juce::Font(11.0f));
+            g.drawText("Peak " + juce::String(juce::roundToInt(peakFrequency)) + " Hz",
+                       area.reduced(4).toNearestInt(), juce::Justification::topRight);
+        }
+
+        g.setColour(juce::Colour(0xffff6600).withAlpha(0.6f));
+        g.drawRoundedRectangle(bounds, 5, 2);
+    }
+
+private:
+    std::vector<float> bands;
+    float peakFrequency = 0.0f;
+};
+
 //==============================================================================
 class FlarkDJEditor : public juce::AudioProcessorEditor,
                       private juce::Timer
@@ -316,6 +372,7 @@ private:
     juce::Slider filterCutoffSlider;
     juce::Slider filterResonanceSlider;
     juce::ComboBox filterTypeCombo;
+    juce::ComboBox filterTopologyCombo;
 
     // Reverb controls
     juce::ToggleButton reverbEnabledButton;
@@ -339,6 +396,10 @@ private:
     juce::ToggleButton isolatorEnabledButton;
     juce::Slider isolatorPositionSlider;
     juce::Slider isolatorQSlider;
+    juce::ComboBox isolatorModeCombo;
+    juce::Slider isolatorLowSlider;       // 3-Band mode gains, in place of position and Q
+    juce::Slider isolatorMidSlider;
+    juce::Slider isolatorHighSlider;
 
     // LFO controls
     juce::Slider lfoRateSlider;
@@ -347,6 +408,11 @@ private:
     juce::ToggleButton lfoSyncButton;
     juce::ComboBox lfoSyncRateCombo;
 
+    // Limiter controls. Both change the latency, so they are not automatable
+    // and this is the only place to set them.
+    juce::ComboBox limiterModeCombo;
+    juce::Slider limiterLookaheadSlider;
+
     //==============================================================================
     // Preset Manager
     juce::ComboBox presetCombo;
@@ -367,6 +433,14 @@ private:
     juce::ComboBox xyPadXParam;
     juce::ComboBox xyPadYParam;
 
+    // DSP load readout (see FlarkDJProcessor::getPerformanceSnapshot)
+    juce::Label performanceLabel;
+    int performanceUpdateCounter = 0;
+
+    // Output spectrum
+    SpectrumDisplay spectrumDisplay;
+    FlarkDJSpectrumAnalyzer::Spectrum spectrum;
+
     //==============================================================================
     // Labels
     std::vector<std::unique_ptr<juce::Label>> labels;
@@ -381,6 +455,7 @@ private:
     std::unique_ptr<SliderAttachment> filterCutoffAttachment;
     std::unique_ptr<SliderAttachment> filterResonanceAttachment;
     std::unique_ptr<ComboBoxAttachment> filterTypeAttachment;
+    std::unique_ptr<ComboBoxAttachment> filterTopologyAttachment;
 
     std::unique_ptr<ButtonAttachment> reverbEnabledAttachment;
     std::unique_ptr<SliderAttachment> reverbRoomSizeAttachment;
@@ -400,6 +475,10 @@ private:
     std::unique_ptr<ButtonAttachment> isolatorEnabledAttachment;
     std::unique_ptr<SliderAttachment> isolatorPositionAttachment;
     std::unique_ptr<SliderAttachment> isolatorQAttachment;
+    std::unique_ptr<ComboBoxAttachment> isolatorModeAttachment;
+    std::unique_ptr<SliderAttachment> isolatorLowAttachment;
+    std::unique_ptr<SliderAttachment> isolatorMidAttachment;
+    std::unique_ptr<SliderAttachment> isolatorHighAttachment;
 
     std::unique_ptr<SliderAttachment> lfoRateAttachment;
     std::unique_ptr<SliderAttachment> lfoDepthAttachment;
@@ -407,12 +486,21 @@ private:
     std::unique_ptr<ButtonAttachment> lfoSyncAttachment;
     std::unique_ptr<ComboBoxAttachment> lfoSyncRateAttachment;
 
+    std::unique_ptr<ComboBoxAttachment> limiterModeAttachment;
+    std::unique_ptr<SliderAttachment> limiterLookaheadAttachment;
+
     //==============================================================================
     void setupSlider(juce::Slider& slider, juce::Slider::SliderStyle style = juce::Slider::Rotary);
     void setupButton(juce::ToggleButton& button);
     void setupComboBox(juce::ComboBox& combo);
     juce::Label* createLabel(const juce::String& text, juce::Component& attachTo);
 
+    // Shows the isolator controls of the selected mode
+    void updateIsolatorControls();
+
+    // The lookahead only applies to the lookahead limiter modes
+    void updateLimiterControls();
+
     //==============================================================================
     // Preset management methods
     void loadPresetList();
@@ -432,6 +520,8 @@ private:
     void updateXYPadMapping();
     juce::RangedAudioParameter* getParameterByName(const juce::String& paramName);
 
+    void updatePerformanceLabel();
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FlarkDJEditor)
 };
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <tuple>
+#include <utility>
+
+/**
+ * FlarkDJ compile-time effect chain
+ *
+ * A chain is a std::tuple of stage types. Each stage provides
+ *
+ *     static constexpr unsigned bit;   // enable bit, or 0 for "always on"
+ *     static void process(Context&, float* const* channels, int numChannels, int numSamples);
+ *
+ * One kernel is generated per combination of enable bits. Each kernel calls
+ * only the stages that are on for that combination, in chain order, so a block
+ * pays one indirect call and no per-stage tests or loads for disabled effects.
+ */
+template <typename Context, typename StageTuple>
+class FlarkEffectChain;
+
+template <typename Context, typename... Stages>
+class FlarkEffectChain<Context, std::tuple<Stages...>>
+{
+public:
+    using Kernel = void (*)(Context&, float* const*, int, int);
+
+    static constexpr unsigned enableMask = (Stages::bit | ... | 0u);
+    static constexpr unsigned numKernels = enableMask + 1;
+
+    static_assert((enableMask & (enableMask + 1)) == 0,
+                  "Stage enable bits must be contiguous, starting at bit 0");
+
+    // Runs the kernel for the given set of enabled stages
+    static void process(unsigned mask, Context& context, float* const* channels, int numChannels, int numSamples)
+    {
+        kernels[mask & enableMask](context, channels, numChannels, numSamples);
+    }
+
+    template <unsigned Mask>
+    static void run(Context& context, float* const* channels, int numChannels, int numSamples)
+    {
+        (runStage<Mask, Stages>(context, channels, numChannels, numSamples), ...);
+    }
+
+private:
+    template <unsigned Mask, typename Stage>
+    static void runStage(Context& context, float* const* channels, int numChannels, int numSamples)
+    {
+        if constexpr (Stage::bit == 0 || (Mask & Stage::bit) != 0)
+            Stage::process(context, channels, numChannels, numSamples);
+    }
+
+    template <unsigned... Masks>
+    static constexpr std::array<Kernel, numKernels> makeKernels(std::integer_sequence<unsigned, Masks...>)
+    {
+        return { { &run<Masks>... } };
+    }
+
+    static constexpr std::array<Kernel, numKernels> kernels =
+        makeKernels(std::make_integer_sequence<unsigned, numKernels>{});
+};
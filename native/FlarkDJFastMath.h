@@ -0,0 +1,115 @@
+#pragma once
+
+#include "FlarkDJSIMD.h"
+
+/**
+ * FlarkDJ Fast Math
+ *
+ * Polynomial approximations of the transcendentals on the DSP hot paths, four
+ * lanes at a time. The float overloads run the same arithmetic in one lane,
+ * so scalar and vector callers get identical results.
+ *
+ * Maximum errors against double-precision libm, checked by FlarkDJFastMathTests:
+ *
+ *   sin2pi(x)  sin(2 pi x)    |x| < 2^20             absolute 3e-7
+ *   cos2pi(x)  cos(2 pi x)    |x| < 2^20             absolute 3e-7
+ *   tanPi(x)   tan(pi x)      0 <= x <= 0.45         relative 1e-6
+ *   tanh(x)    tanh(x)        any finite x           absolute 2e-7
+ *   exp2(x)    2^x            -126 <= x <= 127       relative 3e-7
+ *   pow10(x)   10^x           -37 <= x <= 38         relative 5e-6 (|x| <= 1: 4e-7)
+ *
+ * Errors are absolute or relative to the exact value. None of these handle
+ * NaN or infinite input. Coefficients are Chebyshev fits, accurate well below
+ * float resolution, so what remains is mostly rounding; pow10's larger bound
+ * away from 0 is the rounding of x log2(10) scaled up by the exponent.
+ */
+namespace FlarkFastMath
+{
+    //==============================================================================
+    // 2^x: 2^round(x) from the exponent bits times a polynomial for 2^f, |f| <= 0.5
+    inline FlarkFloat4 exp2(FlarkFloat4 x)
+    {
+        const FlarkFloat4 n = x.round();
+        const FlarkFloat4 f = x - n;
+
+        FlarkFloat4 p = FlarkFloat4::broadcast(1.546144470e-04f);
+        p = p * f + FlarkFloat4::broadcast(1.340042818e-03f);
+        p = p * f + FlarkFloat4::broadcast(9.618056679e-03f);
+        p = p * f + FlarkFloat4::broadcast(5.550327227e-02f);
+        p = p * f + FlarkFloat4::broadcast(2.402265092e-01f);
+        p = p * f + FlarkFloat4::broadcast(6.931472067e-01f);
+        p = p * f + FlarkFloat4::broadcast(1.0f);
+
+        return p * n.pow2OfInteger();
+    }
+
+    inline FlarkFloat4 pow10(FlarkFloat4 x)
+    {
+        return exp2(x * FlarkFloat4::broadcast(3.321928095f)); // log2(10)
+    }
+
+    //==============================================================================
+    namespace detail
+    {
+        // sin(2 pi v) for |v| <= 0.25 as v times an even polynomial, accurate
+        // relative to the result all the way down to v = 0
+        inline FlarkFloat4 sinQuarter(FlarkFloat4 v)
+        {
+            const FlarkFloat4 w = v * v;
+
+            FlarkFloat4 p = FlarkFloat4::broadcast(3.975982709e+01f);
+            p = p * w + FlarkFloat4::broadcast(-7.658117264e+01f);
+            p = p * w + FlarkFloat4::broadcast(8.160247637e+01f);
+            p = p * w + FlarkFloat4::broadcast(-4.134168061e+01f);
+            p = p * w + FlarkFloat4::broadcast(6.283185280e+00f);
+
+            return p * v;
+        }
+    }
+
+    // sin(2 pi x). The phase is wrapped to r in [-0.5, 0.5] and |r| folded
+    // onto the first quarter period; every step before the polynomial is exact.
+    inline FlarkFloat4 sin2pi(FlarkFloat4 x)
+    {
+        const FlarkFloat4 r = x - x.round();
+        const FlarkFloat4 a = r.abs();
+
+        return detail::sinQuarter(FlarkFloat4::min(a, FlarkFloat4::broadcast(0.5f) - a)).withSignOf(r);
+    }
+
+    // cos(2 pi x) = sin(2 pi (0.25 - |r|))
+    inline FlarkFloat4 cos2pi(FlarkFloat4 x)
+    {
+        const FlarkFloat4 r = x - x.round();
+        return detail::sinQuarter(FlarkFloat4::broadcast(0.25f) - r.abs());
+    }
+
+    // tan(pi x) for the bilinear-transform prewarp, x = cutoff / sample rate.
+    // No wrapping: valid for 0 <= x < 0.5.
+    inline FlarkFloat4 tanPi(FlarkFloat4 x)
+    {
+        const FlarkFloat4 half = x * FlarkFloat4::broadcast(0.5f);
+        return detail::sinQuarter(half) / detail::sinQuarter(FlarkFloat4::broadcast(0.25f) - half);
+    }
+
+    //==============================================================================
+    // tanh(x) = sign(x) (1 - 2 / (e^2|x| + 1)), saturating to 1 once e^2|x|
+    // passes 2^40
+    inline FlarkFloat4 tanh(FlarkFloat4 x)
+    {
+        const FlarkFloat4 e = exp2(FlarkFloat4::min(x.abs() * FlarkFloat4::broadcast(2.885390082f), // 2 log2(e)
+                                                    FlarkFloat4::broadcast(40.0f)));
+        const FlarkFloat4 one = FlarkFloat4::broadcast(1.0f);
+
+        return (one - FlarkFloat4::broadcast(2.0f) / (e + one)).withSignOf(x);
+    }
+
+    //==============================================================================
+    // One value, through lane 0
+    inline float exp2(float x)   { return exp2(FlarkFloat4::broadcast(x)).get0(); }
+    inline float pow10(float x)  { return pow10(FlarkFloat4::broadcast(x)).get0(); }
+    inline float sin2pi(float x) { return sin2pi(FlarkFloat4::broadcast(x)).get0(); }
+    inline float cos2pi(float x) { return cos2pi(FlarkFloat4::broadcast(x)).get0(); }
+    inline float tanPi(float x)  { return tanPi(FlarkFloat4::broadcast(x)).get0(); }
+    inline float tanh(float x)   { return tanh(FlarkFloat4::broadcast(x)).get0(); }
+}
@@ -0,0 +1,120 @@
+#include <juce_core/juce_core.h>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include "FlarkDJFastMath.h"
+
+/**
+ * FlarkDJFastMathTests - accuracy checks for FlarkDJFastMath.h
+ *
+ * Sweeps every approximation densely over its documented range, compares it
+ * with double-precision libm and fails if the worst error exceeds the bound
+ * documented in the header. Also checks that the four-lane and one-value
+ * versions agree bit for bit.
+ *
+ *   FlarkDJFastMathTests [--verbose]
+ */
+
+namespace
+{
+    struct Case
+    {
+        const char* name;
+        std::function<FlarkFloat4(FlarkFloat4)> vector;
+        std::function<float(float)> scalar;
+        std::function<double(double)> reference;
+        double low, high;
+        bool relative;
+        double maxError;
+    };
+
+    std::vector<Case> makeCases()
+    {
+        using namespace FlarkFastMath;
+        const double pi = juce::MathConstants<double>::pi;
+
+        return {
+            { "sin2pi", [](FlarkFloat4 x) { return sin2pi(x); }, [](float x) { return sin2pi(x); },
+              [pi](double x) { return std::sin(2.0 * pi * x); }, -4.0, 4.0, false, 3.0e-7 },
+            { "sin2pi/large", [](FlarkFloat4 x) { return sin2pi(x); }, [](float x) { return sin2pi(x); },
+              [pi](double x) { return std::sin(2.0 * pi * (x - std::nearbyint(x))); }, -1048576.0, 1048576.0, false, 3.0e-7 },
+            { "cos2pi", [](FlarkFloat4 x) { return cos2pi(x); }, [](float x) { return cos2pi(x); },
+              [pi](double x) { return std::cos(2.0 * pi * x); }, -4.0, 4.0, false, 3.0e-7 },
+            { "tanPi", [](FlarkFloat4 x) { return tanPi(x); }, [](float x) { return tanPi(x); },
+              [pi](double x) { return std::tan(pi * x); }, 0.0, 0.45, true, 1.0e-6 },
+            { "tanh", [](FlarkFloat4 x) { return tanh(x); }, [](float x) { return tanh(x); },
+              [](double x) { return std::tanh(x); }, -20.0, 20.0, false, 2.0e-7 },
+            { "exp2", [](FlarkFloat4 x) { return exp2(x); }, [](float x) { return exp2(x); },
+              [](double x) { return std::exp2(x); }, -126.0, 127.0, true, 3.0e-7 },
+            { "pow10", [](FlarkFloat4 x) { return pow10(x); }, [](float x) { return pow10(x); },
+              [](double x) { return std::pow(10.0, x); }, -37.0, 38.0, true, 5.0e-6 },
+            { "pow10/unit", [](FlarkFloat4 x) { return pow10(x); }, [](float x) { return pow10(x); },
+              [](double x) { return std::pow(10.0, x); }, -1.0, 1.0, true, 4.0e-7 },
+        };
+    }
+
+    // Returns false if the case fails
+    bool run(const Case& c, bool verbose)
+    {
+        constexpr int numPoints = 1 << 22;
+
+        double worstError = 0.0, worstInput = 0.0;
+        int numMismatches = 0;
+
+        for (int i = 0; i < numPoints; i += 4)
+        {
+            float x[4], y[4];
+            for (int lane = 0; lane < 4; ++lane)
+                x[lane] = static_cast<float>(c.low + (c.high - c.low) * (i + lane) / (numPoints - 1));
+
+            c.vector(FlarkFloat4::load(x)).store(y);
+
+            for (int lane = 0; lane < 4; ++lane)
+            {
+                if (c.scalar(x[lane]) != y[lane])
+                    ++numMismatches;
+
+                const double exact = c.reference(x[lane]);
+                double error = std::abs(y[lane] - exact);
+                if (c.relative)
+                    error /= std::abs(exact);
+
+                if (error > worstError)
+                {
+                    worstError = error;
+                    worstInput = x[lane];
+                }
+            }
+        }
+
+        const bool passed = worstError <= c.maxError && numMismatches == 0;
+
+        if (verbose || ! passed)
+        {
+            std::cout << (passed ? "ok    " : "FAIL  ") << c.name << ": max " << (c.relative ? "relative" : "absolute")
+                      << " error " << worstError << " at x = " << worstInput << " (bound " << c.maxError << ")";
+            if (numMismatches > 0)
+                std::cout << ", " << numMismatches << " scalar/vector mismatches";
+            std::cout << std::endl;
+        }
+
+        return passed;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ArgumentList args(argc, argv);
+    const bool verbose = args.containsOption("--verbose|-v");
+
+    int numFailed = 0;
+    const auto cases = makeCases();
+
+    for (const auto& c : cases)
+        if (! run(c, verbose))
+            ++numFailed;
+
+    std::cout << (cases.size() - static_cast<size_t>(numFailed)) << "/" << cases.size() << " fast-math cases passed"
+              << std::endl;
+    return numFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,369 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include "FlarkDJDSP.h"
+
+/**
+ * FlarkDJ golden-output cases
+ *
+ * The fixed stimuli and the DSP kernel cases checked by FlarkDJGoldenTests.
+ * Only FlarkDJDSP.h is needed here, so kernel references can be rendered
+ * without the rest of the plugin. Stimuli use their own generator rather
+ * than juce::Random so they never change under us.
+ */
+namespace FlarkGolden
+{
+    constexpr float sampleRate = 44100.0f;
+    constexpr int stimulusLength = 4096;
+
+    // How closely a case must match its reference
+    enum class Tolerance
+    {
+        Exact,       // plain arithmetic: bit-exact
+        Vectorised,  // SIMD lanes or libm transcendentals: rounding only
+        Approximate  // fast approximations of transcendentals
+    };
+
+    inline float getMaxError(Tolerance tolerance)
+    {
+        switch (tolerance)
+        {
+            case Tolerance::Exact:       return 0.0f;
+            case Tolerance::Vectorised:  return 1.0e-5f; // -100 dBFS
+            case Tolerance::Approximate: return 1.0e-3f; // -60 dBFS
+        }
+
+        return 0.0f;
+    }
+
+    //==============================================================================
+    // Stimuli
+    using Signal = std::vector<float>;
+
+    // Uniform noise in [-amplitude, amplitude] from a fixed LCG
+    inline Signal makeNoise(int length, float amplitude, unsigned seed)
+    {
+        Signal signal(static_cast<size_t>(length));
+        for (auto& s : signal)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            s = (static_cast<float>(seed >> 8) / 8388608.0f - 1.0f) * amplitude;
+        }
+        return signal;
+    }
+
+    struct Stimulus
+    {
+        std::string name;
+        Signal signal;
+    };
+
+    inline std::vector<Stimulus> makeStimuli()
+    {
+        std::vector<Stimulus> stimuli;
+
+        Signal impulse(stimulusLength, 0.0f);
+        impulse[0] = 1.0f;
+        stimuli.push_back({ "impulse", impulse });
+
+        // Exponential sine sweep, 20 Hz to 20 kHz at -6 dBFS
+        Signal sweep(stimulusLength);
+        const double duration = stimulusLength / static_cast<double>(sampleRate);
+        const double sweepRate = std::log(20000.0 / 20.0);
+        for (int i = 0; i < stimulusLength; ++i)
+        {
+            const double t = i / static_cast<double>(sampleRate);
+            const double phase = 2.0 * 3.141592653589793 * 20.0 * duration / sweepRate
+                               * (std::exp(t / duration * sweepRate) - 1.0);
+            sweep[static_cast<size_t>(i)] = static_cast<float>(0.5 * std::sin(phase));
+        }
+        stimuli.push_back({ "sweep", sweep });
+
+        stimuli.push_back({ "noise", makeNoise(stimulusLength, 0.5f, 1) });
+
+        // Silence, then a loud burst: tests wake-up from an idle state
+        Signal burst(stimulusLength / 2, 0.0f);
+        auto loud = makeNoise(stimulusLength / 2, 0.9f, 2);
+        burst.insert(burst.end(), loud.begin(), loud.end());
+        stimuli.push_back({ "burst", burst });
+
+        return stimuli;
+    }
+
+    //==============================================================================
+    // DSP kernel cases. Each renders one stimulus into one or more output channels.
+    struct KernelCase
+    {
+        std::string name;
+        Tolerance tolerance;
+        bool usesInput; // false: rendered once, not per stimulus
+        std::function<std::vector<Signal>(const Signal& input)> render;
+    };
+
+    // Runs a mono effect in place over a copy of the input
+    template <typename Effect>
+    std::vector<Signal> renderMono(Effect& effect, const Signal& input)
+    {
+        Signal output = input;
+        effect.processBlock(output.data(), static_cast<int>(output.size()));
+        return { output };
+    }
+
+    // Multichannel input: channel n is the stimulus delayed by 32n samples and
+    // inverted on odd channels, so every lane carries a different signal
+    inline Signal makeChannel(const Signal& input, int channel)
+    {
+        const size_t offset = static_cast<size_t>(32 * channel);
+        const float sign = channel % 2 == 0 ? 1.0f : -1.0f;
+
+        Signal output(input.size(), 0.0f);
+        for (size_t i = offset; i < input.size(); ++i)
+            output[i] = sign * input[i - offset];
+        return output;
+    }
+
+    // Stereo input: the stimulus on the left, inverted on the right with a
+    // 32-sample offset
+    inline Signal makeRightChannel(const Signal& input)
+    {
+        return makeChannel(input, 1);
+    }
+
+    inline std::vector<KernelCase> makeKernelCases()
+    {
+        std::vector<KernelCase> cases;
+
+        const std::pair<const char*, FlarkLFO::Waveform> waveforms[] = {
+            { "sine", FlarkLFO::Sine }, { "square", FlarkLFO::Square },
+            { "triangle", FlarkLFO::Triangle }, { "sawtooth", FlarkLFO::Sawtooth }
+        };
+
+        for (auto& [name, waveform] : waveforms)
+        {
+            // The sine is FlarkFastMath::sin2pi
+            const auto tolerance = waveform == FlarkLFO::Sine ? Tolerance::Approximate : Tolerance::Exact;
+
+            cases.push_back({ std::string("lfo_") + name, tolerance, false, [waveform = waveform](const Signal&)
+            {
+                FlarkLFO lfo;
+                lfo.setSampleRate(sampleRate);
+                lfo.setWaveform(waveform);
+                lfo.setRate(40.0f); // several cycles within the render
+                Signal output(stimulusLength);
+                lfo.processBlock(output.data(), stimulusLength);
+                return std::vector<Signal> { output };
+            }});
+        }
+
+        const std::pair<const char*, FlarkButterworthFilter::FilterType> filterTypes[] = {
+            { "lowpass", FlarkButterworthFilter::Lowpass }, { "highpass", FlarkButterworthFilter::Highpass },
+            { "bandpass", FlarkButterworthFilter::Bandpass }
+        };
+
+        for (auto& [name, type] : filterTypes)
+        {
+            cases.push_back({ std::string("butterworth_") + name, Tolerance::Vectorised, true, [type = type](const Signal& input)
+            {
+                FlarkButterworthFilter filter;
+                filter.setSampleRate(sampleRate);
+                filter.setType(type);
+                filter.setCutoff(1000.0f);
+                filter.setResonance(2.0f);
+                return renderMono(filter, input);
+            }});
+        }
+
+        cases.push_back({ "butterworth_modulated", Tolerance::Approximate, true, [](const Signal& input)
+        {
+            // Cutoff ramped every 32 samples, as the processor does under LFO
+            // modulation. The sweep crosses the resonance, where the output
+            // runs 20 dB over full scale and magnifies coefficient rounding.
+            FlarkButterworthFilter filter;
+            filter.setSampleRate(sampleRate);
+            filter.setCutoff(200.0f);
+            filter.setResonance(3.0f);
+
+            Signal output = input;
+            for (int i = 0; i < stimulusLength; i += 32)
+            {
+                filter.setCutoffSmoothed(200.0f * std::pow(2.0f, 6.0f * i / stimulusLength), 32);
+                filter.processBlock(output.data() + i, 32);
+            }
+            return std::vector<Signal> { output };
+        }});
+
+        cases.push_back({ "stereo_butterworth", Tolerance::Vectorised, true, [](const Signal& input)
+        {
+            FlarkMultichannelButterworthFilter filter;
+            filter.setSampleRate(sampleRate);
+            filter.setParameters(FlarkButterworthFilter::Lowpass, 2000.0f, 1.5f);
+
+            Signal left = input, right = makeRightChannel(input);
+            filter.processBlock(left.data(), right.data(), stimulusLength);
+            return std::vector<Signal> { left, right };
+        }});
+
+        cases.push_back({ "stereo_svf", Tolerance::Vectorised, true, [](const Signal& input)
+        {
+            // Same settings as stereo_butterworth, which it should match closely
+            FlarkMultichannelSVF filter;
+            filter.setSampleRate(sampleRate);
+            filter.setParameters(FlarkButterworthFilter::Lowpass, 2000.0f, 1.5f);
+
+            Signal left = input, right = makeRightChannel(input);
+            filter.processBlock(left.data(), right.data(), stimulusLength);
+            return std::vector<Signal> { left, right };
+        }});
+
+        cases.push_back({ "stereo_svf_modulated", Tolerance::Vectorised, true, [](const Signal& input)
+        {
+            // A new cutoff every sample: a deep 40 Hz wobble on a rising sweep
+            FlarkMultichannelSVF filter;
+            filter.setSampleRate(sampleRate);
+            filter.setParameters(FlarkButterworthFilter::Lowpass, 200.0f, 3.0f);
+
+            Signal cutoff(stimulusLength);
+            for (int i = 0; i < stimulusLength; ++i)
+                cutoff[static_cast<size_t>(i)] = 200.0f * std::pow(2.0f, 6.0f * i / stimulusLength)
+                                               * (1.0f + 0.9f * FlarkFastMath::sin2pi(40.0f * i / sampleRate));
+
+            Signal left = input, right = makeRightChannel(input);
+            filter.processBlockModulated(left.data(), right.data(), cutoff.data(), stimulusLength);
+            return std::vector<Signal> { left, right };
+        }});
+
+        cases.push_back({ "delay", Tolerance::Exact, true, [](const Signal& input)
+        {
+            FlarkDelay delay;
+            delay.setSampleRate(sampleRate);
+            delay.setDelayTime(0.02f); // several echoes within the render
+            delay.setFeedback(0.6f);
+            delay.setWetDryMix(0.5f);
+            return renderMono(delay, input);
+        }});
+
+        cases.push_back({ "reverb", Tolerance::Vectorised, true, [](const Signal& input)
+        {
+            FlarkReverb reverb;
+            reverb.setSampleRate(sampleRate);
+            reverb.setRoomSize(0.8f);
+            reverb.setDamping(0.4f);
+            reverb.setWetDryMix(0.5f);
+            return renderMono(reverb, input);
+        }});
+
+        cases.push_back({ "flanger", Tolerance::Approximate, true, [](const Signal& input)
+        {
+            // Fast sine sweep
+            FlarkFlanger flanger;
+            flanger.setSampleRate(sampleRate);
+            flanger.setRate(5.0f);
+            flanger.setDepth(0.8f);
+            flanger.setFeedback(0.7f);
+            flanger.setWetDryMix(0.5f);
+            return renderMono(flanger, input);
+        }});
+
+        for (const float position : { -0.6f, 0.6f })
+        {
+            const std::string name = position < 0.0f ? "isolator_low" : "isolator_high";
+
+            cases.push_back({ name, Tolerance::Vectorised, true, [position](const Signal& input)
+            {
+                FlarkIsolator isolator;
+                isolator.setSampleRate(sampleRate);
+                isolator.setPosition(position);
+                isolator.setQ(3.0f);
+                return renderMono(isolator, input);
+            }});
+        }
+
+        cases.push_back({ "stereo_isolator", Tolerance::Approximate, true, [](const Signal& input)
+        {
+            // Cutoff from FlarkFastMath::pow10, through a resonance that runs
+            // 11 dB over full scale
+            FlarkMultichannelIsolator isolator;
+            isolator.setSampleRate(sampleRate);
+            isolator.setPosition(-0.4f);
+            isolator.setQ(3.0f);
+
+            Signal left = input, right = makeRightChannel(input);
+            isolator.processBlock(left.data(), right.data(), stimulusLength);
+            return std::vector<Signal> { left, right };
+        }});
+
+        cases.push_back({ "stereo_isolator_svf", Tolerance::Vectorised, true, [](const Signal& input)
+        {
+            // The position moves halfway through, so the cutoff glides
+            FlarkMultichannelIsolator isolator;
+            isolator.setSampleRate(sampleRate);
+            isolator.setTopology(FlarkMultichannelIsolator::StateVariable);
+            isolator.setPosition(-0.4f);
+            isolator.setQ(3.0f);
+
+            Signal left = input, right = makeRightChannel(input);
+            const int half = stimulusLength / 2;
+            isolator.processBlock(left.data(), right.data(), half);
+            isolator.setPosition(-0.7f);
+            isolator.processBlock(left.data() + half, right.data() + half, stimulusLength - half);
+            return std::vector<Signal> { left, right };
+        }});
+
+        cases.push_back({ "three_band_isolator", Tolerance::Vectorised, true, [](const Signal& input)
+        {
+            // Low killed and mid cut, then the low comes back halfway through
+            // and the gains glide
+            FlarkThreeBandIsolator isolator;
+            isolator.setSampleRate(sampleRate);
+            isolator.setGains(0.0f, 0.5f, 1.0f);
+            isolator.reset();
+
+            Signal left = input, right = makeRightChannel(input);
+            const int half = stimulusLength / 2;
+            isolator.processBlock(left.data(), right.data(), half);
+            isolator.setGains(1.0f, 0.5f, 0.0f);
+            isolator.processBlock(left.data() + half, right.data() + half, stimulusLength - half);
+            return std::vector<Signal> { left, right };
+        }});
+
+        cases.push_back({ "limiter", Tolerance::Approximate, true, [](const Signal& input)
+        {
+            // Driven 12 dB hot so the input reaches deep saturation of the
+            // fast tanh
+            FlarkSoftLimiter limiter;
+            Signal output = input;
+            for (auto& s : output)
+                s *= 4.0f;
+            limiter.processBlock(output.data(), stimulusLength);
+            return std::vector<Signal> { output };
+        }});
+
+        for (const bool truePeak : { false, true })
+        {
+            const std::string name = truePeak ? "lookahead_limiter_truepeak" : "lookahead_limiter";
+
+            cases.push_back({ name, Tolerance::Vectorised, true, [truePeak](const Signal& input)
+            {
+                // Driven 12 dB hot, like the soft limiter
+                FlarkLookaheadLimiter limiter;
+                limiter.setSampleRate(sampleRate);
+                limiter.setLookahead(2.0f);
+                limiter.setReleaseTime(50.0f);
+                limiter.setTruePeakEnabled(truePeak);
+
+                Signal left = input, right = makeRightChannel(input);
+                for (size_t i = 0; i < left.size(); ++i)
+                {
+                    left[i] *= 4.0f;
+                    right[i] *= 4.0f;
+                }
+
+                limiter.processBlock(left.data(), right.data(), stimulusLength);
+                return std::vector<Signal> { left, right };
+            }});
+        }
+
+        return cases;
+    }
+}
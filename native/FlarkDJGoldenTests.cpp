@@ -0,0 +1,458 @@
+#include <iostream>
+#include <limits>
+#include "FlarkDJGoldenCases.h"
+#include "FlarkDJProcessor.h"
+
+/**
+ * FlarkDJGoldenTests - golden-output regression tests
+ *
+ * Renders the fixed stimuli in FlarkDJGoldenCases.h through each DSP kernel
+ * and, for a set of parameter presets, through the whole processor chain.
+ * Each output is compared with a stored reference WAV (32-bit float) in
+ * native/golden. A case fails if any sample differs from its reference by
+ * more than the case's tolerance. The mono group instead compares the
+ * processor's mono fast path with the same input processed on every channel,
+ * the meter group checks the loudness meter's channel weighting, and the
+ * state group checks that saved sessions restore their limiter mode.
+ *
+ *   FlarkDJGoldenTests [--group dsp|chain|mono|meter|state] [--filter <name>] [--exact]
+ *                      [--reference-dir <dir>] [--update]
+ *
+ * --exact requires every case to be bit-exact, for checking a restructured
+ * scalar path. --update records new references; only use it after a change
+ * that is meant to alter the sound, and listen to the result first.
+ */
+
+namespace
+{
+    using FlarkGolden::Signal;
+
+    //==============================================================================
+    // Full-chain cases: parameter values (not normalised) on top of the defaults
+    struct ChainPreset
+    {
+        std::string name;
+        std::vector<std::pair<const char*, float>> values;
+    };
+
+    const std::vector<ChainPreset>& getChainPresets()
+    {
+        // Each pins the "Soft Clip" limiter, the output stage the references
+        // were recorded with
+        static const std::vector<ChainPreset> presets = {
+            { "default", { { "limiterMode", 0.0f } } },
+            { "everything", { { "limiterMode", 0.0f }, { "filterCutoff", 2000.0f }, { "reverbEnabled", 1.0f },
+                              { "delayEnabled", 1.0f }, { "delayTime", 0.03f }, { "flangerEnabled", 1.0f },
+                              { "isolatorEnabled", 1.0f }, { "isolatorPosition", -0.5f } } },
+            { "echo_flange", { { "limiterMode", 0.0f }, { "filterEnabled", 0.0f }, { "delayEnabled", 1.0f },
+                               { "delayTime", 0.05f }, { "delayFeedback", 0.7f }, { "flangerEnabled", 1.0f },
+                               { "flangerRate", 3.0f } } },
+            { "sweep_isolator", { { "limiterMode", 0.0f }, { "filterType", 2.0f }, { "lfoDepth", 0.8f },
+                                  { "lfoRate", 8.0f }, { "lfoWaveform", 2.0f }, { "reverbEnabled", 1.0f },
+                                  { "isolatorEnabled", 1.0f }, { "isolatorPosition", 0.7f } } }
+        };
+
+        return presets;
+    }
+
+    // Renders one input channel per output channel through the processor, on
+    // the matching layout, in blocks of 256
+    std::vector<Signal> renderProcessor(const ChainPreset& preset, std::vector<Signal> channels,
+                                        bool monoFastPath = true, juce::int64* numMonoBlocks = nullptr)
+    {
+        constexpr int blockSize = 256;
+        const int numChannels = static_cast<int>(channels.size());
+        const int length = static_cast<int>(channels[0].size());
+
+        FlarkDJProcessor processor;
+        auto& parameters = processor.getParameters();
+
+        for (auto& [id, value] : preset.values)
+            if (auto* param = parameters.getParameter(id))
+                param->setValueNotifyingHost(param->convertTo0to1(value));
+
+        if (numChannels != 2)
+        {
+            juce::AudioProcessor::BusesLayout layout;
+            layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+            layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+            processor.setBusesLayout(layout);
+        }
+
+        processor.setMonoFastPathEnabled(monoFastPath);
+        processor.setRateAndBufferSizeDetails(FlarkGolden::sampleRate, blockSize);
+        processor.prepareToPlay(FlarkGolden::sampleRate, blockSize);
+
+        juce::MidiBuffer midi;
+
+        for (int start = 0; start < length; start += blockSize)
+        {
+            float* pointers[FlarkChannelGroup::maxChannels];
+            for (int ch = 0; ch < numChannels; ++ch)
+                pointers[ch] = channels[static_cast<size_t>(ch)].data() + start;
+
+            juce::AudioBuffer<float> block(pointers, numChannels, juce::jmin(blockSize, length - start));
+            processor.processBlock(block, midi);
+        }
+
+        if (numMonoBlocks != nullptr)
+            *numMonoBlocks = processor.getNumMonoBlocks();
+
+        processor.releaseResources();
+        return channels;
+    }
+
+    std::vector<Signal> renderChain(const ChainPreset& preset, const Signal& input, int numChannels = 2)
+    {
+        std::vector<Signal> channels;
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels.push_back(FlarkGolden::makeChannel(input, ch));
+
+        return renderProcessor(preset, channels);
+    }
+
+    // 5.1 and 7.1: every effect and the default lookahead limiter over two
+    // channel groups
+    const ChainPreset surroundPreset { "surround", { { "filterCutoff", 2000.0f }, { "reverbEnabled", 1.0f },
+                                                     { "delayEnabled", 1.0f }, { "delayTime", 0.03f },
+                                                     { "flangerEnabled", 1.0f }, { "isolatorEnabled", 1.0f },
+                                                     { "isolatorPosition", -0.5f } } };
+
+    //==============================================================================
+    // Loudness of a -23 dBFS 997 Hz sine in some channels of a layout. One
+    // channel reads 3 LU under the stereo pair, plus 10 log10 of its BS.1770
+    // weight; the LFE does not count.
+    struct LoudnessCase
+    {
+        std::string name;
+        int numChannels;
+        std::vector<int> signalChannels;
+        float expectedLufs;
+    };
+
+    std::vector<LoudnessCase> getLoudnessCases()
+    {
+        return {
+            { "mono",               1, { 0 },    -26.0f },
+            { "stereo",             2, { 0, 1 }, -23.0f },
+            { "5_1_centre",         6, { 2 },    -26.0f },
+            { "5_1_lfe",            6, { 3 },    FlarkDJMeter::floorLufs },
+            { "5_1_left_surround",  6, { 4 },    -24.5f },
+            { "7_1_rear_surround",  8, { 6 },    -26.0f }
+        };
+    }
+
+    float measureIntegratedLoudness(const LoudnessCase& loudnessCase)
+    {
+        const int length = juce::roundToInt(FlarkGolden::sampleRate * 5.0f);
+        const double amplitude = std::pow(10.0, -23.0 / 20.0);
+
+        std::vector<Signal> channels(static_cast<size_t>(loudnessCase.numChannels), Signal(static_cast<size_t>(length), 0.0f));
+        for (int ch : loudnessCase.signalChannels)
+            for (int i = 0; i < length; ++i)
+                channels[static_cast<size_t>(ch)][static_cast<size_t>(i)]
+                    = static_cast<float>(amplitude * std::sin(2.0 * 3.141592653589793 * 997.0 * i / FlarkGolden::sampleRate));
+
+        std::vector<const float*> pointers;
+        for (auto& channel : channels)
+            pointers.push_back(channel.data());
+
+        FlarkDJMeter meter;
+        meter.prepare(FlarkGolden::sampleRate, loudnessCase.numChannels);
+
+        for (int i = 0; i < length; ++i)
+            meter.process(pointers.data(), i);
+
+        return meter.publish().integratedLufs;
+    }
+
+    //==============================================================================
+    // Mono fast path: six channels that are dual mono, then stereo, then mono
+    // again. The last part is long enough for the stereo tails to die away,
+    // so the processor goes back to mono.
+    std::vector<Signal> makeMonoStereoMonoInput()
+    {
+        constexpr int numChannels = 6;
+        const int segmentLength = juce::roundToInt(FlarkGolden::sampleRate * 0.3f);
+
+        const auto first = FlarkGolden::makeNoise(segmentLength, 0.5f, 3);
+        const auto left = FlarkGolden::makeNoise(segmentLength, 0.5f, 4);
+        const auto right = FlarkGolden::makeRightChannel(left);
+        const auto last = FlarkGolden::makeNoise(segmentLength * 4, 0.5f, 5);
+
+        std::vector<Signal> channels(numChannels);
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto& channel = channels[static_cast<size_t>(ch)];
+            const auto& middle = ch % 2 == 0 ? left : right;
+            channel.insert(channel.end(), first.begin(), first.end());
+            channel.insert(channel.end(), middle.begin(), middle.end());
+            channel.insert(channel.end(), last.begin(), last.end());
+        }
+
+        return channels;
+    }
+
+    const ChainPreset monoPreset { "mono", { { "limiterMode", 0.0f }, { "filterEnabled", 0.0f },
+                                             { "reverbEnabled", 1.0f }, { "delayEnabled", 1.0f },
+                                             { "delayTime", 0.05f }, { "flangerEnabled", 1.0f } } };
+
+    //==============================================================================
+    // Saved state: a processor's state with limiterMode set to the given mode,
+    // or with its limiterMode parameter removed, as in sessions saved before
+    // the limiter modes existed. Returns the mode a new processor restores.
+    float restoreLimiterMode(int savedMode, bool removeLimiterMode)
+    {
+        juce::MemoryBlock data;
+
+        {
+            FlarkDJProcessor saved;
+            auto* param = saved.getParameters().getParameter("limiterMode");
+            param->setValueNotifyingHost(param->convertTo0to1(static_cast<float>(savedMode)));
+            saved.getStateInformation(data);
+        }
+
+        if (removeLimiterMode)
+        {
+            auto xml = juce::AudioProcessor::getXmlFromBinary(data.getData(), static_cast<int>(data.getSize()));
+            if (auto* child = xml->getChildByAttribute("id", "limiterMode"))
+                xml->removeChildElement(child, true);
+
+            juce::AudioProcessor::copyXmlToBinary(*xml, data);
+        }
+
+        FlarkDJProcessor restored;
+        restored.setStateInformation(data.getData(), static_cast<int>(data.getSize()));
+        return restored.getParameters().getRawParameterValue("limiterMode")->load();
+    }
+
+    //==============================================================================
+    bool writeReference(const juce::File& file, const std::vector<Signal>& channels)
+    {
+        file.getParentDirectory().createDirectory();
+        file.deleteFile();
+
+        std::unique_ptr<juce::OutputStream> stream(file.createOutputStream());
+        if (stream == nullptr)
+            return false;
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), FlarkGolden::sampleRate,
+                                                                            static_cast<unsigned int>(channels.size()),
+                                                                            32, {}, 0));
+        if (writer == nullptr)
+            return false;
+
+        stream.release(); // now owned by the writer
+
+        std::vector<const float*> pointers;
+        for (auto& channel : channels)
+            pointers.push_back(channel.data());
+
+        return writer->writeFromFloatArrays(pointers.data(), static_cast<int>(pointers.size()),
+                                            static_cast<int>(channels[0].size()));
+    }
+
+    bool readReference(const juce::File& file, std::vector<Signal>& channels)
+    {
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatReader> reader(wav.createReaderFor(file.createInputStream().release(), true));
+
+        if (reader == nullptr)
+            return false;
+
+        juce::AudioBuffer<float> buffer(static_cast<int>(reader->numChannels), static_cast<int>(reader->lengthInSamples));
+        reader->read(&buffer, 0, buffer.getNumSamples(), 0, true, true);
+
+        channels.clear();
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            channels.emplace_back(buffer.getReadPointer(ch), buffer.getReadPointer(ch) + buffer.getNumSamples());
+
+        return true;
+    }
+
+    //==============================================================================
+    struct Runner
+    {
+        juce::File referenceDir;
+        juce::String filter;
+        bool update = false;
+        bool exact = false;
+        int numPassed = 0;
+        int numFailed = 0;
+
+        void check(const std::string& name, FlarkGolden::Tolerance tolerance, const std::vector<Signal>& output)
+        {
+            if (filter.isNotEmpty() && ! juce::String(name).contains(filter))
+                return;
+
+            const auto file = referenceDir.getChildFile(juce::String(name) + ".wav");
+
+            if (update)
+            {
+                if (writeReference(file, output))
+                    std::cout << "RECORDED " << name << std::endl;
+                else
+                    fail(name, "cannot write " + file.getFullPathName());
+                return;
+            }
+
+            std::vector<Signal> reference;
+            if (! readReference(file, reference))
+            {
+                fail(name, "no reference at " + file.getFullPathName() + " (record with --update)");
+                return;
+            }
+
+            compare(name, tolerance, output, reference);
+        }
+
+        void checkValue(const std::string& name, float value, float expected, float tolerance)
+        {
+            if (filter.isNotEmpty() && ! juce::String(name).contains(filter))
+                return;
+
+            if (! (std::abs(value - expected) <= tolerance))
+            {
+                fail(name, "got " + juce::String(value, 2) + ", expected " + juce::String(expected, 2));
+                return;
+            }
+
+            ++numPassed;
+            std::cout << "PASS " << name << " (" << juce::String(value, 2) << ")" << std::endl;
+        }
+
+        // Compares two renders with each other rather than with a stored reference
+        void compare(const std::string& name, FlarkGolden::Tolerance tolerance,
+                     const std::vector<Signal>& output, const std::vector<Signal>& reference)
+        {
+            if (filter.isNotEmpty() && ! juce::String(name).contains(filter))
+                return;
+
+            if (reference.size() != output.size() || reference[0].size() != output[0].size())
+            {
+                fail(name, "reference has a different channel count or length");
+                return;
+            }
+
+            const float maxError = exact ? 0.0f : FlarkGolden::getMaxError(tolerance);
+            float worstError = 0.0f;
+            size_t worstIndex = 0;
+
+            for (size_t ch = 0; ch < output.size(); ++ch)
+            {
+                for (size_t i = 0; i < output[ch].size(); ++i)
+                {
+                    const float error = std::abs(output[ch][i] - reference[ch][i]);
+
+                    // NaN compares false, so test it explicitly
+                    if (std::isnan(output[ch][i]) || error > worstError)
+                    {
+                        worstError = std::isnan(output[ch][i]) ? std::numeric_limits<float>::infinity() : error;
+                        worstIndex = i;
+                    }
+                }
+            }
+
+            if (worstError > maxError)
+            {
+                fail(name, "max error " + juce::String(worstError, 9) + " at sample " + juce::String(static_cast<int>(worstIndex))
+                           + " (tolerance " + juce::String(maxError, 9) + ")");
+                return;
+            }
+
+            ++numPassed;
+            std::cout << "PASS " << name << " (max error " << juce::String(worstError, 9) << ")" << std::endl;
+        }
+
+        void fail(const std::string& name, const juce::String& reason)
+        {
+            ++numFailed;
+            std::cout << "FAIL " << name << ": " << reason << std::endl;
+        }
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    // The processor's parameter tree expects JUCE's message manager to exist
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ArgumentList args(argc, argv);
+
+    Runner runner;
+    runner.referenceDir = juce::File(FLARKDJ_GOLDEN_DIR);
+    runner.filter = args.getValueForOption("--filter");
+    runner.update = args.containsOption("--update");
+    runner.exact = args.containsOption("--exact");
+
+    if (args.containsOption("--reference-dir"))
+        runner.referenceDir = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--reference-dir"));
+
+    const auto group = args.getValueForOption("--group");
+    const auto stimuli = FlarkGolden::makeStimuli();
+
+    if (group.isEmpty() || group == "dsp")
+    {
+        for (auto& kernelCase : FlarkGolden::makeKernelCases())
+        {
+            if (! kernelCase.usesInput)
+            {
+                runner.check("dsp_" + kernelCase.name, kernelCase.tolerance, kernelCase.render({}));
+                continue;
+            }
+
+            for (auto& stimulus : stimuli)
+                runner.check("dsp_" + kernelCase.name + "_" + stimulus.name, kernelCase.tolerance,
+                             kernelCase.render(stimulus.signal));
+        }
+    }
+
+    if (group.isEmpty() || group == "chain")
+    {
+        for (auto& preset : getChainPresets())
+            for (auto& stimulus : stimuli)
+                runner.check("chain_" + preset.name + "_" + stimulus.name, FlarkGolden::Tolerance::Approximate,
+                             renderChain(preset, stimulus.signal));
+
+        for (auto& [layout, numChannels] : { std::pair<std::string, int> { "5_1", 6 }, { "7_1", 8 } })
+            for (auto& stimulus : stimuli)
+                runner.check("chain_surround_" + layout + "_" + stimulus.name, FlarkGolden::Tolerance::Approximate,
+                             renderChain(surroundPreset, stimulus.signal, numChannels));
+    }
+
+    if ((group.isEmpty() || group == "meter") && ! runner.update)
+    {
+        for (auto& loudnessCase : getLoudnessCases())
+            runner.checkValue("meter_" + loudnessCase.name, measureIntegratedLoudness(loudnessCase),
+                              loudnessCase.expectedLufs, 0.1f);
+    }
+
+    if ((group.isEmpty() || group == "mono") && ! runner.update)
+    {
+        // The mono path must sound the same as processing every channel,
+        // including the hand-over when the input stops and starts being mono.
+        // Channels within the detector's -100 dB count as matching, hence
+        // the Vectorised tolerance.
+        const auto input = makeMonoStereoMonoInput();
+        juce::int64 numMonoBlocks = 0;
+        const auto withMono = renderProcessor(monoPreset, input, true, &numMonoBlocks);
+        const auto withoutMono = renderProcessor(monoPreset, input, false);
+
+        if (numMonoBlocks == 0)
+            runner.fail("mono_fast_path", "the mono path never engaged");
+        else
+            runner.compare("mono_fast_path", FlarkGolden::Tolerance::Vectorised, withMono, withoutMono);
+    }
+
+    if ((group.isEmpty() || group == "state") && ! runner.update)
+    {
+        runner.checkValue("state_limiter_mode_saved", restoreLimiterMode(FlarkDJProcessor::LimiterTruePeak, false),
+                          static_cast<float>(FlarkDJProcessor::LimiterTruePeak), 0.0f);
+        runner.checkValue("state_limiter_mode_missing", restoreLimiterMode(FlarkDJProcessor::LimiterTruePeak, true),
+                          static_cast<float>(FlarkDJProcessor::LimiterSoftClip), 0.0f);
+    }
+
+    std::cout << runner.numPassed << " passed, " << runner.numFailed << " failed" << std::endl;
+    return runner.numFailed == 0 ? 0 : 1;
+}
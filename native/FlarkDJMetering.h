@@ -0,0 +1,400 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include "FlarkDJDSP.h"
+#include "FlarkDJPerformance.h"
+
+/**
+ * FlarkDJ Output Metering
+ *
+ * Sample peak, RMS and 4x oversampled true peak of the front pair, plus
+ * K-weighted momentary, short-term and gated integrated loudness (ITU-R
+ * BS.1770 / EBU R128), measured one sample at a time inside the processor's
+ * last stage so the output is only walked once.
+ *
+ * Loudness sums every channel of the layout with the BS.1770 channel weights:
+ * 1.0 for left, right and centre, 1.41 for the side surrounds and 0 for the
+ * LFE. Mono is measured as its one channel, not as a dual-mono pair.
+ *
+ * Windowed values are kept as running sums over 10 ms sub-blocks, so each
+ * window slides by adding the newest sub-block and subtracting the oldest;
+ * nothing is rescanned per block. Integrated loudness is gated from a 0.1 LU
+ * histogram of the 400 ms gating blocks, so its memory stays constant however
+ * long the session runs.
+ *
+ * The audio thread calls process() per sample and publish() once per block;
+ * readings can be taken from any other thread without locking it out.
+ */
+class FlarkDJMeter
+{
+public:
+    static constexpr int numChannels = 2;         // front pair, with peak and RMS readings
+    static constexpr int maxChannels = FlarkChannelGroup::maxChannels;
+    static constexpr float floorLufs = -120.0f;   // reported for silence
+
+    struct Readings
+    {
+        juce::int64 numSamples = 0;               // metered since the last reset, in 10 ms steps
+        float peak[numChannels] {};               // sample peak over the last block
+        float truePeak[numChannels] {};           // oversampled peak over the last block
+        float maxTruePeak[numChannels] {};        // since the last loudness reset
+        float rms[numChannels] {};                // over the last 300 ms
+        float momentaryLufs = floorLufs;          // 400 ms window
+        float shortTermLufs = floorLufs;          // 3 s window
+        float integratedLufs = floorLufs;         // gated, since the last loudness reset
+    };
+
+    FlarkDJMeter() { prepare(44100.0); }
+
+    //==============================================================================
+    // Host thread, while no audio is being processed. The layout is given by
+    // its channel count, in JUCE's order: mono, stereo, quad (L R Ls Rs),
+    // 5.1 (L R C LFE Ls Rs) or 7.1 (5.1, then the rear surrounds).
+    void prepare(double newSampleRate, int newNumChannels = 2)
+    {
+        sampleRate = newSampleRate;
+        samplesPerTick = juce::jmax(1, juce::roundToInt(sampleRate * tickSeconds));
+        numInputChannels = juce::jlimit(1, maxChannels, newNumChannels);
+        designKWeighting();
+        setLoudnessWeights();
+        reset();
+    }
+
+    void reset()
+    {
+        for (auto& channel : channels)
+            channel = Channel {};
+
+        for (auto& state : loudnessStates)
+        {
+            std::fill(std::begin(state.shelfState), std::end(state.shelfState), 0.0);
+            std::fill(std::begin(state.highPassState), std::end(state.highPassState), 0.0);
+        }
+
+        tickSamples = 0;
+        tickWeighted = 0.0;
+        rmsPos = 0;
+        loudnessRing.fill(0.0);
+        loudnessPos = 0;
+        momentarySum = shortTermSum = 0.0;
+        numTicks = 0;
+        numSamples = 0;
+        clearLoudnessHistory();
+        publish();
+    }
+
+    // Any thread: restarts integrated loudness and the true-peak hold at the
+    // next block
+    void resetLoudness() { loudnessResetPending.store(true); }
+
+    //==============================================================================
+    // Audio thread: sample i of every channel of the prepared layout
+    void process(const float* const* channelData, int i)
+    {
+        for (int ch = 0; ch < numMeteredChannels; ++ch)
+            processChannel(channels[static_cast<size_t>(ch)], channelData[ch][i]);
+
+        for (int k = 0; k < numLoudnessChannels; ++k)
+        {
+            auto& state = loudnessStates[static_cast<size_t>(k)];
+            const double x = channelData[state.channel][i];
+            const double weighted = highPass.process(shelf.process(x, state.shelfState), state.highPassState);
+            tickWeighted += state.weight * (weighted * weighted);
+        }
+
+        if (++tickSamples == samplesPerTick)
+            endTick();
+    }
+
+    // Audio thread, after the block's samples. Returns what was published.
+    const Readings& publish()
+    {
+        if (loudnessResetPending.exchange(false))
+            clearLoudnessHistory();
+
+        auto& readings = latest;
+        const double rmsWindow = static_cast<double>(rmsTicks * samplesPerTick);
+
+        readings.numSamples = numSamples;
+        for (int ch = 0; ch < numMeteredChannels; ++ch)
+        {
+            auto& channel = channels[static_cast<size_t>(ch)];
+            const float truePeak = juce::jmax(channel.truePeak.maxLane(), channel.peak);
+
+            channel.maxTruePeak = juce::jmax(channel.maxTruePeak, truePeak);
+            readings.peak[ch] = channel.peak;
+            readings.truePeak[ch] = truePeak;
+            readings.maxTruePeak[ch] = channel.maxTruePeak;
+            readings.rms[ch] = static_cast<float>(std::sqrt(juce::jmax(0.0, channel.rmsSum) / rmsWindow));
+
+            channel.peak = 0.0f;
+            channel.truePeak = FlarkFloat4::zero();
+        }
+
+        // Mono shows its one channel on both meters
+        for (int ch = numMeteredChannels; ch < numChannels; ++ch)
+        {
+            readings.peak[ch] = readings.peak[0];
+            readings.truePeak[ch] = readings.truePeak[0];
+            readings.maxTruePeak[ch] = readings.maxTruePeak[0];
+            readings.rms[ch] = readings.rms[0];
+        }
+
+        readings.momentaryLufs = toLufs(momentarySum / (momentaryTicks * samplesPerTick));
+        readings.shortTermLufs = toLufs(shortTermSum / (shortTermTicks * samplesPerTick));
+        readings.integratedLufs = integratedLufs;
+
+        published.getWriteBuffer() = readings;
+        published.publish();
+        return readings;
+    }
+
+    //==============================================================================
+    // Any thread, one at a time
+    Readings getReadings()
+    {
+        const juce::SpinLock::ScopedLockType lock(readLock);
+        return published.read();
+    }
+
+private:
+    //==============================================================================
+    static constexpr double tickSeconds = 0.01;
+    static constexpr int rmsTicks = 30;             // 300 ms
+    static constexpr int momentaryTicks = 40;       // 400 ms, also the gating block
+    static constexpr int shortTermTicks = 300;      // 3 s
+    static constexpr int gatingStepTicks = 10;      // gating blocks overlap by 75%
+
+    static constexpr double absoluteGateLufs = -70.0;
+    static constexpr double relativeGateLu = -10.0;
+    static constexpr double histogramStepLu = 0.1;
+    static constexpr int numHistogramBins = 800;    // -70 to +10 LUFS, louder blocks share the top bin
+
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+
+        double process(double x, double* state) const
+        {
+            const double y = b0 * x + state[0];
+            state[0] = b1 * x - a1 * y + state[1];
+            state[1] = b2 * x - a2 * y;
+            return y;
+        }
+    };
+
+    struct Channel
+    {
+        float peak = 0.0f, maxTruePeak = 0.0f;
+        FlarkTruePeakDetector truePeakDetector;
+        FlarkFloat4 truePeak = FlarkFloat4::zero(); // one lane per oversampling phase
+
+        float tickSquares = 0.0f;
+        double rmsRing[rmsTicks] {};
+        double rmsSum = 0.0;
+    };
+
+    // K-weighting of one channel that counts towards loudness
+    struct LoudnessState
+    {
+        int channel = 0;
+        double weight = 1.0;
+        double shelfState[2] {}, highPassState[2] {};
+    };
+
+    struct HistogramBin
+    {
+        juce::int64 count = 0;
+        double energy = 0.0;
+    };
+
+    //==============================================================================
+    void processChannel(Channel& channel, float x)
+    {
+        channel.peak = juce::jmax(channel.peak, std::abs(x));
+        channel.tickSquares += x * x;
+        channel.truePeak = FlarkFloat4::max(channel.truePeak, channel.truePeakDetector.process(x).abs());
+    }
+
+    void endTick()
+    {
+        numSamples += tickSamples;
+        tickSamples = 0;
+
+        for (auto& channel : channels)
+        {
+            channel.rmsSum += channel.tickSquares - channel.rmsRing[rmsPos];
+            channel.rmsRing[rmsPos] = channel.tickSquares;
+            channel.tickSquares = 0.0f;
+        }
+        rmsPos = (rmsPos + 1) % rmsTicks;
+
+        // The slot about to be overwritten left the short-term window; the
+        // one momentaryTicks back leaves the momentary window
+        const int momentaryOldest = (loudnessPos + shortTermTicks - momentaryTicks) % shortTermTicks;
+        momentarySum += tickWeighted - loudnessRing[static_cast<size_t>(momentaryOldest)];
+        shortTermSum += tickWeighted - loudnessRing[static_cast<size_t>(loudnessPos)];
+        loudnessRing[static_cast<size_t>(loudnessPos)] = tickWeighted;
+        loudnessPos = (loudnessPos + 1) % shortTermTicks;
+        tickWeighted = 0.0;
+
+        // Rebuild the running sums once per lap so rounding cannot accumulate
+        if (loudnessPos == 0)
+            resyncSums();
+
+        if (++numTicks >= momentaryTicks && numTicks % gatingStepTicks == 0)
+            addGatingBlock(momentarySum / (momentaryTicks * samplesPerTick));
+    }
+
+    void resyncSums()
+    {
+        for (auto& channel : channels)
+        {
+            channel.rmsSum = 0.0;
+            for (auto value : channel.rmsRing)
+                channel.rmsSum += value;
+        }
+
+        momentarySum = shortTermSum = 0.0;
+        for (int i = 0; i < shortTermTicks; ++i)
+        {
+            const double value = loudnessRing[static_cast<size_t>(i)];
+            shortTermSum += value;
+            if (i >= shortTermTicks - momentaryTicks)
+                momentarySum += value;
+        }
+    }
+
+    void addGatingBlock(double meanSquare)
+    {
+        const double lufs = -0.691 + 10.0 * std::log10(juce::jmax(meanSquare, 1.0e-30));
+        if (lufs <= absoluteGateLufs)
+            return;
+
+        const int bin = juce::jmin(numHistogramBins - 1, static_cast<int>((lufs - absoluteGateLufs) / histogramStepLu));
+        auto& entry = histogram[static_cast<size_t>(bin)];
+        ++entry.count;
+        entry.energy += meanSquare;
+
+        ++gatedCount;
+        gatedEnergy += meanSquare;
+
+        // Relative gate from every block above the absolute gate, then the
+        // mean of the blocks above it (to the histogram's resolution)
+        const double relativeGate = toLufs(gatedEnergy / static_cast<double>(gatedCount)) + relativeGateLu;
+        const int firstBin = juce::jlimit(0, numHistogramBins - 1,
+                                          static_cast<int>((relativeGate - absoluteGateLufs) / histogramStepLu));
+        juce::int64 count = 0;
+        double energy = 0.0;
+
+        for (int i = firstBin; i < numHistogramBins; ++i)
+        {
+            count += histogram[static_cast<size_t>(i)].count;
+            energy += histogram[static_cast<size_t>(i)].energy;
+        }
+
+        integratedLufs = count > 0 ? toLufs(energy / static_cast<double>(count)) : floorLufs;
+    }
+
+    void clearLoudnessHistory()
+    {
+        histogram.fill({});
+        gatedCount = 0;
+        gatedEnergy = 0.0;
+        integratedLufs = floorLufs;
+
+        for (auto& channel : channels)
+            channel.maxTruePeak = 0.0f;
+    }
+
+    static float toLufs(double meanSquare)
+    {
+        return meanSquare > 0.0 ? juce::jmax(floorLufs, static_cast<float>(-0.691 + 10.0 * std::log10(meanSquare)))
+                                : floorLufs;
+    }
+
+    // BS.1770 channel weights for the layout; the LFE is left out. 7.1's rear
+    // surrounds sit past 120 degrees, where the weight is back to 1.0.
+    void setLoudnessWeights()
+    {
+        static constexpr double surround = 1.41;
+        static constexpr double quadWeights[] = { 1.0, 1.0, surround, surround };
+        static constexpr double surroundWeights[] = { 1.0, 1.0, 1.0, 0.0, surround, surround, 1.0, 1.0 };
+
+        numMeteredChannels = juce::jmin(numInputChannels, numChannels);
+        numLoudnessChannels = 0;
+
+        for (int ch = 0; ch < numInputChannels; ++ch)
+        {
+            const double weight = numInputChannels == 4 ? quadWeights[ch]
+                                : numInputChannels >= 6 ? surroundWeights[ch]
+                                                        : 1.0;
+            if (weight > 0.0)
+            {
+                auto& state = loudnessStates[static_cast<size_t>(numLoudnessChannels++)];
+                state.channel = ch;
+                state.weight = weight;
+            }
+        }
+    }
+
+    //==============================================================================
+    // BS.1770 pre-filter (high shelf, then high-pass), re-derived for the
+    // sample rate so 44.1 kHz and 96 kHz match the 48 kHz reference response
+    void designKWeighting()
+    {
+        {
+            const double k = std::tan(juce::MathConstants<double>::pi * 1681.974450955533 / sampleRate);
+            const double q = 0.7071752369554196;
+            const double vh = std::pow(10.0, 3.999843853973347 / 20.0);
+            const double vb = std::pow(vh, 0.4996667741545416);
+            const double a0 = 1.0 + k / q + k * k;
+
+            shelf = { (vh + vb * k / q + k * k) / a0, 2.0 * (k * k - vh) / a0, (vh - vb * k / q + k * k) / a0,
+                      2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0 };
+        }
+        {
+            const double k = std::tan(juce::MathConstants<double>::pi * 38.13547087602444 / sampleRate);
+            const double q = 0.5003270373238773;
+            const double a0 = 1.0 + k / q + k * k;
+
+            highPass = { 1.0, -2.0, 1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0 };
+        }
+    }
+
+    //==============================================================================
+    double sampleRate = 44100.0;
+    int samplesPerTick = 441;
+
+    Biquad shelf, highPass;
+    int numInputChannels = 2;
+    int numMeteredChannels = 2;                      // 1 for mono
+    std::array<Channel, numChannels> channels;
+
+    int numLoudnessChannels = 2;
+    std::array<LoudnessState, maxChannels> loudnessStates;
+
+    int tickSamples = 0;
+    double tickWeighted = 0.0;                       // weighted K-weighted energy of every channel this tick
+    int rmsPos = 0;
+
+    std::array<double, shortTermTicks> loudnessRing {};
+    int loudnessPos = 0;
+    double momentarySum = 0.0, shortTermSum = 0.0;
+    juce::int64 numTicks = 0, numSamples = 0;
+
+    std::array<HistogramBin, numHistogramBins> histogram {};
+    juce::int64 gatedCount = 0;
+    double gatedEnergy = 0.0;
+    float integratedLufs = floorLufs;
+    std::atomic<bool> loudnessResetPending { false };
+
+    Readings latest;
+    FlarkTripleBuffer<Readings> published;
+    juce::SpinLock readLock;
+
+    JUCE_DECLARE_NON_COPYABLE(FlarkDJMeter)
+};
@@ -0,0 +1,335 @@
+#include "FlarkDJOfflineRenderer.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    // Around 1.5 s at 44.1 kHz per chunk, and the window of input kept mapped
+    constexpr int targetChunkSamples = 65536;
+    constexpr juce::int64 mapWindowSamples = 1 << 20;
+
+    //==============================================================================
+    // Writes chunks on its own thread. The render thread fills one buffer while
+    // the other is being written, so disk stalls overlap with processing.
+    class DoubleBufferedWriter
+    {
+    public:
+        DoubleBufferedWriter(juce::AudioFormatWriter& writerToUse, int numChannels, int chunkSize)
+            : writer(writerToUse)
+        {
+            for (auto& buffer : buffers)
+                buffer.setSize(numChannels, chunkSize);
+
+            thread = std::thread([this] { run(); });
+        }
+
+        ~DoubleBufferedWriter() { finish(); }
+
+        // The buffer the render thread should fill next
+        juce::AudioBuffer<float>& getFillBuffer() { return buffers[fillIndex]; }
+
+        // Queues numSamples of the fill buffer, from startSample, for writing,
+        // then waits until the other buffer has been written out. Returns false
+        // once a write has failed.
+        bool submit(int numSamples, int startSample = 0)
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+
+            // Nothing to write, e.g. a chunk that is all latency skip: keep
+            // filling the same buffer. Queued empty, it would read as free and
+            // the writer thread would fall out of step with the render thread.
+            if (numSamples <= 0)
+                return ! failed;
+
+            pending[fillIndex] = numSamples;
+            start[fillIndex] = startSample;
+            ready.notify_all();
+
+            fillIndex ^= 1;
+            ready.wait(lock, [this] { return pending[fillIndex] == 0 || failed; });
+            return ! failed;
+        }
+
+        // Writes whatever is queued and stops the thread. Returns false if any write failed.
+        bool finish()
+        {
+            if (thread.joinable())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    finishing = true;
+                }
+                ready.notify_all();
+                thread.join();
+            }
+
+            return ! failed;
+        }
+
+    private:
+        void run()
+        {
+            int writeIndex = 0;
+
+            for (;;)
+            {
+                int numSamples, startSample;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    ready.wait(lock, [&] { return pending[writeIndex] > 0 || finishing; });
+
+                    if (pending[writeIndex] == 0)
+                        return;
+
+                    numSamples = pending[writeIndex];
+                    startSample = start[writeIndex];
+                }
+
+                const bool ok = writer.writeFromAudioSampleBuffer(buffers[writeIndex], startSample, numSamples);
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    pending[writeIndex] = 0;
+                    failed = failed || ! ok;
+                }
+                ready.notify_all();
+
+                writeIndex ^= 1;
+            }
+        }
+
+        juce::AudioFormatWriter& writer;
+        juce::AudioBuffer<float> buffers[2];
+        int pending[2] = { 0, 0 }; // samples queued per buffer, 0 when free
+        int start[2] = { 0, 0 };
+        int fillIndex = 0;
+        bool finishing = false;
+        bool failed = false;
+
+        std::mutex mutex;
+        std::condition_variable ready;
+        std::thread thread;
+    };
+
+    // Keeps the input range [start, start + numSamples) inside the mapped window
+    bool mapInputRange(juce::MemoryMappedAudioFormatReader& reader, juce::int64 start, int numSamples)
+    {
+        const juce::Range<juce::int64> range(start, start + numSamples);
+
+        if (reader.getMappedSection().contains(range))
+            return true;
+
+        const auto end = juce::jmin(reader.lengthInSamples, start + juce::jmax<juce::int64>(mapWindowSamples, numSamples));
+        return reader.mapSectionOfFile({ start, end });
+    }
+}
+
+//==============================================================================
+FlarkDJOfflineRenderer::FlarkDJOfflineRenderer(const juce::MemoryBlock& presetState, int blockSizeToUse)
+    : preset(presetState), blockSize(juce::jmax(1, blockSizeToUse))
+{
+    chunkSize = blockSize * juce::jmax(1, targetChunkSamples / blockSize);
+
+    formatManager.registerBasicFormats();
+    readAheadThread.startThread();
+}
+
+FlarkDJOfflineRenderer::~FlarkDJOfflineRenderer()
+{
+    readAheadThread.stopThread(2000);
+}
+
+std::unique_ptr<juce::AudioFormatReader> FlarkDJOfflineRenderer::createReader(const juce::File& input)
+{
+    // Uncompressed formats are read straight from a memory-mapped window
+    if (auto* format = formatManager.findFormatForFileExtension(input.getFileExtension()))
+        if (auto* mapped = format->createMemoryMappedReader(input))
+            return std::unique_ptr<juce::AudioFormatReader>(mapped);
+
+    // Anything else (FLAC) is decoded ahead on the read-ahead thread
+    if (auto* reader = formatManager.createReaderFor(input))
+    {
+        auto buffered = std::make_unique<juce::BufferingAudioReader>(reader, readAheadThread, chunkSize * 4);
+        buffered->setReadTimeout(-1);
+        return buffered;
+    }
+
+    return nullptr;
+}
+
+void FlarkDJOfflineRenderer::processChunk(juce::AudioBuffer<float>& chunk, int startSample, int numSamples)
+{
+    for (int offset = 0; offset < numSamples; offset += blockSize)
+    {
+        float* channels[] = { chunk.getWritePointer(0, startSample + offset),
+                              chunk.getWritePointer(1, startSample + offset) };
+
+        juce::AudioBuffer<float> block(channels, 2, juce::jmin(blockSize, numSamples - offset));
+        processor.processBlock(block, midi);
+    }
+}
+
+FlarkDJOfflineRenderer::Result FlarkDJOfflineRenderer::render(const juce::File& input, const juce::File& output)
+{
+    Result result;
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+    auto reader = createReader(input);
+
+    if (reader == nullptr)
+    {
+        result.error = "Unsupported or unreadable audio file";
+        return result;
+    }
+
+    if (reader->numChannels > 2)
+    {
+        result.error = "Only mono and stereo files are supported";
+        return result;
+    }
+
+    auto* mappedReader = dynamic_cast<juce::MemoryMappedAudioFormatReader*>(reader.get());
+    auto* format = formatManager.findFormatForFileExtension(output.getFileExtension());
+
+    if (format == nullptr)
+    {
+        result.error = "No writer for " + output.getFileExtension();
+        return result;
+    }
+
+    // Keep the input bit depth when the output format supports it
+    int bitsPerSample = static_cast<int>(reader->bitsPerSample);
+    auto possibleDepths = format->getPossibleBitDepths();
+    if (! possibleDepths.contains(bitsPerSample))
+        bitsPerSample = possibleDepths[possibleDepths.size() - 1];
+
+    output.deleteFile();
+    std::unique_ptr<juce::OutputStream> stream(output.createOutputStream());
+
+    if (stream == nullptr)
+    {
+        result.error = "Cannot create " + output.getFullPathName();
+        return result;
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), reader->sampleRate,
+                                                                            2, bitsPerSample, {}, 0));
+
+    if (writer == nullptr)
+    {
+        result.error = "Cannot write " + format->getFormatName() + " at this sample rate/bit depth";
+        return result;
+    }
+
+    stream.release(); // now owned by the writer
+
+    // Every file starts from the preset with clean effect state
+    if (! preset.isEmpty())
+        processor.setStateInformation(preset.getData(), static_cast<int>(preset.getSize()));
+
+    const double sampleRate = reader->sampleRate;
+    const auto length = reader->lengthInSamples;
+
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+    processor.reset();
+
+    DoubleBufferedWriter asyncWriter(*writer, 2, chunkSize);
+    juce::int64 position = 0;
+
+    // The limiter's lookahead delays the output; drop that much from the
+    // start and flush it at the end, so the file lines up with the input
+    const int latency = processor.getLatencySamples();
+    int samplesToSkip = latency;
+
+    auto submit = [&](int numSamples)
+    {
+        const int skip = juce::jmin(samplesToSkip, numSamples);
+        samplesToSkip -= skip;
+        return asyncWriter.submit(numSamples - skip, skip);
+    };
+
+    while (position < length)
+    {
+        auto& chunk = asyncWriter.getFillBuffer();
+        const int numSamples = static_cast<int>(juce::jmin<juce::int64>(chunkSize, length - position));
+
+        if (mappedReader != nullptr && ! mapInputRange(*mappedReader, position, numSamples))
+        {
+            result.error = "Cannot map " + input.getFullPathName();
+            return result;
+        }
+
+        // Mono files are read into both channels
+        reader->read(&chunk, 0, numSamples, position, true, true);
+        processChunk(chunk, 0, numSamples);
+
+        if (! submit(numSamples))
+        {
+            result.error = "Write failed for " + output.getFullPathName();
+            return result;
+        }
+
+        position += numSamples;
+    }
+
+    // Feed silence until the reverb, delay and flanger have rung out, bounded
+    // by the tail length the processor reports for its settings
+    const auto maxTailSamples = static_cast<juce::int64>(std::ceil(processor.getTailLengthSeconds() * sampleRate));
+    juce::int64 tailSamples = 0;
+
+    while (tailSamples < maxTailSamples && processor.isTailRinging())
+    {
+        auto& chunk = asyncWriter.getFillBuffer();
+        chunk.clear();
+
+        int numSamples = 0;
+        while (numSamples < chunkSize && tailSamples + numSamples < maxTailSamples && processor.isTailRinging())
+        {
+            const int n = static_cast<int>(juce::jmin<juce::int64>(blockSize, maxTailSamples - tailSamples - numSamples));
+            processChunk(chunk, numSamples, n);
+            numSamples += n;
+        }
+
+        if (! submit(numSamples))
+        {
+            result.error = "Write failed for " + output.getFullPathName();
+            return result;
+        }
+
+        tailSamples += numSamples;
+    }
+
+    for (int flushed = 0; flushed < latency;)
+    {
+        auto& chunk = asyncWriter.getFillBuffer();
+        chunk.clear();
+
+        const int numSamples = juce::jmin(chunkSize, latency - flushed);
+        processChunk(chunk, 0, numSamples);
+
+        if (! submit(numSamples))
+        {
+            result.error = "Write failed for " + output.getFullPathName();
+            return result;
+        }
+
+        flushed += numSamples;
+    }
+
+    if (! asyncWriter.finish())
+    {
+        result.error = "Write failed for " + output.getFullPathName();
+        return result;
+    }
+
+    processor.releaseResources();
+
+    result.success = true;
+    result.numSamples = length;
+    result.numTailSamples = tailSamples;
+    result.sampleRate = sampleRate;
+    result.renderSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+    return result;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include "FlarkDJProcessor.h"
+
+/**
+ * FlarkDJ Offline Renderer
+ *
+ * Renders audio files through a FlarkDJProcessor without an editor or audio
+ * device. Each renderer owns its own processor, so one instance per thread
+ * can render files in parallel.
+ *
+ * Rendering streams: WAV/AIFF input is read through a memory-mapped window,
+ * other formats are decoded ahead on a background thread, and output chunks
+ * are written on a writer thread while the next chunk is processed. Memory use
+ * is a few chunks whatever the file length.
+ */
+class FlarkDJOfflineRenderer
+{
+public:
+    struct Result
+    {
+        bool success = false;
+        juce::String error;
+        juce::int64 numSamples = 0;     // input length
+        juce::int64 numTailSamples = 0; // reverb/delay tail rendered after the input
+        double sampleRate = 0.0;
+        double renderSeconds = 0.0;
+
+        // Audio duration divided by wall-clock render time
+        double getRealtimeFactor() const
+        {
+            return renderSeconds > 0.0 ? ((numSamples + numTailSamples) / sampleRate) / renderSeconds : 0.0;
+        }
+    };
+
+    // presetState is a blob from FlarkDJProcessor::getStateInformation (an .fxp
+    // preset file); pass an empty block to render with default parameters
+    FlarkDJOfflineRenderer(const juce::MemoryBlock& presetState, int blockSize);
+    ~FlarkDJOfflineRenderer();
+
+    // Renders input to output, followed by the effects' tail. The output format
+    // follows the output file's extension, with the input's sample rate and bit depth.
+    // The limiter's lookahead latency is compensated, so output lines up with input.
+    Result render(const juce::File& input, const juce::File& output);
+
+    // Samples per chunk handed to the writer thread (a multiple of the block size)
+    int getChunkSize() const { return chunkSize; }
+
+private:
+    std::unique_ptr<juce::AudioFormatReader> createReader(const juce::File& input);
+    void processChunk(juce::AudioBuffer<float>& chunk, int startSample, int numSamples);
+
+    FlarkDJProcessor processor;
+    juce::AudioFormatManager formatManager;
+    juce::TimeSliceThread readAheadThread { "FlarkDJ read-ahead" };
+    juce::MidiBuffer midi;
+    juce::MemoryBlock preset;
+    int blockSize;
+    int chunkSize;
+
+    JUCE_DECLARE_NON_COPYABLE(FlarkDJOfflineRenderer)
+};
@@ -0,0 +1,261 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include "FlarkDJTrace.h"
+
+/**
+ * FlarkDJ Performance Monitoring
+ *
+ * Always-on timing of each processing stage and of whole blocks, measured on
+ * the audio thread and published without locks for the editor, the stats
+ * exporter or anything else that wants to read it.
+ *
+ * Block load is processing time divided by the buffer duration; a load of 1.0
+ * or more is an overrun (the host would have glitched). Every overrun records
+ * the stage times, enabled effects and parameter values of that block, so a
+ * glitch can be traced back to the effect and settings that caused it.
+ */
+
+//==============================================================================
+// Triple buffer: one writer publishes whole values, one reader takes the
+// latest. Neither side ever blocks or sees a half-written value.
+//==============================================================================
+template <typename T>
+class FlarkTripleBuffer
+{
+public:
+    // Writer: fill this, then publish()
+    T& getWriteBuffer() { return buffers[writeIndex]; }
+
+    void publish()
+    {
+        writeIndex = middle.exchange(writeIndex | newDataFlag, std::memory_order_acq_rel) & indexMask;
+    }
+
+    // Reader: the most recently published value
+    const T& read()
+    {
+        if ((middle.load(std::memory_order_relaxed) & newDataFlag) != 0)
+            readIndex = middle.exchange(readIndex, std::memory_order_acq_rel) & indexMask;
+
+        return buffers[readIndex];
+    }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int newDataFlag = 4;
+
+    T buffers[3] {};
+    int writeIndex = 0;
+    int readIndex = 1;
+    std::atomic<int> middle { 2 };
+};
+
+//==============================================================================
+// Performance Monitor
+//==============================================================================
+class FlarkDJPerformanceMonitor
+{
+public:
+    enum Stage
+    {
+        Filter = 0,
+        Reverb,
+        Delay,
+        Flanger,
+        Isolator,
+        Limiter,
+        Metering,
+        numStages
+    };
+
+    static const char* getStageName(int stage)
+    {
+        static const char* const names[] = { "filter", "reverb", "delay", "flanger", "isolator", "limiter", "metering" };
+        return juce::isPositiveAndBelow(stage, static_cast<int>(numStages)) ? names[stage] : "unknown";
+    }
+
+    // Block load histogram: bucket i counts blocks with load below loadBucketEdges[i],
+    // the last bucket everything above. Buckets from firstOverrunBucket up are overruns.
+    static constexpr int numLoadBuckets = 10;
+    static constexpr double loadBucketEdges[numLoadBuckets - 1] = { 0.25, 0.5, 0.75, 0.9, 1.0, 1.25, 1.5, 2.0, 4.0 };
+    static constexpr int firstOverrunBucket = 5;
+
+    static constexpr int maxParameters = 64;
+
+    // What was happening in one overrunning block
+    struct Overrun
+    {
+        juce::int64 block = -1;                // block index, -1 if there has been none
+        int numSamples = 0;
+        double load = 0.0;
+        double stageSeconds[numStages] {};
+        unsigned enabledMask = 0;              // FlarkDJProcessor stage bits
+        int numParameters = 0;
+        float parameterValues[maxParameters] {}; // normalised, in AudioProcessor::getParameters() order
+    };
+
+    struct Snapshot
+    {
+        double sampleRate = 0.0;
+        juce::int64 numBlocks = 0;
+        juce::int64 numOverruns = 0;
+
+        double lastLoad = 0.0;
+        double recentLoad = 0.0;               // smoothed over roughly the last 50 blocks
+        double maxLoad = 0.0;
+        double totalProcessSeconds = 0.0;
+        double totalAudioSeconds = 0.0;        // mean load = totalProcessSeconds / totalAudioSeconds
+        double loadSum = 0.0;
+
+        double stageLastSeconds[numStages] {};
+        double stageMaxSeconds[numStages] {};
+        double stageTotalSeconds[numStages] {};
+
+        juce::int64 loadHistogram[numLoadBuckets] {};
+
+        Overrun lastOverrun;
+        Overrun worstOverrun;
+
+        double getMeanLoad() const
+        {
+            return totalAudioSeconds > 0.0 ? totalProcessSeconds / totalAudioSeconds : 0.0;
+        }
+    };
+
+    //==============================================================================
+    // Any thread. Counters restart at the next block.
+    void prepare(double newSampleRate)
+    {
+        sampleRate.store(newSampleRate);
+        resetRequested.store(true);
+    }
+
+    void reset() { resetRequested.store(true); }
+
+    // Any thread, but only one at a time (the read side is locked against
+    // other readers; the audio thread never waits)
+    Snapshot getSnapshot()
+    {
+        const juce::SpinLock::ScopedLockType lock(readLock);
+        return published.read();
+    }
+
+    //==============================================================================
+    // Audio thread
+    void beginBlock(int numSamples)
+    {
+        if (resetRequested.exchange(false))
+        {
+            state = Snapshot();
+            state.sampleRate = sampleRate.load();
+        }
+
+        blockSamples = numSamples;
+        std::fill(std::begin(blockStageTicks), std::end(blockStageTicks), juce::int64 { 0 });
+        blockStartTicks = juce::Time::getHighResolutionTicks();
+    }
+
+    void addStageTicks(int stage, juce::int64 ticks)
+    {
+        blockStageTicks[stage] += ticks;
+    }
+
+    // Times a stage for the lifetime of the object. With tracing compiled in,
+    // the same timestamps are also recorded as a trace event.
+    class ScopedStage
+    {
+    public:
+        ScopedStage(FlarkDJPerformanceMonitor& m, int s)
+            : monitor(m), stage(s), start(juce::Time::getHighResolutionTicks()) {}
+
+        ~ScopedStage()
+        {
+            const auto end = juce::Time::getHighResolutionTicks();
+            monitor.addStageTicks(stage, end - start);
+
+           #if FLARKDJ_TRACING
+            FlarkDJTracer::record(getStageName(stage), start, end);
+           #endif
+        }
+
+    private:
+        FlarkDJPerformanceMonitor& monitor;
+        const int stage;
+        const juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedStage)
+    };
+
+    // Ends the block and publishes a new snapshot. Parameters are read (through
+    // getValue) only when the block overran.
+    template <typename ParameterArray>
+    void endBlock(unsigned enabledMask, const ParameterArray& parameters)
+    {
+        const double processSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks()
+                                                                               - blockStartTicks);
+        const double audioSeconds = state.sampleRate > 0.0 ? blockSamples / state.sampleRate : 0.0;
+        const double load = audioSeconds > 0.0 ? processSeconds / audioSeconds : 0.0;
+
+        ++state.numBlocks;
+        state.lastLoad = load;
+        state.recentLoad += (load - state.recentLoad) * 0.02;
+        state.maxLoad = juce::jmax(state.maxLoad, load);
+        state.totalProcessSeconds += processSeconds;
+        state.totalAudioSeconds += audioSeconds;
+        state.loadSum += load;
+
+        for (int i = 0; i < numStages; ++i)
+        {
+            const double seconds = juce::Time::highResolutionTicksToSeconds(blockStageTicks[i]);
+            state.stageLastSeconds[i] = seconds;
+            state.stageMaxSeconds[i] = juce::jmax(state.stageMaxSeconds[i], seconds);
+            state.stageTotalSeconds[i] += seconds;
+        }
+
+        int bucket = 0;
+        while (bucket < numLoadBuckets - 1 && load >= loadBucketEdges[bucket])
+            ++bucket;
+        ++state.loadHistogram[bucket];
+
+        if (bucket >= firstOverrunBucket)
+        {
+            ++state.numOverruns;
+            recordOverrun(state.lastOverrun, load, enabledMask, parameters);
+
+            if (load > state.worstOverrun.load)
+                state.worstOverrun = state.lastOverrun;
+        }
+
+        published.getWriteBuffer() = state;
+        published.publish();
+    }
+
+private:
+    template <typename ParameterArray>
+    void recordOverrun(Overrun& overrun, double load, unsigned enabledMask, const ParameterArray& parameters)
+    {
+        overrun.block = state.numBlocks - 1;
+        overrun.numSamples = blockSamples;
+        overrun.load = load;
+        overrun.enabledMask = enabledMask;
+        std::copy(std::begin(state.stageLastSeconds), std::end(state.stageLastSeconds), overrun.stageSeconds);
+
+        overrun.numParameters = juce::jmin(static_cast<int>(parameters.size()), maxParameters);
+        for (int i = 0; i < overrun.numParameters; ++i)
+            overrun.parameterValues[i] = parameters[i]->getValue();
+    }
+
+    // Audio thread only
+    Snapshot state;
+    int blockSamples = 0;
+    juce::int64 blockStartTicks = 0;
+    juce::int64 blockStageTicks[numStages] {};
+
+    std::atomic<double> sampleRate { 44100.0 };
+    std::atomic<bool> resetRequested { true };
+
+    FlarkTripleBuffer<Snapshot> published;
+    juce::SpinLock readLock;
+};
@@ -0,0 +1,220 @@
+#include "FlarkDJPerformanceExporter.h"
+
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+ #define FLARKDJ_UNIX_SOCKETS 1
+ #include <cerrno>
+ #include <poll.h>
+ #include <sys/socket.h>
+ #include <sys/time.h>
+ #include <sys/un.h>
+ #include <unistd.h>
+#else
+ #define FLARKDJ_UNIX_SOCKETS 0
+#endif
+
+//==============================================================================
+FlarkDJPerformanceExporter::FlarkDJPerformanceExporter()
+    : FlarkDJPerformanceExporter(juce::File(juce::SystemStats::getEnvironmentVariable("FLARKDJ_STATS_FILE", {})),
+                                 juce::SystemStats::getEnvironmentVariable("FLARKDJ_STATS_SOCKET", {}))
+{
+}
+
+FlarkDJPerformanceExporter::FlarkDJPerformanceExporter(const juce::File& reportFile, const juce::String& socketPathToUse,
+                                                       int intervalMs)
+    : juce::Thread("FlarkDJ stats exporter"),
+      file(reportFile), socketPath(socketPathToUse), interval(juce::jmax(100, intervalMs))
+{
+    if (file != juce::File() || socketPath.isNotEmpty())
+        startThread(juce::Thread::Priority::low);
+}
+
+FlarkDJPerformanceExporter::~FlarkDJPerformanceExporter()
+{
+    stopThread(2 * interval);
+    closeSocket();
+}
+
+void FlarkDJPerformanceExporter::addSource(int instance, ReportSource source)
+{
+    const juce::ScopedLock lock(sourceLock);
+    sources[instance] = std::move(source);
+}
+
+void FlarkDJPerformanceExporter::removeSource(int instance)
+{
+    const juce::ScopedLock lock(sourceLock);
+    sources.erase(instance);
+}
+
+juce::String FlarkDJPerformanceExporter::getReport()
+{
+    // Prometheus wants all samples of a metric family together, with its
+    // HELP and TYPE lines once, so the reports are merged family by family
+    struct Family
+    {
+        juce::StringArray headers;
+        juce::String samples;
+    };
+
+    juce::StringArray order;
+    std::map<juce::String, Family> families;
+
+    const juce::ScopedLock lock(sourceLock);
+
+    for (auto& [instance, source] : sources)
+    {
+        const juce::String label = "instance=\"" + juce::String(instance) + "\"";
+        juce::String name;
+
+        for (auto& line : juce::StringArray::fromLines(source()))
+        {
+            if (line.isEmpty())
+                continue;
+
+            if (line.startsWith("#"))
+            {
+                // "# HELP <name> ..." and "# TYPE <name> ..." start a family
+                name = juce::StringArray::fromTokens(line, " ", {})[2];
+                order.addIfNotAlreadyThere(name);
+                families[name].headers.addIfNotAlreadyThere(line);
+                continue;
+            }
+
+            order.addIfNotAlreadyThere(name);
+
+            const int brace = line.indexOfChar('{');
+            const int space = line.indexOfChar(' ');
+            auto& samples = families[name].samples;
+
+            if (brace >= 0 && brace < space)
+                samples << line.substring(0, brace + 1) << label << "," << line.substring(brace + 1) << "\n";
+            else
+                samples << line.substring(0, space) << "{" << label << "}" << line.substring(space) << "\n";
+        }
+    }
+
+    juce::String text;
+    for (auto& name : order)
+    {
+        const auto& family = families[name];
+        for (auto& header : family.headers)
+            text << header << "\n";
+        text << family.samples;
+    }
+
+    return text;
+}
+
+void FlarkDJPerformanceExporter::run()
+{
+    if (socketPath.isNotEmpty() && ! openSocket())
+        DBG("FlarkDJ: cannot listen on " << socketPath);
+
+    while (! threadShouldExit())
+    {
+        if (file != juce::File())
+            writeReportFile();
+
+        // Waiting on the socket doubles as the interval sleep
+        if (listenSocket >= 0)
+            serveSocket(interval);
+        else
+            wait(interval);
+    }
+}
+
+void FlarkDJPerformanceExporter::writeReportFile()
+{
+    // Write beside the target and rename, so readers never see a partial report
+    juce::TemporaryFile temp(file);
+
+    if (temp.getFile().replaceWithText(getReport()))
+        temp.overwriteTargetFileWithTemporary();
+}
+
+#if FLARKDJ_UNIX_SOCKETS
+bool FlarkDJPerformanceExporter::openSocket()
+{
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+
+    const auto path = socketPath.toRawUTF8();
+    if (std::strlen(path) >= sizeof(address.sun_path))
+        return false;
+
+    std::strcpy(address.sun_path, path);
+    ::unlink(path); // stale socket from an earlier run
+
+    listenSocket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenSocket < 0)
+        return false;
+
+    if (::bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || ::listen(listenSocket, 4) != 0)
+    {
+        closeSocket();
+        return false;
+    }
+
+    return true;
+}
+
+void FlarkDJPerformanceExporter::serveSocket(int timeoutMs)
+{
+    pollfd pfd { listenSocket, POLLIN, 0 };
+
+    if (::poll(&pfd, 1, timeoutMs) <= 0 || (pfd.revents & POLLIN) == 0)
+        return;
+
+    const int client = ::accept(listenSocket, nullptr, nullptr);
+    if (client < 0)
+        return;
+
+    // A reader that hangs up must not raise SIGPIPE in the host, and one that
+    // stops reading must not hold the thread past the interval, or stopThread
+    // would give up on it
+   #ifdef MSG_NOSIGNAL
+    const int sendFlags = MSG_NOSIGNAL;
+   #else
+    const int sendFlags = 0;
+   #endif
+   #ifdef SO_NOSIGPIPE
+    const int noSigPipe = 1;
+    ::setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+   #endif
+    timeval sendTimeout { interval / 1000, (interval % 1000) * 1000 };
+    ::setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+
+    const auto report = getReport();
+    const char* data = report.toRawUTF8();
+    size_t remaining = report.getNumBytesAsUTF8();
+
+    while (remaining > 0 && ! threadShouldExit())
+    {
+        const auto written = ::send(client, data, remaining, sendFlags);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            break;
+
+        data += written;
+        remaining -= static_cast<size_t>(written);
+    }
+
+    ::close(client);
+}
+
+void FlarkDJPerformanceExporter::closeSocket()
+{
+    if (listenSocket >= 0)
+    {
+        ::close(listenSocket);
+        listenSocket = -1;
+        ::unlink(socketPath.toRawUTF8());
+    }
+}
+#else
+bool FlarkDJPerformanceExporter::openSocket()                { return false; }
+void FlarkDJPerformanceExporter::serveSocket(int timeoutMs)  { wait(timeoutMs); }
+void FlarkDJPerformanceExporter::closeSocket()               {}
+#endif
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <functional>
+#include <map>
+
+/**
+ * FlarkDJ Performance Exporter
+ *
+ * Background thread that publishes a text report (the processors'
+ * Prometheus-style performance metrics) to a file and/or a Unix domain
+ * socket. The file is rewritten atomically every interval, so a textfile
+ * collector or `watch cat` always sees a whole report. Each connection to the
+ * socket receives the current report and is closed, e.g.
+ *
+ *     socat - UNIX-CONNECT:/tmp/flarkdj.sock
+ *
+ * One exporter serves the whole process: every processor instance adds its
+ * report as a source, and each of its samples is labelled instance="N", so a
+ * rig with a FlarkDJ on each deck publishes one report covering all of them.
+ *
+ * Unix sockets are not available on Windows; only the file is written there.
+ */
+class FlarkDJPerformanceExporter : private juce::Thread
+{
+public:
+    using ReportSource = std::function<juce::String()>;
+
+    // Publishes to FLARKDJ_STATS_FILE and/or FLARKDJ_STATS_SOCKET, and does
+    // nothing when neither is set. Shared between all processor instances via
+    // juce::SharedResourcePointer.
+    FlarkDJPerformanceExporter();
+
+    // Either path may be empty
+    FlarkDJPerformanceExporter(const juce::File& reportFile, const juce::String& socketPath, int intervalMs = 1000);
+    ~FlarkDJPerformanceExporter() override;
+
+    bool isExporting() const { return isThreadRunning(); }
+
+    // Adds a report whose samples are published with an instance="N" label.
+    // The source is called on the exporter thread until it is removed;
+    // removeSource waits for a call in progress to finish.
+    void addSource(int instance, ReportSource source);
+    void removeSource(int instance);
+
+    // The reports of every source, one metric family after another
+    juce::String getReport();
+
+private:
+    void run() override;
+    void writeReportFile();
+    bool openSocket();
+    void serveSocket(int timeoutMs);
+    void closeSocket();
+
+    juce::CriticalSection sourceLock;
+    std::map<int, ReportSource> sources;
+
+    juce::File file;
+    juce::String socketPath;
+    int interval;
+    int listenSocket = -1;
+
+    JUCE_DECLARE_NON_COPYABLE(FlarkDJPerformanceExporter)
+};
@@ -1,5 +1,11 @@
 #include "FlarkDJProcessor.h"
 #include "FlarkDJEditor.h"
+#include "FlarkDJEffectChain.h"
+
+namespace
+{
+    std::atomic<int> numInstancesCreated { 0 };
+}
 
 //==============================================================================
 FlarkDJProcessor::FlarkDJProcessor()
@@ -15,6 +21,8 @@ FlarkDJProcessor::FlarkDJProcessor()
                         0.1f, 10.0f, 3.0f),
                     std::make_unique<juce::AudioParameterChoice>("filterType", "Filter Type",
                         juce::StringArray{"Lowpass", "Highpass", "Bandpass"}, 0),
+                    std::make_unique<juce::AudioParameterChoice>("filterTopology", "Filter Topology",
+                        juce::StringArray{"Biquad", "State Variable"}, 0),
 
                     std::make_unique<juce::AudioParameterBool>("reverbEnabled", "Reverb Enabled", false),
                     std::make_unique<juce::AudioParameterFloat>("reverbRoomSize", "Reverb Room Size",
@@ -60,14 +68,32 @@ FlarkDJProcessor::FlarkDJProcessor()
                     std::make_unique<juce::AudioParameterFloat>("isolatorPosition", "Isolator Position",
                         -1.0f, 1.0f, 0.0f),
                     std::make_unique<juce::AudioParameterFloat>("isolatorQ", "Isolator Q",
-                        0.5f, 10.0f, 2.0f)
-                })
+                        0.5f, 10.0f, 2.0f),
+                    std::make_unique<juce::AudioParameterChoice>("isolatorMode", "Isolator Mode",
+                        juce::StringArray{"Sweep", "3-Band"}, 0),
+                    std::make_unique<juce::AudioParameterFloat>("isolatorLow", "Isolator Low",
+                        juce::NormalisableRange<float>(isolatorKillDb, 6.0f, 0.1f), 0.0f),
+                    std::make_unique<juce::AudioParameterFloat>("isolatorMid", "Isolator Mid",
+                        juce::NormalisableRange<float>(isolatorKillDb, 6.0f, 0.1f), 0.0f),
+                    std::make_unique<juce::AudioParameterFloat>("isolatorHigh", "Isolator High",
+                        juce::NormalisableRange<float>(isolatorKillDb, 6.0f, 0.1f), 0.0f),
+
+                    // Both set the plugin latency, which hosts cannot follow under automation
+                    std::make_unique<juce::AudioParameterChoice>("limiterMode", "Limiter Mode",
+                        juce::StringArray{"Soft Clip", "Lookahead", "Lookahead True Peak"}, 1,
+                        juce::AudioParameterChoiceAttributes().withAutomatable(false)),
+                    std::make_unique<juce::AudioParameterFloat>("limiterLookahead", "Limiter Lookahead",
+                        juce::NormalisableRange<float>(0.5f, FlarkLookaheadLimiter::maxLookaheadMs, 0.1f), 1.5f,
+                        juce::AudioParameterFloatAttributes().withAutomatable(false))
+                }),
+      instanceId(++numInstancesCreated)
 {
     // Get parameter pointers
     filterEnabled = parameters.getRawParameterValue("filterEnabled");
     filterCutoff = parameters.getRawParameterValue("filterCutoff");
     filterResonance = parameters.getRawParameterValue("filterResonance");
     filterType = parameters.getRawParameterValue("filterType");
+    filterTopology = parameters.getRawParameterValue("filterTopology");
 
     reverbEnabled = parameters.getRawParameterValue("reverbEnabled");
     reverbRoomSize = parameters.getRawParameterValue("reverbRoomSize");
@@ -97,19 +123,81 @@ FlarkDJProcessor::FlarkDJProcessor()
     isolatorEnabled = parameters.getRawParameterValue("isolatorEnabled");
     isolatorPosition = parameters.getRawParameterValue("isolatorPosition");
     isolatorQ = parameters.getRawParameterValue("isolatorQ");
+    isolatorMode = parameters.getRawParameterValue("isolatorMode");
+    isolatorLow = parameters.getRawParameterValue("isolatorLow");
+    isolatorMid = parameters.getRawParameterValue("isolatorMid");
+    isolatorHigh = parameters.getRawParameterValue("isolatorHigh");
+
+    limiterMode = parameters.getRawParameterValue("limiterMode");
+    limiterLookahead = parameters.getRawParameterValue("limiterLookahead");
+
+    // Limiter changes are applied on the message thread (see handleAsyncUpdate)
+    parameters.addParameterListener("limiterMode", this);
+    parameters.addParameterListener("limiterLookahead", this);
+
+    lfoBuffer.assign(static_cast<size_t>(currentBlockSize), 0.0f);
+    tailBuffer.setSize(currentNumChannels, currentBlockSize);
+
+    // Rigs can publish performance stats without touching the UI
+    if (performanceExporter->isExporting())
+        performanceExporter->addSource(instanceId, [this] { return getPerformanceReport(); });
+
+    // Capturing from construction gives a replay that matches bit for bit
+    const auto capturePath = juce::SystemStats::getEnvironmentVariable("FLARKDJ_CAPTURE_FILE", {});
+
+    if (capturePath.isNotEmpty())
+    {
+        const auto captureFile = FlarkDJCaptureRecorder::getInstanceFile(juce::File(capturePath), instanceId);
+
+        if (! startCapture(captureFile))
+            DBG("FlarkDJ: cannot write capture to " << captureFile.getFullPathName());
+    }
 }
 
 FlarkDJProcessor::~FlarkDJProcessor()
 {
+    // Stop the exporter and recorder reading state that is about to go away
+    performanceExporter->removeSource(instanceId);
+    capture.stop();
+
+    parameters.removeParameterListener("limiterMode", this);
+    parameters.removeParameterListener("limiterLookahead", this);
+    cancelPendingUpdate();
 }
 
 //==============================================================================
 void FlarkDJProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
+    FLARKDJ_TRACE_SCOPE("prepareToPlay");
+
+    capture.recordPrepare(sampleRate, samplesPerBlock, controlRateInterval.load());
+
     currentSampleRate = sampleRate;
     currentBlockSize = samplesPerBlock;
+    currentNumChannels = juce::jlimit(1, FlarkChannelGroup::maxChannels, getMainBusNumOutputChannels());
+
+    // Scratch space for block processing (larger host blocks are chunked)
+    lfoBuffer.assign(static_cast<size_t>(juce::jmax(1, samplesPerBlock)), 0.0f);
+    tailBuffer.setSize(currentNumChannels, static_cast<int>(lfoBuffer.size()));
 
     initializeFlarkDJ();
+
+    // The host reads the latency and the tail length before the first block
+    cancelPendingUpdate();
+    limiterChanged = false;
+    updateLimiter(static_cast<int>(limiterMode->load()), limiterLookahead->load());
+
+    // Push every parameter into the freshly prepared DSP objects. The play
+    // head is only valid during processBlock, so the BPM waits until then.
+    parametersNeedFullUpdate = true;
+    applyParameterChanges(loadParameterSnapshot(nullptr));
+
+    if (tailLengthChanged)
+        triggerAsyncUpdate();
+
+    performance.prepare(sampleRate);
+    meter.prepare(sampleRate, currentNumChannels);
+    spectrumAnalyzer.prepare(sampleRate);
 }
 
 void FlarkDJProcessor::releaseResources()
@@ -117,33 +205,73 @@ void FlarkDJProcessor::releaseResources()
     // Release any resources
 }
 
+void FlarkDJProcessor::reset()
+{
+    // Clear all effect state, e.g. between unrelated renders
+    capture.recordReset();
+
+    filter.reset();
+    svfFilter.reset();
+    reverb.reset();
+    delay.reset();
+    flanger.reset();
+    isolator.reset();
+    bandIsolator.reset();
+    lookaheadLimiter.reset();
+    lfo.reset();
+    meter.reset();
+
+    reverbTail.reset();
+    delayTail.reset();
+    flangerTail.reset();
+
+    monoDetector.reset();
+    monoChain = false;
+}
+
 void FlarkDJProcessor::initializeFlarkDJ()
 {
     // Initialize DSP components with current sample rate
     float sr = static_cast<float>(currentSampleRate);
 
-    filterLeft.setSampleRate(sr);
-    filterRight.setSampleRate(sr);
+    filter.setSampleRate(sr);
+    svfFilter.setSampleRate(sr);
+
+    // The delay-based effects allocate a line per channel group
+    reverb.setNumChannels(currentNumChannels);
+    reverb.setSampleRate(sr);
+
+    delay.setNumChannels(currentNumChannels);
+    delay.setSampleRate(sr);
 
-    reverbLeft.setSampleRate(sr);
-    reverbRight.setSampleRate(sr);
+    flanger.setNumChannels(currentNumChannels);
+    flanger.setSampleRate(sr);
 
-    delayLeft.setSampleRate(sr);
-    delayRight.setSampleRate(sr);
+    isolator.setSampleRate(sr);
+    bandIsolator.setSampleRate(sr);
 
-    flangerLeft.setSampleRate(sr);
-    flangerRight.setSampleRate(sr);
+    monoDetector.setSampleRate(sr);
+    monoChain = false;
 
-    isolatorLeft.setSampleRate(sr);
-    isolatorRight.setSampleRate(sr);
+    lookaheadLimiter.setSampleRate(sr);
 
     lfo.setSampleRate(sr);
+
+    reverbTail.reset();
+    delayTail.reset();
+    flangerTail.reset();
 }
 
 bool FlarkDJProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 {
-    // Only stereo is supported
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Mono, stereo, quad, 5.1 and 7.1
+    const auto& output = layouts.getMainOutputChannelSet();
+
+    if (output != juce::AudioChannelSet::mono()
+        && output != juce::AudioChannelSet::stereo()
+        && output != juce::AudioChannelSet::quadraphonic()
+        && output != juce::AudioChannelSet::create5point1()
+        && output != juce::AudioChannelSet::create7point1())
         return false;
 
     // Input and output layout must be the same
@@ -155,6 +283,8 @@ bool FlarkDJProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
 
 void FlarkDJProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    FLARKDJ_TRACE_THREAD("audio");
+    FLARKDJ_TRACE_SCOPE("processBlock");
     juce::ScopedNoDenormals noDenormals;
 
     auto totalNumInputChannels  = getTotalNumInputChannels();
@@ -164,181 +294,611 @@ void FlarkDJProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::Midi
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // Get audio buffers
-    auto* leftChannel  = buffer.getWritePointer(0);
-    auto* rightChannel = buffer.getWritePointer(1);
+    // Get audio buffers: every channel of the main bus, in place
+    auto* const* channels = buffer.getArrayOfWritePointers();
+    const int numChannels = juce::jmin(currentNumChannels, buffer.getNumChannels());
     auto numSamples = buffer.getNumSamples();
 
+    capture.recordBlockInput(buffer, getPlayHead());
+    performance.beginBlock(numSamples);
+
     // Process audio through FlarkDJ engine
-    processAudio(leftChannel, rightChannel, leftChannel, rightChannel, numSamples);
+    processAudio(channels, numChannels, numSamples);
+
+    // The limiter stage metered every sample on its way out; publish the
+    // block's readings and hand the front pair (or the one channel of a mono
+    // layout, on both sides) to the analyzer.
+    {
+        const FlarkDJPerformanceMonitor::ScopedStage timing(performance, FlarkDJPerformanceMonitor::Metering);
+
+        auto* leftChannel  = channels[0];
+        auto* rightChannel = channels[numChannels > 1 ? 1 : 0];
+
+        const auto& readings = meter.publish();
+        outputLevel.store(std::sqrt(0.5f * (readings.rms[0] * readings.rms[0] + readings.rms[1] * readings.rms[1])));
+
+        spectrumAnalyzer.pushSamples(leftChannel, rightChannel, numSamples);
+    }
+
+    performance.endBlock(lastEnabledMask, AudioProcessor::getParameters());
+    capture.recordBlockOutput(buffer);
+}
+
+//==============================================================================
+FlarkDJProcessor::ParameterSnapshot FlarkDJProcessor::loadParameterSnapshot(juce::AudioPlayHead* playHead)
+{
+    ParameterSnapshot p;
+
+    p.filterOn = filterEnabled->load() > 0.5f;
+    p.filterCutoff = filterCutoff->load();
+    p.filterResonance = filterResonance->load();
+    p.filterType = static_cast<int>(filterType->load());
+    p.filterTopology = static_cast<int>(filterTopology->load());
+
+    p.reverbOn = reverbEnabled->load() > 0.5f;
+    p.reverbRoomSize = reverbRoomSize->load();
+    p.reverbDamping = reverbDamping->load();
+    p.reverbWetDry = reverbWetDry->load();
+
+    p.delayOn = delayEnabled->load() > 0.5f;
+    p.delayTime = delayTime->load();
+    p.delayFeedback = delayFeedback->load();
+    p.delayWetDry = delayWetDry->load();
+
+    p.flangerOn = flangerEnabled->load() > 0.5f;
+    p.flangerRate = flangerRate->load();
+    p.flangerDepth = flangerDepth->load();
+    p.flangerFeedback = flangerFeedback->load();
+    p.flangerWetDry = flangerWetDry->load();
+
+    p.isolatorOn = isolatorEnabled->load() > 0.5f;
+    p.isolatorPosition = isolatorPosition->load();
+    p.isolatorQ = isolatorQ->load();
+    p.isolatorMode = static_cast<int>(isolatorMode->load());
+    p.isolatorLow = isolatorLow->load();
+    p.isolatorMid = isolatorMid->load();
+    p.isolatorHigh = isolatorHigh->load();
+
+    p.lfoRate = lfoRate->load();
+    p.lfoDepth = lfoDepth->load();
+    p.lfoWaveform = static_cast<int>(lfoWaveform->load());
+    p.lfoSync = lfoSync->load() > 0.5f;
+    p.lfoSyncRate = static_cast<int>(lfoSyncRate->load());
 
-    // Calculate RMS level for spectrum display
-    float rms = 0.0f;
-    for (int i = 0; i < numSamples; ++i)
+    // BPM sync
+    p.bpm = currentParams.bpm;
+    if (p.lfoSync)
     {
-        float sample = (leftChannel[i] + rightChannel[i]) * 0.5f;
-        rms += sample * sample;
+        if (playHead != nullptr)
+        {
+            if (auto posInfo = playHead->getPosition())
+            {
+                if (posInfo->getBpm().hasValue())
+                {
+                    p.bpm = *posInfo->getBpm();
+                }
+            }
+        }
     }
-    rms = std::sqrt(rms / numSamples);
-    outputLevel.store(rms);
+
+    return p;
 }
 
-void FlarkDJProcessor::processAudio(float* leftIn, float* rightIn,
-                                   float* leftOut, float* rightOut, int numSamples)
+void FlarkDJProcessor::applyParameterChanges(const ParameterSnapshot& p)
 {
-    // Update effect parameters from UI
-    bool filterOn = filterEnabled->load() > 0.5f;
-    bool reverbOn = reverbEnabled->load() > 0.5f;
-    bool delayOn = delayEnabled->load() > 0.5f;
-    bool flangerOn = flangerEnabled->load() > 0.5f;
-    bool isolatorOn = isolatorEnabled->load() > 0.5f;
+    FLARKDJ_TRACE_SCOPE("parameterUpdate");
+
+    // Dirty flags: only groups whose values changed since the last block are
+    // pushed into the DSP objects. The filter cutoff is not part of this; it is
+    // applied at control rate together with the LFO in processAudio.
+    const auto& last = currentParams;
+    const bool force = parametersNeedFullUpdate;
+
+    const bool filterDirty = force
+        || p.filterResonance != last.filterResonance
+        || p.filterType != last.filterType;
+
+    const bool topologyDirty = force
+        || p.filterTopology != last.filterTopology;
+
+    const bool reverbDirty = force
+        || p.reverbRoomSize != last.reverbRoomSize
+        || p.reverbDamping != last.reverbDamping
+        || p.reverbWetDry != last.reverbWetDry;
+
+    const bool delayDirty = force
+        || p.delayTime != last.delayTime
+        || p.delayFeedback != last.delayFeedback
+        || p.delayWetDry != last.delayWetDry;
+
+    const bool flangerDirty = force
+        || p.flangerRate != last.flangerRate
+        || p.flangerDepth != last.flangerDepth
+        || p.flangerFeedback != last.flangerFeedback
+        || p.flangerWetDry != last.flangerWetDry;
+
+    const bool isolatorDirty = force
+        || p.isolatorPosition != last.isolatorPosition
+        || p.isolatorQ != last.isolatorQ;
+
+    const bool bandIsolatorDirty = force
+        || p.isolatorMode != last.isolatorMode
+        || p.isolatorLow != last.isolatorLow
+        || p.isolatorMid != last.isolatorMid
+        || p.isolatorHigh != last.isolatorHigh;
+
+    const bool lfoDirty = force
+        || p.lfoRate != last.lfoRate
+        || p.lfoWaveform != last.lfoWaveform
+        || p.lfoSync != last.lfoSync
+        || p.lfoSyncRate != last.lfoSyncRate
+        || p.bpm != last.bpm;
 
     // Update filter parameters
-    if (filterOn)
+    if (filterDirty)
     {
-        filterLeft.setCutoff(filterCutoff->load());
-        filterRight.setCutoff(filterCutoff->load());
-        filterLeft.setResonance(filterResonance->load());
-        filterRight.setResonance(filterResonance->load());
-
-        int filterTypeInt = static_cast<int>(filterType->load());
-        filterLeft.setType(static_cast<FlarkButterworthFilter::FilterType>(filterTypeInt));
-        filterRight.setType(static_cast<FlarkButterworthFilter::FilterType>(filterTypeInt));
+        filter.setType(static_cast<FlarkButterworthFilter::FilterType>(p.filterType));
+        filter.setResonance(p.filterResonance);
+        svfFilter.setType(static_cast<FlarkButterworthFilter::FilterType>(p.filterType));
+        svfFilter.setResonance(p.filterResonance);
+    }
+
+    // The filter that takes over starts from silence
+    if (topologyDirty)
+    {
+        filter.reset();
+        svfFilter.reset();
+        isolator.setTopology(p.filterTopology == FilterStateVariable ? FlarkMultichannelIsolator::StateVariable
+                                                                     : FlarkMultichannelIsolator::Biquad);
     }
 
     // Update reverb parameters
-    if (reverbOn)
+    if (reverbDirty)
     {
-        reverbLeft.setRoomSize(reverbRoomSize->load());
-        reverbRight.setRoomSize(reverbRoomSize->load());
-        reverbLeft.setDamping(reverbDamping->load());
-        reverbRight.setDamping(reverbDamping->load());
-        reverbLeft.setWetDryMix(reverbWetDry->load());
-        reverbRight.setWetDryMix(reverbWetDry->load());
+        reverb.setRoomSize(p.reverbRoomSize);
+        reverb.setDamping(p.reverbDamping);
+        reverb.setWetDryMix(p.reverbWetDry);
     }
 
     // Update delay parameters
-    if (delayOn)
+    if (delayDirty)
     {
-        delayLeft.setDelayTime(delayTime->load());
-        delayRight.setDelayTime(delayTime->load());
-        delayLeft.setFeedback(delayFeedback->load());
-        delayRight.setFeedback(delayFeedback->load());
-        delayLeft.setWetDryMix(delayWetDry->load());
-        delayRight.setWetDryMix(delayWetDry->load());
+        delay.setDelayTime(p.delayTime);
+        delay.setFeedback(p.delayFeedback);
+        delay.setWetDryMix(p.delayWetDry);
     }
 
     // Update flanger parameters
-    if (flangerOn)
+    if (flangerDirty)
     {
-        flangerLeft.setRate(flangerRate->load());
-        flangerRight.setRate(flangerRate->load());
-        flangerLeft.setDepth(flangerDepth->load());
-        flangerRight.setDepth(flangerDepth->load());
-        flangerLeft.setFeedback(flangerFeedback->load());
-        flangerRight.setFeedback(flangerFeedback->load());
-        flangerLeft.setWetDryMix(flangerWetDry->load());
-        flangerRight.setWetDryMix(flangerWetDry->load());
+        flanger.setRate(p.flangerRate);
+        flanger.setDepth(p.flangerDepth);
+        flanger.setFeedback(p.flangerFeedback);
+        flanger.setWetDryMix(p.flangerWetDry);
     }
 
     // Update isolator parameters
-    if (isolatorOn)
+    if (isolatorDirty)
     {
-        isolatorLeft.setPosition(isolatorPosition->load());
-        isolatorRight.setPosition(isolatorPosition->load());
-        isolatorLeft.setQ(isolatorQ->load());
-        isolatorRight.setQ(isolatorQ->load());
+        isolator.setPosition(p.isolatorPosition);
+        isolator.setQ(p.isolatorQ);
     }
 
-    // Update LFO parameters
-    lfo.setRate(lfoRate->load());
-    int lfoWaveformInt = static_cast<int>(lfoWaveform->load());
-    lfo.setWaveform(static_cast<FlarkLFO::Waveform>(lfoWaveformInt));
-
-    // BPM sync
-    bool syncEnabled = lfoSync->load() > 0.5f;
-    lfo.setSyncEnabled(syncEnabled);
-    if (syncEnabled)
+    // 3-band gains in dB; the bottom of the range is a full kill. The mode
+    // that takes over starts from clear filters at its target gains.
+    if (bandIsolatorDirty)
     {
-        auto playHead = getPlayHead();
-        if (playHead != nullptr)
+        const auto toGain = [](float db) { return juce::Decibels::decibelsToGain(db, isolatorKillDb); };
+        bandIsolator.setGains(toGain(p.isolatorLow), toGain(p.isolatorMid), toGain(p.isolatorHigh));
+
+        if (p.isolatorMode != last.isolatorMode)
         {
-            if (auto posInfo = playHead->getPosition())
-            {
-                if (posInfo->getBpm().hasValue())
-                {
-                    lfo.setBPM(*posInfo->getBpm());
-                }
-            }
+            isolator.reset();
+            bandIsolator.reset();
         }
-        int syncRateInt = static_cast<int>(lfoSyncRate->load());
-        lfo.setSyncRate(syncRateInt);
     }
 
-    // Process each sample
-    for (int i = 0; i < numSamples; ++i)
-    {
-        float leftSample = leftIn[i];
-        float rightSample = rightIn[i];
+    // Tail lengths follow the feedback, room and delay settings
+    const bool enablesChanged = force
+        || p.reverbOn != last.reverbOn
+        || p.delayOn != last.delayOn
+        || p.flangerOn != last.flangerOn;
 
-        // Get LFO value for modulation
-        float lfoValue = lfo.process();
-        float lfoDepthValue = lfoDepth->load();
+    const double sr = currentSampleRate;
 
-        // Apply filter with LFO modulation on cutoff
-        if (filterOn)
-        {
-            // LFO modulates cutoff with much wider range (up to 3x variation)
-            float cutoffMod = filterCutoff->load() * (1.0f + lfoValue * lfoDepthValue * 3.0f);
-            filterLeft.setCutoff(cutoffMod);
-            filterRight.setCutoff(cutoffMod);
+    if (reverbDirty)
+        reverbTail.setTailLength(juce::roundToInt(reverb.getTailLengthSeconds() * sr));
+    if (delayDirty)
+        delayTail.setTailLength(juce::roundToInt(delay.getTailLengthSeconds() * sr));
+    if (flangerDirty)
+        flangerTail.setTailLength(juce::roundToInt(flanger.getTailLengthSeconds() * sr));
 
-            leftSample = filterLeft.process(leftSample);
-            rightSample = filterRight.process(rightSample);
-        }
+    if (enablesChanged || reverbDirty || delayDirty || flangerDirty)
+    {
+        // The effects run in series, so their tails add up
+        double tail = 0.0;
+        if (p.reverbOn)  tail += reverb.getTailLengthSeconds();
+        if (p.delayOn)   tail += delay.getTailLengthSeconds();
+        if (p.flangerOn) tail += flanger.getTailLengthSeconds();
 
-        // Apply reverb
-        if (reverbOn)
+        if (tailLengthSeconds.exchange(tail) != tail)
         {
-            leftSample = reverbLeft.process(leftSample);
-            rightSample = reverbRight.process(rightSample);
+            tailLengthChanged = true;
+            triggerAsyncUpdate();
         }
+    }
+
+    // Update LFO parameters
+    if (lfoDirty)
+    {
+        lfo.setRate(p.lfoRate);
+        lfo.setWaveform(static_cast<FlarkLFO::Waveform>(p.lfoWaveform));
+        lfo.setSyncEnabled(p.lfoSync);
+        lfo.setBPM(p.bpm);
+        lfo.setSyncRate(p.lfoSyncRate);
+    }
+
+    currentParams = p;
+    parametersNeedFullUpdate = false;
+}
 
-        // Apply delay
-        if (delayOn)
+void FlarkDJProcessor::updateLimiter(int mode, float lookaheadMs)
+{
+    activeLimiterMode = mode;
+    lookaheadLimiter.setTruePeakEnabled(mode == LimiterTruePeak);
+    lookaheadLimiter.setLookahead(lookaheadMs);
+    setLatencySamples(mode == LimiterSoftClip ? 0 : lookaheadLimiter.getLatencySamples());
+}
+
+void FlarkDJProcessor::parameterChanged(const juce::String&, float)
+{
+    // May be called on any thread
+    limiterChanged = true;
+    triggerAsyncUpdate();
+}
+
+void FlarkDJProcessor::handleAsyncUpdate()
+{
+    // The limiter mode and lookahead change the latency and clear the
+    // lookahead delay, so they are applied here between blocks rather than
+    // from the audio thread
+    if (limiterChanged.exchange(false))
+    {
+        suspendProcessing(true);
+        updateLimiter(static_cast<int>(limiterMode->load()), limiterLookahead->load());
+        suspendProcessing(false);
+    }
+
+    // Hosts read getTailLengthSeconds again after a non-parameter change
+    if (tailLengthChanged.exchange(false))
+        updateHostDisplay(ChangeDetails().withNonParameterStateChanged(true));
+}
+
+//==============================================================================
+// Effect chain stages, in processing order. FlarkEffectChain builds one kernel
+// per combination of enable bits, so disabled effects cost nothing per block.
+void FlarkDJProcessor::FilterStage::process(FlarkDJProcessor& p, float* const* channels, int numChannels, int numSamples)
+{
+    const FlarkDJPerformanceMonitor::ScopedStage timing(p.performance, FlarkDJPerformanceMonitor::Filter);
+
+    const auto& params = p.currentParams;
+    const int interval = p.controlRateInterval.load();
+
+    // Get LFO values for modulation
+    p.lfo.processBlock(p.lfoBuffer.data(), numSamples);
+
+    // The state-variable filter follows the LFO every sample: the LFO values
+    // become cutoffs in place and the filter prewarps them four at a time
+    if (params.filterTopology == FilterStateVariable)
+    {
+        auto* cutoff = p.lfoBuffer.data();
+        const float depth = params.lfoDepth * 3.0f;
+
+        for (int i = 0; i < numSamples; ++i)
+            cutoff[i] = params.filterCutoff * (1.0f + cutoff[i] * depth);
+
+        p.svfFilter.processBlockModulated(channels, numChannels, cutoff, numSamples);
+        return;
+    }
+
+    // Apply filter with LFO modulation on cutoff. The cutoff is designed
+    // once per control period and the coefficients ramp in between.
+    float* period[FlarkChannelGroup::maxChannels];
+
+    for (int i = 0; i < numSamples; i += interval)
+    {
+        const int periodSize = juce::jmin(interval, numSamples - i);
+
+        // LFO modulates cutoff with much wider range (up to 3x variation).
+        // Use its value at the end of the period so the ramp tracks it.
+        const float lfoValue = p.lfoBuffer[static_cast<size_t>(i + periodSize - 1)];
+        const float cutoffMod = params.filterCutoff * (1.0f + lfoValue * params.lfoDepth * 3.0f);
+
+        p.filter.setCutoffSmoothed(cutoffMod, periodSize);
+        FlarkChannelGroup::offset(channels, numChannels, i, period);
+        p.filter.processBlock(period, numChannels, periodSize);
+    }
+}
+
+// Runs a decaying effect under its tail tracker. An enabled effect sleeps
+// once its input is silent and its tail has died away. A disabled effect is
+// fed silence and its tail is mixed into the signal until it has rung out,
+// then its state is cleared. In mono only the first channel runs and its
+// output is copied to the others; the state of the other channel groups sits
+// unused.
+template <typename Effect>
+static void processWithTail(Effect& effect, FlarkTailTracker& tracker, bool enabled, bool mono,
+                            float* const* channels, int numChannels, float* const* tail, int numSamples)
+{
+    const int numProcessed = mono ? 1 : numChannels;
+    const float inputPeak = enabled ? FlarkTailTracker::getPeak(channels, numProcessed, numSamples) : 0.0f;
+
+    if (! tracker.beginBlock(enabled, inputPeak, numSamples))
+        return;
+
+    if (enabled)
+    {
+        effect.processBlock(channels, numProcessed, numSamples);
+
+        for (int c = numProcessed; c < numChannels; ++c)
+            std::copy(channels[0], channels[0] + numSamples, channels[c]);
+
+        tracker.endBlock(FlarkTailTracker::getPeak(channels, numProcessed, numSamples));
+        return;
+    }
+
+    for (int c = 0; c < numProcessed; ++c)
+        std::fill_n(tail[c], numSamples, 0.0f);
+
+    effect.processBlock(tail, numProcessed, numSamples);
+
+    for (int c = 0; c < numChannels; ++c)
+    {
+        const float* source = tail[c < numProcessed ? c : 0];
+
+        for (int i = 0; i < numSamples; ++i)
+            channels[c][i] += source[i];
+    }
+
+    tracker.endBlock(FlarkTailTracker::getPeak(tail, numProcessed, numSamples));
+
+    if (! tracker.isActive())
+        effect.reset();
+}
+
+void FlarkDJProcessor::ReverbStage::process(FlarkDJProcessor& p, float* const* channels, int numChannels, int numSamples)
+{
+    const FlarkDJPerformanceMonitor::ScopedStage timing(p.performance, FlarkDJPerformanceMonitor::Reverb);
+    processWithTail(p.reverb, p.reverbTail, p.currentParams.reverbOn, p.monoChain,
+                    channels, numChannels, p.tailBuffer.getArrayOfWritePointers(), numSamples);
+}
+
+void FlarkDJProcessor::DelayStage::process(FlarkDJProcessor& p, float* const* channels, int numChannels, int numSamples)
+{
+    const FlarkDJPerformanceMonitor::ScopedStage timing(p.performance, FlarkDJPerformanceMonitor::Delay);
+    processWithTail(p.delay, p.delayTail, p.currentParams.delayOn, p.monoChain,
+                    channels, numChannels, p.tailBuffer.getArrayOfWritePointers(), numSamples);
+}
+
+void FlarkDJProcessor::FlangerStage::process(FlarkDJProcessor& p, float* const* channels, int numChannels, int numSamples)
+{
+    const FlarkDJPerformanceMonitor::ScopedStage timing(p.performance, FlarkDJPerformanceMonitor::Flanger);
+
+    // Every channel sweeps with the flanger's own LFO, which only advances
+    // while the flanger runs and restarts with it once a disabled tail has
+    // died and its state was cleared
+    processWithTail(p.flanger, p.flangerTail, p.currentParams.flangerOn, p.monoChain,
+                    channels, numChannels, p.tailBuffer.getArrayOfWritePointers(), numSamples);
+}
+
+void FlarkDJProcessor::IsolatorStage::process(FlarkDJProcessor& p, float* const* channels, int numChannels, int numSamples)
+{
+    const FlarkDJPerformanceMonitor::ScopedStage timing(p.performance, FlarkDJPerformanceMonitor::Isolator);
+
+    // DJ-style filter sweep, or low/mid/high kills
+    if (p.currentParams.isolatorMode == IsolatorThreeBand)
+        p.bandIsolator.processBlock(channels, numChannels, numSamples);
+    else
+        p.isolator.processBlock(channels, numChannels, numSamples);
+}
+
+void FlarkDJProcessor::LimiterStage::process(FlarkDJProcessor& p, float* const* channels, int numChannels, int numSamples)
+{
+    const FlarkDJPerformanceMonitor::ScopedStage timing(p.performance, FlarkDJPerformanceMonitor::Limiter);
+
+    // Brickwall limiting at -0.5dB (~0.95) to prevent clipping and channel
+    // muting in DAWs. Soft Clip is the zero-latency tanh saturator.
+    // Output metering rides along, so the block is only walked once.
+    if (p.activeLimiterMode == LimiterSoftClip)
+    {
+        for (int i = 0; i < numSamples; ++i)
         {
-            leftSample = delayLeft.process(leftSample);
-            rightSample = delayRight.process(rightSample);
+            for (int c = 0; c < numChannels; ++c)
+                channels[c][i] = p.limiter.process(channels[c][i]);
+
+            p.meter.process(channels, i);
         }
+    }
+    else
+    {
+        FlarkChannelGroup groups[FlarkChannelGroup::maxGroups];
+        const int numGroups = FlarkChannelGroup::split(channels, numChannels, groups);
+        FlarkFloat4 frames[FlarkChannelGroup::maxGroups];
 
-        // Apply flanger
-        if (flangerOn)
+        for (int i = 0; i < numSamples; ++i)
         {
-            leftSample = flangerLeft.process(leftSample);
-            rightSample = flangerRight.process(rightSample);
+            for (int g = 0; g < numGroups; ++g)
+                frames[g] = groups[g].load(i);
+
+            p.lookaheadLimiter.process(frames, numChannels);
+
+            for (int g = 0; g < numGroups; ++g)
+                groups[g].store(frames[g], i);
+
+            p.meter.process(channels, i);
         }
+    }
+}
+
+using FlarkDJChain = FlarkEffectChain<FlarkDJProcessor, FlarkDJProcessor::ChainStages>;
 
-        // Apply isolator (DJ-style filter sweep)
-        if (isolatorOn)
+void FlarkDJProcessor::processAudio(float* const* channels, int numChannels, int numSamples)
+{
+    // Read every parameter once per block and push only what changed
+    const auto params = loadParameterSnapshot(getPlayHead());
+    applyParameterChanges(params);
+
+    // Pick the kernel for the enabled effects once per block. Disabled
+    // effects whose tail is still ringing out stay in the chain.
+    const unsigned enabledMask = (params.filterOn   ? FilterStage::bit   : 0u)
+                               | (params.reverbOn  || reverbTail.isActive()  ? ReverbStage::bit  : 0u)
+                               | (params.delayOn   || delayTail.isActive()   ? DelayStage::bit   : 0u)
+                               | (params.flangerOn || flangerTail.isActive() ? FlangerStage::bit : 0u)
+                               | (params.isolatorOn ? IsolatorStage::bit : 0u);
+    lastEnabledMask = enabledMask;
+
+    // Input matching on every channel runs the per-channel effects once, but
+    // that only saves work past the first channel group: up to four channels
+    // cost one pass either way. Leaving mono, the other groups pick up from
+    // the first so the switch is seamless.
+    const bool useMono = FlarkChannelGroup::getNumGroups(numChannels) > 1 && monoFastPathEnabled.load();
+    const bool mono = useMono && monoDetector.beginBlock(channels, numChannels, numSamples);
+    if (monoChain && ! mono)
+        copyFirstGroupEffects(enabledMask);
+    monoChain = mono;
+
+    if (mono)
+        monoBlocks.fetch_add(1, std::memory_order_relaxed);
+
+    // Effects run one after another over whole buffers, so each effect keeps
+    // its state in registers for the length of a chunk. Chunks are bounded by
+    // the scratch buffer allocated in prepareToPlay.
+    const int maxChunkSize = static_cast<int>(lfoBuffer.size());
+    float* chunk[FlarkChannelGroup::maxChannels];
+
+    for (int start = 0; start < numSamples; start += maxChunkSize)
+    {
+        const int chunkSize = juce::jmin(maxChunkSize, numSamples - start);
+        FlarkChannelGroup::offset(channels, numChannels, start, chunk);
+        FlarkDJChain::process(enabledMask, *this, chunk, numChannels, chunkSize);
+    }
+
+    if (useMono && ! mono)
+        monoDetector.endBlock(channels, numChannels, numSamples);
+}
+
+// Only effects in the chain can hold state; the others were cleared together.
+// In mono the first group's spare lanes carried the first channel, so the
+// whole group holds its state.
+void FlarkDJProcessor::copyFirstGroupEffects(unsigned enabledMask)
+{
+    for (int g = 1; g < FlarkChannelGroup::getNumGroups(currentNumChannels); ++g)
+    {
+        if ((enabledMask & ReverbStage::bit) != 0)
+            reverb.copyGroupState(0, g);
+        if ((enabledMask & DelayStage::bit) != 0)
+            delay.copyGroupState(0, g);
+        if ((enabledMask & FlangerStage::bit) != 0)
+            flanger.copyGroupState(0, g);
+    }
+}
+
+void FlarkDJProcessor::setControlRateInterval(int numSamples)
+{
+    controlRateInterval.store(juce::jlimit(1, maxControlRateInterval, numSamples));
+    capture.recordControlRate(controlRateInterval.load());
+}
+
+//==============================================================================
+juce::String FlarkDJProcessor::getPerformanceReport()
+{
+    using Monitor = FlarkDJPerformanceMonitor;
+    const auto stats = performance.getSnapshot();
+
+    juce::String text;
+    auto metric = [&text](const char* name, const char* type, const char* help)
+    {
+        text << "# HELP " << name << " " << help << "\n# TYPE " << name << " " << type << "\n";
+    };
+
+    metric("flarkdj_blocks_total", "counter", "Audio blocks processed");
+    text << "flarkdj_blocks_total " << stats.numBlocks << "\n";
+
+    metric("flarkdj_overruns_total", "counter", "Blocks that took longer than their buffer duration");
+    text << "flarkdj_overruns_total " << stats.numOverruns << "\n";
+
+    metric("flarkdj_mono_blocks_total", "counter", "Blocks whose per-channel effects ran once for mono input");
+    text << "flarkdj_mono_blocks_total " << monoBlocks.load() << "\n";
+
+    metric("flarkdj_sample_rate_hz", "gauge", "Current sample rate");
+    text << "flarkdj_sample_rate_hz " << stats.sampleRate << "\n";
+
+    metric("flarkdj_block_load_ratio", "gauge", "Block processing time / buffer duration");
+    text << "flarkdj_block_load_ratio{stat=\"last\"} " << stats.lastLoad << "\n"
+         << "flarkdj_block_load_ratio{stat=\"recent\"} " << stats.recentLoad << "\n"
+         << "flarkdj_block_load_ratio{stat=\"mean\"} " << stats.getMeanLoad() << "\n"
+         << "flarkdj_block_load_ratio{stat=\"max\"} " << stats.maxLoad << "\n";
+
+    metric("flarkdj_block_load", "histogram", "Distribution of block load; a load of 1 or more is an overrun");
+    juce::int64 cumulative = 0;
+    for (int i = 0; i < Monitor::numLoadBuckets; ++i)
+    {
+        cumulative += stats.loadHistogram[i];
+        const juce::String le = i < Monitor::numLoadBuckets - 1 ? juce::String(Monitor::loadBucketEdges[i]) : "+Inf";
+        text << "flarkdj_block_load_bucket{le=\"" << le << "\"} " << cumulative << "\n";
+    }
+    text << "flarkdj_block_load_sum " << stats.loadSum << "\n"
+         << "flarkdj_block_load_count " << stats.numBlocks << "\n";
+
+    metric("flarkdj_stage_seconds_total", "counter", "Time spent in each processing stage");
+    for (int i = 0; i < Monitor::numStages; ++i)
+        text << "flarkdj_stage_seconds_total{stage=\"" << Monitor::getStageName(i) << "\"} "
+             << stats.stageTotalSeconds[i] << "\n";
+
+    metric("flarkdj_stage_max_seconds", "gauge", "Longest time one block spent in each stage");
+    for (int i = 0; i < Monitor::numStages; ++i)
+        text << "flarkdj_stage_max_seconds{stage=\"" << Monitor::getStageName(i) << "\"} "
+             << stats.stageMaxSeconds[i] << "\n";
+
+    const auto& worst = stats.worstOverrun;
+    if (worst.block >= 0)
+    {
+        metric("flarkdj_worst_overrun_load_ratio", "gauge", "Load of the worst overrun");
+        text << "flarkdj_worst_overrun_load_ratio{block=\"" << worst.block << "\",samples=\""
+             << worst.numSamples << "\"} " << worst.load << "\n";
+
+        metric("flarkdj_worst_overrun_stage_seconds", "gauge", "Stage times in the worst overrun");
+        for (int i = 0; i < Monitor::numStages; ++i)
+            text << "flarkdj_worst_overrun_stage_seconds{stage=\"" << Monitor::getStageName(i) << "\"} "
+                 << worst.stageSeconds[i] << "\n";
+
+        // The settings that were in place, in the parameters' own units
+        metric("flarkdj_worst_overrun_parameter", "gauge", "Parameter values during the worst overrun");
+        const auto& params = AudioProcessor::getParameters();
+        for (int i = 0; i < juce::jmin(worst.numParameters, params.size()); ++i)
         {
-            leftSample = isolatorLeft.process(leftSample);
-            rightSample = isolatorRight.process(rightSample);
+            if (auto* param = dynamic_cast<juce::RangedAudioParameter*>(params[i]))
+                text << "flarkdj_worst_overrun_parameter{name=\"" << param->getParameterID() << "\"} "
+                     << param->convertFrom0to1(worst.parameterValues[i]) << "\n";
         }
+    }
 
-        // ========== OUTPUT LIMITER ==========
-        // Soft limiting to prevent clipping and channel muting in DAWs
-        // Uses tanh for smooth saturation with threshold at -0.5dB (~0.95)
-        const float threshold = 0.95f;
-        const float makeup = 1.0f / threshold; // Compensate for threshold reduction
+    return text;
+}
 
-        // Soft clip using tanh for smooth saturation
-        leftSample = std::tanh(leftSample * makeup) * threshold;
-        rightSample = std::tanh(rightSample * makeup) * threshold;
+bool FlarkDJProcessor::startCapture(const juce::File& file)
+{
+    // Already prepared by the host: the capture starts with the current
+    // settings, but the effects may still hold audio from before it
+    const bool midSession = getSampleRate() > 0.0;
 
-        // Write to output
-        leftOut[i] = leftSample;
-        rightOut[i] = rightSample;
-    }
+    if (! capture.start(file, midSession))
+        return false;
+
+    if (midSession)
+        capture.recordPrepare(currentSampleRate, currentBlockSize, controlRateInterval.load());
+
+    return true;
 }
 
 //==============================================================================
@@ -355,6 +915,8 @@ juce::AudioProcessorEditor* FlarkDJProcessor::createEditor()
 //==============================================================================
 void FlarkDJProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
+    FLARKDJ_TRACE_SCOPE("getStateInformation");
+
     auto state = parameters.copyState();
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
     copyXmlToBinary(*xml, destData);
@@ -362,11 +924,31 @@ void FlarkDJProcessor::getStateInformation(juce::MemoryBlock& destData)
 
 void FlarkDJProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    FLARKDJ_TRACE_SCOPE("setStateInformation");
+
+    capture.recordStateRestore(data, sizeInBytes);
+
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
     if (xmlState.get() != nullptr)
+    {
         if (xmlState->hasTagName(parameters.state.getType()))
-            parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
+        {
+            auto state = juce::ValueTree::fromXml(*xmlState);
+
+            // Sessions saved before the limiter modes existed ran the soft
+            // clipper, not the lookahead limiter that new instances default to
+            if (! state.getChildWithProperty("id", "limiterMode").isValid())
+            {
+                juce::ValueTree limiterMode("PARAM");
+                limiterMode.setProperty("id", "limiterMode", nullptr);
+                limiterMode.setProperty("value", static_cast<int>(LimiterSoftClip), nullptr);
+                state.appendChild(limiterMode, nullptr);
+            }
+
+            parameters.replaceState(state);
+        }
+    }
 }
 
 //==============================================================================
@@ -392,7 +974,8 @@ bool FlarkDJProcessor::isMidiEffect() const
 
 double FlarkDJProcessor::getTailLengthSeconds() const
 {
-    return 4.0; // 4 seconds for reverb tail
+    // Computed from the current settings of the enabled effects
+    return tailLengthSeconds.load();
 }
 
 //==============================================================================
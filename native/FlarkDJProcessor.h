@@ -2,7 +2,13 @@
 
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <memory>
+#include <tuple>
+#include "FlarkDJCapture.h"
 #include "FlarkDJDSP.h"
+#include "FlarkDJMetering.h"
+#include "FlarkDJPerformance.h"
+#include "FlarkDJPerformanceExporter.h"
+#include "FlarkDJSpectrumAnalyzer.h"
 
 /**
  * FlarkDJ Native Audio Processor
@@ -18,7 +24,9 @@
  * - AAX SDK (for AAX, requires Avid Developer account)
  */
 
-class FlarkDJProcessor : public juce::AudioProcessor
+class FlarkDJProcessor : public juce::AudioProcessor,
+                         private juce::AudioProcessorValueTreeState::Listener,
+                         private juce::AsyncUpdater
 {
 public:
     FlarkDJProcessor();
@@ -28,6 +36,7 @@ public:
     // AudioProcessor overrides
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+    void reset() override;
 
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 
@@ -60,15 +69,124 @@ public:
     // Parameter management
     juce::AudioProcessorValueTreeState& getParameters() { return parameters; }
 
-    // Get current output RMS level for spectrum display (0.0 to 1.0)
+    // Get current output RMS level for spectrum display (0.0 to 1.0), over
+    // the meter's 300 ms window
     float getOutputLevel() const { return outputLevel.load(); }
 
+    // Peak, true-peak, RMS and loudness of the output (see FlarkDJMetering.h).
+    // Call from one thread at a time.
+    FlarkDJMeter::Readings getMeterReadings() { return meter.getReadings(); }
+    void resetLoudness() { meter.resetLoudness(); }
+
+    // FFT of the output, analysed off the audio thread while active
+    FlarkDJSpectrumAnalyzer& getSpectrumAnalyzer() { return spectrumAnalyzer; }
+
+    // Control rate for filter coefficient updates, in samples (1 to 256).
+    // Coefficients are ramped linearly between updates.
+    void setControlRateInterval(int numSamples);
+    int getControlRateInterval() const { return controlRateInterval.load(); }
+
+    // True while the reverb, delay or flanger still has audible output after
+    // its input went silent. Call from the processing thread (offline renders
+    // use it to flush the tail).
+    bool isTailRinging() const
+    {
+        return reverbTail.isActive() || delayTail.isActive() || flangerTail.isActive();
+    }
+
+    // The mono fast path for layouts past four channels (see monoDetector) is
+    // on by default; tests turn it off to compare with every channel processed
+    void setMonoFastPathEnabled(bool shouldBeEnabled) { monoFastPathEnabled.store(shouldBeEnabled); }
+    juce::int64 getNumMonoBlocks() const { return monoBlocks.load(); }
+
+    //==============================================================================
+    // Performance counters per stage and per block (see FlarkDJPerformance.h).
+    // The snapshot can be taken from any thread.
+    FlarkDJPerformanceMonitor::Snapshot getPerformanceSnapshot() { return performance.getSnapshot(); }
+    void resetPerformanceStats() { performance.reset(); }
+
+    // The counters as Prometheus-style text, including the parameter values
+    // in place during the worst overrun
+    juce::String getPerformanceReport();
+
+    // Numbers the processors of this process from 1. The report is published
+    // as instance="N" by the process-wide FlarkDJPerformanceExporter when
+    // FLARKDJ_STATS_FILE or FLARKDJ_STATS_SOCKET is set.
+    int getInstanceId() const { return instanceId; }
+
+    // Records the session for FlarkDJReplay (see FlarkDJCapture.h). Started
+    // from the constructor when FLARKDJ_CAPTURE_FILE is set, into this
+    // instance's file beside it (FlarkDJCaptureRecorder::getInstanceFile).
+    bool startCapture(const juce::File& file);
+    void stopCapture() { capture.stop(); }
+    bool isCapturing() const { return capture.isRecording(); }
+
+    //==============================================================================
+    // Effect chain stages, in processing order (see FlarkDJEffectChain.h)
+    struct FilterStage   { static constexpr unsigned bit = 1u << 0; static void process(FlarkDJProcessor&, float* const*, int, int); };
+    struct ReverbStage   { static constexpr unsigned bit = 1u << 1; static void process(FlarkDJProcessor&, float* const*, int, int); };
+    struct DelayStage    { static constexpr unsigned bit = 1u << 2; static void process(FlarkDJProcessor&, float* const*, int, int); };
+    struct FlangerStage  { static constexpr unsigned bit = 1u << 3; static void process(FlarkDJProcessor&, float* const*, int, int); };
+    struct IsolatorStage { static constexpr unsigned bit = 1u << 4; static void process(FlarkDJProcessor&, float* const*, int, int); };
+    struct LimiterStage  { static constexpr unsigned bit = 0;       static void process(FlarkDJProcessor&, float* const*, int, int); };
+
+    using ChainStages = std::tuple<FilterStage, ReverbStage, DelayStage, FlangerStage, IsolatorStage, LimiterStage>;
+
+    // Values of the "limiterMode" parameter
+    enum LimiterMode { LimiterSoftClip = 0, LimiterLookahead, LimiterTruePeak };
+
+    // Values of the "filterTopology" parameter (filter and isolator)
+    enum FilterTopology { FilterBiquad = 0, FilterStateVariable };
+
+    // Values of the "isolatorMode" parameter
+    enum IsolatorMode { IsolatorSweep = 0, IsolatorThreeBand };
+    static constexpr float isolatorKillDb = -40.0f;  // 3-band gain that mutes the band
+
 private:
+    //==============================================================================
+    // Plain copy of every parameter, taken once per block
+    struct ParameterSnapshot
+    {
+        bool filterOn = false;
+        float filterCutoff = 0.0f, filterResonance = 0.0f;
+        int filterType = 0;
+        int filterTopology = 0;
+
+        bool reverbOn = false;
+        float reverbRoomSize = 0.0f, reverbDamping = 0.0f, reverbWetDry = 0.0f;
+
+        bool delayOn = false;
+        float delayTime = 0.0f, delayFeedback = 0.0f, delayWetDry = 0.0f;
+
+        bool flangerOn = false;
+        float flangerRate = 0.0f, flangerDepth = 0.0f, flangerFeedback = 0.0f, flangerWetDry = 0.0f;
+
+        bool isolatorOn = false;
+        float isolatorPosition = 0.0f, isolatorQ = 0.0f;
+        int isolatorMode = 0;
+        float isolatorLow = 0.0f, isolatorMid = 0.0f, isolatorHigh = 0.0f;   // dB
+
+        float lfoRate = 0.0f, lfoDepth = 0.0f;
+        int lfoWaveform = 0;
+        bool lfoSync = false;
+        int lfoSyncRate = 0;
+        double bpm = 120.0;
+    };
+
+    // The BPM is read from playHead when the LFO is synced and it is not null
+    ParameterSnapshot loadParameterSnapshot(juce::AudioPlayHead* playHead);
+    void applyParameterChanges(const ParameterSnapshot& params);
+    // Sets the limiter mode and lookahead and reports the latency. Called from
+    // prepareToPlay, or from handleAsyncUpdate with processing suspended.
+    void updateLimiter(int mode, float lookaheadMs);
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void handleAsyncUpdate() override;
+    void copyFirstGroupEffects(unsigned enabledMask);
+
     //==============================================================================
     // FlarkDJ engine interface
     void initializeFlarkDJ();
-    void processAudio(float* leftIn, float* rightIn,
-                     float* leftOut, float* rightOut, int numSamples);
+    void processAudio(float* const* channels, int numChannels, int numSamples);
 
     //==============================================================================
     // Parameters
@@ -78,6 +196,7 @@ private:
     std::atomic<float>* filterCutoff = nullptr;
     std::atomic<float>* filterResonance = nullptr;
     std::atomic<float>* filterType = nullptr;
+    std::atomic<float>* filterTopology = nullptr;
 
     std::atomic<float>* reverbEnabled = nullptr;
     std::atomic<float>* reverbRoomSize = nullptr;
@@ -107,22 +226,75 @@ private:
     std::atomic<float>* isolatorEnabled = nullptr;
     std::atomic<float>* isolatorPosition = nullptr;
     std::atomic<float>* isolatorQ = nullptr;
+    std::atomic<float>* isolatorMode = nullptr;
+    std::atomic<float>* isolatorLow = nullptr;
+    std::atomic<float>* isolatorMid = nullptr;
+    std::atomic<float>* isolatorHigh = nullptr;
+
+    std::atomic<float>* limiterMode = nullptr;
+    std::atomic<float>* limiterLookahead = nullptr;
 
     //==============================================================================
     // Audio processing state
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
+    int currentNumChannels = 2;  // main bus, input and output alike
     std::atomic<float> outputLevel{0.0f};
+    FlarkDJMeter meter;  // fed every channel sample by sample from the limiter stage
+    FlarkDJSpectrumAnalyzer spectrumAnalyzer;
+
+    // Per-block LFO values, sized in prepareToPlay
+    std::vector<float> lfoBuffer;
+
+    // Tail tracking for the decaying effects (see FlarkTailTracker)
+    FlarkTailTracker reverbTail, delayTail, flangerTail;
+    juce::AudioBuffer<float> tailBuffer;
+    std::atomic<double> tailLengthSeconds{0.0};
+
+    // Work for handleAsyncUpdate: a limiter change to apply, and a tail
+    // length change to report to the host
+    std::atomic<bool> limiterChanged{false};
+    std::atomic<bool> tailLengthChanged{false};
+
+    // Mono fast path for layouts of more than one channel group (5.1, 7.1):
+    // while every input channel matches, the reverb, delay and flanger run on
+    // the first channel only and the result is copied to the others
+    FlarkMonoDetector monoDetector;
+    bool monoChain = false;
+    std::atomic<bool> monoFastPathEnabled{true};
+    std::atomic<juce::int64> monoBlocks{0};
+
+    // Parameter values last pushed into the DSP objects
+    ParameterSnapshot currentParams;
+    bool parametersNeedFullUpdate = true;
+
+    static constexpr int maxControlRateInterval = 256;
+    std::atomic<int> controlRateInterval{32};
 
     //==============================================================================
     // FlarkDJ DSP components (pure C++ implementations)
-    // Stereo processing - one instance per channel
-    FlarkButterworthFilter filterLeft, filterRight;  // Upgraded to steep Butterworth
-    FlarkReverb reverbLeft, reverbRight;
-    FlarkDelay delayLeft, delayRight;
-    FlarkFlanger flangerLeft, flangerRight;
-    FlarkIsolator isolatorLeft, isolatorRight;  // New DJ isolator effect
+    // Every effect processes all channels of the layout, four at a time
+    // (see FlarkChannelGroup); filters and the limiter are linked
+    FlarkMultichannelButterworthFilter filter;  // Upgraded to steep Butterworth
+    FlarkMultichannelSVF svfFilter;             // the "State Variable" topology
+    FlarkReverb reverb;
+    FlarkDelay delay;
+    FlarkFlanger flanger;                    // one sweep for all channels
+    FlarkMultichannelIsolator isolator;  // New DJ isolator effect
+    FlarkThreeBandIsolator bandIsolator;     // "3-Band" isolator mode
     FlarkLFO lfo;
+    FlarkSoftLimiter limiter;                // "Soft Clip" mode, no latency
+    FlarkLookaheadLimiter lookaheadLimiter;  // the other modes
+    int activeLimiterMode = LimiterLookahead;  // as last passed to updateLimiter
+
+    //==============================================================================
+    // Instrumentation
+    FlarkDJPerformanceMonitor performance;
+    unsigned lastEnabledMask = 0;  // stages run in the current block
+    const int instanceId;
+    juce::SharedResourcePointer<FlarkDJPerformanceExporter> performanceExporter;
+    FlarkDJCaptureRecorder capture { parameters };
+    FLARKDJ_TRACE_SESSION;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FlarkDJProcessor)
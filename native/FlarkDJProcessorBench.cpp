@@ -0,0 +1,280 @@
+#include <chrono>
+#include <iostream>
+#include "FlarkDJProcessor.h"
+
+/**
+ * FlarkDJProcessorBench - end-to-end callback benchmark
+ *
+ * Drives a FlarkDJProcessor the way a host does: prepareToPlay, then one
+ * processBlock per buffer, with automated parameters changed before every
+ * callback. Scenarios cover every combination of the five effect enable
+ * flags at each sample rate and block size. For each one it reports the mean,
+ * 99th percentile and worst callback time as a fraction of the buffer
+ * deadline (blockSize / sampleRate), since dropouts come from the slow
+ * callbacks, not the average. --channels picks the layout (1, 2, 4, 6 for
+ * 5.1 or 8 for 7.1; stereo by default). --mono-input feeds the same noise to
+ * every channel, which puts 5.1 and 7.1 on the processor's mono fast path.
+ *
+ *   FlarkDJProcessorBench [--output <file.json>] [--quick] [--pin <cpu>]
+ *                         [--sample-rates 44100,48000] [--block-sizes 64,512]
+ *                         [--masks 0,31] [--seconds <audio per scenario>]
+ *                         [--channels <n>] [--mono-input]
+ *
+ * Mask bits: 1 filter, 2 reverb, 4 delay, 8 flanger, 16 isolator.
+ */
+
+namespace
+{
+    const char* const enableParameters[] = {
+        "filterEnabled", "reverbEnabled", "delayEnabled", "flangerEnabled", "isolatorEnabled"
+    };
+
+    const char* const effectNames[] = { "filter", "reverb", "delay", "flanger", "isolator" };
+
+    // Parameters swept by the automation, changed before every callback
+    const char* const automatedParameters[] = {
+        "filterCutoff", "filterResonance", "reverbRoomSize", "reverbDamping", "delayTime",
+        "delayFeedback", "flangerRate", "flangerDepth", "isolatorPosition", "lfoRate"
+    };
+
+    // Sets a parameter as a plugin wrapper does for host automation
+    void setParameter(juce::AudioProcessorValueTreeState& parameters, const char* id, float normalisedValue)
+    {
+        if (auto* param = parameters.getParameter(id))
+        {
+            param->setValue(normalisedValue);
+            param->sendValueChangedMessageToListeners(normalisedValue);
+        }
+    }
+
+    juce::String describeMask(unsigned mask)
+    {
+        juce::StringArray names;
+        for (int i = 0; i < 5; ++i)
+            if ((mask & (1u << i)) != 0)
+                names.add(effectNames[i]);
+
+        return names.isEmpty() ? juce::String("none") : names.joinIntoString("+");
+    }
+
+    template <typename T>
+    juce::Array<T> parseList(const juce::String& text)
+    {
+        juce::Array<T> values;
+        for (auto& token : juce::StringArray::fromTokens(text, ",", {}))
+            values.add(static_cast<T>(token.trim().getDoubleValue()));
+        return values;
+    }
+
+    struct Stats
+    {
+        int numCallbacks = 0;
+        double meanLoad = 0.0;  // callback time / buffer deadline
+        double p99Load = 0.0;
+        double maxLoad = 0.0;
+    };
+
+    Stats runScenario(FlarkDJProcessor& processor, double sampleRate, int blockSize, unsigned mask,
+                      double secondsOfAudio, int minCallbacks, bool monoInput)
+    {
+        auto& parameters = processor.getParameters();
+
+        for (int i = 0; i < 5; ++i)
+            setParameter(parameters, enableParameters[i], (mask & (1u << i)) != 0 ? 1.0f : 0.0f);
+
+        processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+        processor.reset();
+
+        const int numChannels = processor.getTotalNumOutputChannels();
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random(1);
+
+        const int numCallbacks = juce::jmax(minCallbacks, juce::roundToInt(secondsOfAudio * sampleRate / blockSize));
+        const int numWarmUpCallbacks = 8;
+        const double deadlineNs = blockSize / sampleRate * 1.0e9;
+
+        std::vector<double> loads;
+        loads.reserve(static_cast<size_t>(numCallbacks));
+
+        for (int callback = 0; callback < numWarmUpCallbacks + numCallbacks; ++callback)
+        {
+            // Fresh noise at -12 dBFS, as the host's input buffer would be
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                auto* data = buffer.getWritePointer(ch);
+                for (int i = 0; i < blockSize; ++i)
+                    data[i] = (random.nextFloat() * 2.0f - 1.0f) * 0.25f;
+            }
+
+            if (monoInput)
+                for (int ch = 1; ch < numChannels; ++ch)
+                    buffer.copyFrom(ch, 0, buffer, 0, 0, blockSize);
+
+            const auto start = std::chrono::steady_clock::now();
+
+            // Automation lands at the start of the callback, as in a VST3 process() call
+            const double automationPhase = callback * 0.05;
+            for (int i = 0; i < juce::numElementsInArray(automatedParameters); ++i)
+                setParameter(parameters, automatedParameters[i],
+                             static_cast<float>(0.5 + 0.4 * std::sin(automationPhase + i)));
+
+            processor.processBlock(buffer, midi);
+
+            const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+
+            if (callback >= numWarmUpCallbacks)
+                loads.push_back(elapsed.count() / deadlineNs);
+        }
+
+        processor.releaseResources();
+
+        Stats stats;
+        stats.numCallbacks = numCallbacks;
+
+        for (auto load : loads)
+            stats.meanLoad += load;
+        stats.meanLoad /= static_cast<double>(loads.size());
+
+        std::sort(loads.begin(), loads.end());
+        stats.p99Load = loads[static_cast<size_t>(std::ceil(0.99 * static_cast<double>(loads.size()))) - 1];
+        stats.maxLoad = loads.back();
+        return stats;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // The processor's parameter tree expects JUCE's message manager to exist
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h"))
+    {
+        std::cout << "Usage: FlarkDJProcessorBench [--output <file.json>] [--quick] [--pin <cpu>]\n"
+                     "                             [--sample-rates <list>] [--block-sizes <list>]\n"
+                     "                             [--masks <list>] [--seconds <audio per scenario>]\n"
+                     "                             [--channels <n>] [--mono-input]\n";
+        return 0;
+    }
+
+    const bool quick = args.containsOption("--quick");
+    const bool monoInput = args.containsOption("--mono-input");
+
+    juce::Array<double> sampleRates { 44100.0, 48000.0, 96000.0, 192000.0 };
+    juce::Array<int> blockSizes { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    juce::Array<unsigned> masks;
+    for (unsigned mask = 0; mask < 32; ++mask)
+        masks.add(mask);
+
+    if (args.containsOption("--sample-rates"))
+        sampleRates = parseList<double>(args.getValueForOption("--sample-rates"));
+    if (args.containsOption("--block-sizes"))
+        blockSizes = parseList<int>(args.getValueForOption("--block-sizes"));
+    if (args.containsOption("--masks"))
+        masks = parseList<unsigned>(args.getValueForOption("--masks"));
+
+    double secondsOfAudio = quick ? 0.25 : 2.0;
+    if (args.containsOption("--seconds"))
+        secondsOfAudio = args.getValueForOption("--seconds").getDoubleValue();
+
+    const int minCallbacks = quick ? 100 : 500;
+
+    if (args.containsOption("--pin"))
+    {
+        const int core = args.getValueForOption("--pin").getIntValue();
+        if (juce::isPositiveAndBelow(core, 32))
+            juce::Thread::setCurrentThreadAffinityMask(1u << core);
+    }
+
+    FlarkDJProcessor processor;
+
+    const int numChannels = args.containsOption("--channels") ? args.getValueForOption("--channels").getIntValue() : 2;
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+    layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+
+    if (! processor.setBusesLayout(layout))
+    {
+        std::cerr << "Unsupported channel count: " << numChannels << std::endl;
+        return 1;
+    }
+
+    juce::Array<juce::var> results;
+    Stats worst;
+    juce::String worstScenario;
+
+    for (auto sampleRate : sampleRates)
+    {
+        for (auto blockSize : blockSizes)
+        {
+            for (auto mask : masks)
+            {
+                const auto stats = runScenario(processor, sampleRate, blockSize, mask & 31u,
+                                               secondsOfAudio, minCallbacks, monoInput);
+
+                auto* result = new juce::DynamicObject();
+                result->setProperty("sampleRate", sampleRate);
+                result->setProperty("blockSize", blockSize);
+                result->setProperty("mask", static_cast<int>(mask & 31u));
+                result->setProperty("effects", describeMask(mask & 31u));
+                result->setProperty("callbacks", stats.numCallbacks);
+                result->setProperty("meanLoad", stats.meanLoad);
+                result->setProperty("p99Load", stats.p99Load);
+                result->setProperty("maxLoad", stats.maxLoad);
+                results.add(juce::var(result));
+
+                const auto scenario = juce::String(sampleRate / 1000.0, 1) + " kHz, " + juce::String(blockSize)
+                                    + " samples, " + describeMask(mask & 31u);
+
+                std::cerr << scenario << ": mean " << juce::String(stats.meanLoad * 100.0, 2)
+                          << "%, p99 " << juce::String(stats.p99Load * 100.0, 2)
+                          << "%, worst " << juce::String(stats.maxLoad * 100.0, 2) << "% of deadline" << std::endl;
+
+                if (stats.maxLoad > worst.maxLoad)
+                {
+                    worst = stats;
+                    worstScenario = scenario;
+                }
+            }
+        }
+    }
+
+    std::cerr << "Worst callback: " << juce::String(worst.maxLoad * 100.0, 2) << "% of deadline ("
+              << worstScenario << ")" << std::endl;
+
+    auto* report = new juce::DynamicObject();
+    report->setProperty("benchmark", "FlarkDJProcessorBench");
+    report->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(true));
+   #if JUCE_DEBUG
+    report->setProperty("config", "debug");
+   #else
+    report->setProperty("config", "release");
+   #endif
+    report->setProperty("cpu", juce::SystemStats::getCpuModel());
+    report->setProperty("secondsPerScenario", secondsOfAudio);
+    report->setProperty("channels", numChannels);
+    report->setProperty("monoInput", monoInput);
+    report->setProperty("results", results);
+
+    const auto json = juce::JSON::toString(juce::var(report));
+
+    if (args.containsOption("--output"))
+    {
+        const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+
+        if (! file.replaceWithText(json))
+        {
+            std::cerr << "Cannot write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+    else
+    {
+        std::cout << json << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include <atomic>
+#include <iostream>
+#include "FlarkDJOfflineRenderer.h"
+#include "FlarkDJWorkStealingPool.h"
+
+/**
+ * FlarkDJRender - headless batch renderer
+ *
+ * Renders every WAV/FLAC file in a directory through FlarkDJ, spread across a
+ * work-stealing thread pool with one processor per worker. Needs no audio
+ * device and no display.
+ *
+ *   FlarkDJRender --input <dir> --output <dir> [--preset <file.fxp>]
+ *                 [--threads <n>] [--block-size <n>] [--pin <cpu,cpu,...>]
+ *                 [--format wav|flac]
+ */
+
+static void printUsage()
+{
+    std::cout << "Usage: FlarkDJRender --input <dir> --output <dir> [options]\n\n"
+                 "Options:\n"
+                 "  --preset <file.fxp>   Preset saved by the plugin (default parameters if omitted)\n"
+                 "  --threads <n>         Worker threads (default: number of CPU cores)\n"
+                 "  --block-size <n>      Processing block size in samples (default: 512)\n"
+                 "  --pin <cpu,cpu,...>   Pin worker i to the i-th listed CPU (0-31)\n"
+                 "  --format wav|flac     Output format (default: same as each input file)\n";
+}
+
+static juce::File resolvePath(const juce::String& path)
+{
+    return juce::File::getCurrentWorkingDirectory().getChildFile(path.unquoted());
+}
+
+int main(int argc, char* argv[])
+{
+    // The processor's parameter tree expects JUCE's message manager to exist
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h")
+        || ! args.containsOption("--input") || ! args.containsOption("--output"))
+    {
+        printUsage();
+        return args.containsOption("--help|-h") ? 0 : 1;
+    }
+
+    const auto inputDir = resolvePath(args.getValueForOption("--input"));
+    const auto outputDir = resolvePath(args.getValueForOption("--output"));
+
+    if (! inputDir.isDirectory())
+    {
+        std::cerr << "Input directory not found: " << inputDir.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    if (! outputDir.createDirectory())
+    {
+        std::cerr << "Cannot create output directory: " << outputDir.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    juce::MemoryBlock preset;
+    if (args.containsOption("--preset"))
+    {
+        const auto presetFile = resolvePath(args.getValueForOption("--preset"));
+
+        if (! presetFile.loadFileAsData(preset))
+        {
+            std::cerr << "Cannot read preset: " << presetFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    int numThreads = juce::SystemStats::getNumCpus();
+    if (args.containsOption("--threads"))
+        numThreads = args.getValueForOption("--threads").getIntValue();
+
+    int blockSize = 512;
+    if (args.containsOption("--block-size"))
+        blockSize = args.getValueForOption("--block-size").getIntValue();
+
+    std::vector<int> cpuCores;
+    if (args.containsOption("--pin"))
+    {
+        for (auto& token : juce::StringArray::fromTokens(args.getValueForOption("--pin"), ",", {}))
+        {
+            const int core = token.trim().getIntValue();
+
+            if (! FlarkWorkStealingPool::canPin(core))
+            {
+                std::cerr << "Cannot pin to CPU " << token.trim() << ": --pin takes CPUs 0 to "
+                          << FlarkWorkStealingPool::maxPinnableCpus - 1 << std::endl;
+                return 1;
+            }
+
+            cpuCores.push_back(core);
+        }
+    }
+
+    const auto outputFormat = args.getValueForOption("--format").toLowerCase();
+
+    auto inputs = inputDir.findChildFiles(juce::File::findFiles, false, "*.wav;*.flac");
+    inputs.sort();
+
+    if (inputs.isEmpty())
+    {
+        std::cerr << "No WAV or FLAC files in " << inputDir.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    // Outputs are named after their inputs, so with --format song.wav and
+    // song.flac would both render to song.<format>
+    juce::Array<juce::File> outputs;
+    for (auto& input : inputs)
+    {
+        const auto extension = outputFormat.isNotEmpty() ? "." + outputFormat : input.getFileExtension();
+        const auto output = outputDir.getChildFile(input.getFileNameWithoutExtension() + extension);
+        const int existing = outputs.indexOf(output);
+
+        if (existing >= 0)
+        {
+            std::cerr << inputs[existing].getFileName() << " and " << input.getFileName()
+                      << " would both render to " << output.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        outputs.add(output);
+    }
+
+    FlarkWorkStealingPool pool(juce::jmin(numThreads, inputs.size()), cpuCores);
+
+    // One renderer (and so one processor instance) per worker
+    std::vector<std::unique_ptr<FlarkDJOfflineRenderer>> renderers;
+    for (int i = 0; i < pool.getNumWorkers(); ++i)
+        renderers.push_back(std::make_unique<FlarkDJOfflineRenderer>(preset, blockSize));
+
+    std::mutex printLock;
+    std::atomic<int> numFailed{0};
+    std::vector<FlarkWorkStealingPool::Task> tasks;
+
+    for (int i = 0; i < inputs.size(); ++i)
+    {
+        tasks.push_back([&, input = inputs[i], output = outputs[i]](int worker)
+        {
+            auto result = renderers[static_cast<size_t>(worker)]->render(input, output);
+
+            std::lock_guard<std::mutex> guard(printLock);
+
+            if (result.success)
+            {
+                std::cout << input.getFileName() << ": "
+                          << juce::String(result.numSamples / result.sampleRate, 1) << "s audio + "
+                          << juce::String(result.numTailSamples / result.sampleRate, 1) << "s tail in "
+                          << juce::String(result.renderSeconds, 2) << "s ("
+                          << juce::String(result.getRealtimeFactor(), 1) << "x realtime)" << std::endl;
+            }
+            else
+            {
+                ++numFailed;
+                std::cerr << input.getFileName() << ": " << result.error << std::endl;
+            }
+        });
+    }
+
+    const auto startTime = juce::Time::getMillisecondCounterHiRes();
+    pool.run(std::move(tasks));
+    const auto totalSeconds = (juce::Time::getMillisecondCounterHiRes() - startTime) / 1000.0;
+
+    std::cout << "Rendered " << (inputs.size() - numFailed.load()) << "/" << inputs.size()
+              << " files on " << pool.getNumWorkers() << " threads in "
+              << juce::String(totalSeconds, 2) << "s" << std::endl;
+
+    return numFailed.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,291 @@
+#include <iostream>
+#include "FlarkDJProcessor.h"
+
+/**
+ * FlarkDJReplay - replays a session capture offline
+ *
+ * Feeds a capture recorded by FlarkDJProcessor (FLARKDJ_CAPTURE_FILE, see
+ * FlarkDJCapture.h) back through a fresh processor with the same block sizes,
+ * parameter values, host BPM and prepare/reset/state events, and checks every
+ * output block against the checksum recorded in the session.
+ *
+ *   FlarkDJReplay <capture> [--output <file.wav>] [--repeat <n>] [--pin <cpu>]
+ *
+ * Run it under a profiler, or with --repeat to get stable timings, to find
+ * out why a particular block overran. Callback times are reported as a
+ * fraction of each block's deadline, as in FlarkDJProcessorBench.
+ */
+
+namespace
+{
+    // Host playhead that reports the BPM recorded for the current block
+    struct ReplayPlayHead : public juce::AudioPlayHead
+    {
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            PositionInfo info;
+            if (hasBpm)
+                info.setBpm(bpm);
+            return info;
+        }
+
+        bool hasBpm = false;
+        double bpm = 120.0;
+    };
+
+    struct PassResult
+    {
+        int numBlocks = 0;
+        int numChecked = 0;
+        int numMismatches = 0;
+        int firstMismatch = -1;
+        bool truncated = false;
+        bool complete = false;     // reached the End event
+
+        std::vector<double> loads; // per block: callback time / buffer deadline
+        int worstBlock = -1;
+    };
+
+    std::unique_ptr<juce::AudioFormatWriter> createWavWriter(const juce::File& file, double sampleRate, int numChannels)
+    {
+        file.deleteFile();
+        auto stream = file.createOutputStream();
+
+        if (stream == nullptr)
+            return nullptr;
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate,
+                                                                            static_cast<unsigned int>(numChannels), 32, {}, 0));
+        if (writer != nullptr)
+            stream.release(); // now owned by the writer
+
+        return writer;
+    }
+
+    // Replays one capture through a fresh processor. Writes the output to
+    // outputFile unless it is empty.
+    PassResult replay(FlarkDJCaptureReader& reader, const juce::File& outputFile, bool reportWarnings)
+    {
+        PassResult result;
+
+        FlarkDJProcessor processor;
+        ReplayPlayHead playHead;
+        processor.setPlayHead(&playHead);
+
+        // Parameters are written straight into the values the DSP reads,
+        // exactly as they were captured (no normalisation round trip)
+        std::vector<std::atomic<float>*> parameterValues;
+        for (auto& id : reader.getParameterIDs())
+        {
+            parameterValues.push_back(processor.getParameters().getRawParameterValue(id));
+
+            if (parameterValues.back() == nullptr && reportWarnings)
+                std::cerr << "Warning: parameter '" << id << "' no longer exists, ignoring it" << std::endl;
+        }
+
+        juce::AudioBuffer<float> buffer;
+        juce::MidiBuffer midi;
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+        double sampleRate = 0.0;
+        int blockSize = 0;
+        bool processedBlock = false;
+
+        FlarkDJCaptureReader::Event event;
+
+        while (reader.readNext(event))
+        {
+            switch (event.type)
+            {
+                case FlarkDJCaptureFormat::Prepare:
+                    sampleRate = event.sampleRate;
+                    blockSize = event.blockSize;
+                    processor.setControlRateInterval(event.controlRateInterval);
+                    processor.setRateAndBufferSizeDetails(event.sampleRate, event.blockSize);
+                    processor.prepareToPlay(event.sampleRate, event.blockSize);
+                    break;
+
+                case FlarkDJCaptureFormat::Reset:
+                    processor.reset();
+                    break;
+
+                case FlarkDJCaptureFormat::ControlRate:
+                    processor.setControlRateInterval(event.controlRateInterval);
+                    break;
+
+                case FlarkDJCaptureFormat::StateRestore:
+                    processor.setStateInformation(event.state.getData(), static_cast<int>(event.state.getSize()));
+                    break;
+
+                case FlarkDJCaptureFormat::Block:
+                {
+                    if (sampleRate <= 0.0)
+                    {
+                        std::cerr << "Capture has audio before any prepareToPlay" << std::endl;
+                        return result;
+                    }
+
+                    const auto& values = reader.getParameterValues();
+                    for (size_t i = 0; i < parameterValues.size(); ++i)
+                        if (parameterValues[i] != nullptr && (event.changedMask & (juce::uint64 { 1 } << i)) != 0)
+                            parameterValues[i]->store(values[i]);
+
+                    // Captures from a mono or surround session replay on their own layout
+                    if (event.audio.getNumChannels() != processor.getTotalNumOutputChannels())
+                    {
+                        const auto channels = juce::AudioChannelSet::canonicalChannelSet(event.audio.getNumChannels());
+                        juce::AudioProcessor::BusesLayout layout;
+                        layout.inputBuses.add(channels);
+                        layout.outputBuses.add(channels);
+
+                        if (! processor.setBusesLayout(layout))
+                        {
+                            std::cerr << "Capture has an unsupported channel count ("
+                                      << event.audio.getNumChannels() << ")" << std::endl;
+                            return result;
+                        }
+
+                        processor.prepareToPlay(sampleRate, blockSize);
+                    }
+
+                    playHead.hasBpm = event.hasBpm;
+                    playHead.bpm = event.bpm;
+
+                    buffer.makeCopyOf(event.audio, true);
+
+                    const auto start = juce::Time::getHighResolutionTicks();
+                    processor.processBlock(buffer, midi);
+                    const double seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+                    const double load = seconds * sampleRate / buffer.getNumSamples();
+                    if (result.worstBlock < 0 || load > result.loads[static_cast<size_t>(result.worstBlock)])
+                        result.worstBlock = result.numBlocks;
+
+                    result.loads.push_back(load);
+                    ++result.numBlocks;
+                    processedBlock = true;
+
+                    if (outputFile != juce::File())
+                    {
+                        if (writer == nullptr)
+                            writer = createWavWriter(outputFile, sampleRate, buffer.getNumChannels());
+
+                        if (writer != nullptr)
+                            writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+                    }
+                    break;
+                }
+
+                case FlarkDJCaptureFormat::Output:
+                    if (! processedBlock)
+                        break;
+
+                    ++result.numChecked;
+                    if (FlarkDJCaptureFormat::checksum(buffer) != event.checksum)
+                    {
+                        if (result.numMismatches++ == 0)
+                            result.firstMismatch = result.numBlocks - 1;
+                    }
+                    break;
+
+                case FlarkDJCaptureFormat::End:
+                    result.truncated = (event.endFlags & FlarkDJCaptureFormat::Truncated) != 0;
+                    result.complete = true;
+                    break;
+            }
+        }
+
+        processor.releaseResources();
+        processor.setPlayHead(nullptr);
+        return result;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // The processor's parameter tree expects JUCE's message manager to exist
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--help|-h") || args.size() == 0 || args[0].isOption())
+    {
+        std::cout << "Usage: FlarkDJReplay <capture> [--output <file.wav>] [--repeat <n>] [--pin <cpu>]\n";
+        return args.containsOption("--help|-h") ? 0 : 1;
+    }
+
+    // The replaying processor would start recording over it
+    if (juce::SystemStats::getEnvironmentVariable("FLARKDJ_CAPTURE_FILE", {}).isNotEmpty())
+    {
+        std::cerr << "Unset FLARKDJ_CAPTURE_FILE before replaying" << std::endl;
+        return 1;
+    }
+
+    const auto captureFile = args[0].resolveAsFile();
+    juce::File outputFile;
+
+    if (args.containsOption("--output"))
+        outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+
+    const int numPasses = args.containsOption("--repeat") ? juce::jmax(1, args.getValueForOption("--repeat").getIntValue()) : 1;
+
+    if (args.containsOption("--pin"))
+    {
+        const int core = args.getValueForOption("--pin").getIntValue();
+        if (juce::isPositiveAndBelow(core, 32))
+            juce::Thread::setCurrentThreadAffinityMask(1u << core);
+    }
+
+    bool allMatched = true;
+
+    for (int pass = 0; pass < numPasses; ++pass)
+    {
+        FlarkDJCaptureReader reader;
+        const auto error = reader.open(captureFile);
+
+        if (error.isNotEmpty())
+        {
+            std::cerr << captureFile.getFullPathName() << ": " << error << std::endl;
+            return 1;
+        }
+
+        if (pass == 0 && reader.wasStartedMidSession())
+            std::cerr << "Note: capture started mid-session; output differs until earlier effect tails have died out"
+                      << std::endl;
+
+        // Only the first pass writes audio; the rest are for timing
+        const auto result = replay(reader, pass == 0 ? outputFile : juce::File(), pass == 0);
+
+        if (result.numBlocks == 0)
+        {
+            std::cerr << "No blocks replayed" << std::endl;
+            return 1;
+        }
+
+        auto loads = result.loads;
+        std::sort(loads.begin(), loads.end());
+        double meanLoad = 0.0;
+        for (auto load : loads)
+            meanLoad += load;
+        meanLoad /= static_cast<double>(loads.size());
+        const double p99Load = loads[static_cast<size_t>(std::ceil(0.99 * static_cast<double>(loads.size()))) - 1];
+
+        std::cout << "Pass " << (pass + 1) << ": " << result.numBlocks << " blocks, "
+                  << (result.numChecked - result.numMismatches) << "/" << result.numChecked << " bit-exact";
+
+        if (result.numMismatches > 0)
+            std::cout << " (first mismatch at block " << result.firstMismatch << ")";
+
+        std::cout << "; load mean " << juce::String(meanLoad * 100.0, 2) << "%, p99 " << juce::String(p99Load * 100.0, 2)
+                  << "%, worst " << juce::String(loads.back() * 100.0, 2) << "% at block " << result.worstBlock << std::endl;
+
+        if (pass == 0 && result.truncated)
+            std::cerr << "Note: capture was truncated (the recorder's writer fell behind)" << std::endl;
+        else if (pass == 0 && ! result.complete)
+            std::cerr << "Note: capture has no end marker (session did not stop cleanly)" << std::endl;
+
+        allMatched = allMatched && result.numMismatches == 0;
+    }
+
+    return allMatched ? 0 : 1;
+}
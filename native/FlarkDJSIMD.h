@@ -0,0 +1,300 @@
+#pragma once
+
+/**
+ * FlarkDJ SIMD helpers
+ *
+ * Thin wrappers over SSE2 / NEON registers used by the vectorised DSP code.
+ * A scalar fallback keeps every other target building with identical results.
+ * The 8- and 16-lane types use AVX and AVX-512 when the build enables them,
+ * and pairs of the narrower type otherwise.
+ */
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+ #define FLARKDJ_SIMD_SSE 1
+ #include <emmintrin.h>
+ #if defined(__AVX__)
+  #define FLARKDJ_SIMD_AVX 1
+  #include <immintrin.h>
+ #endif
+ #if defined(__AVX512F__)
+  #define FLARKDJ_SIMD_AVX512 1
+ #endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(_M_ARM64)
+ #define FLARKDJ_SIMD_NEON 1
+ #include <arm_neon.h>
+#else
+ #define FLARKDJ_SIMD_SCALAR 1
+ #include <algorithm>
+ #include <cmath>
+ #include <cstdint>
+ #include <cstring>
+#endif
+
+//==============================================================================
+// Four float lanes
+//==============================================================================
+struct FlarkFloat4
+{
+    static constexpr int width = 4;
+
+#if FLARKDJ_SIMD_SSE
+    __m128 v;
+
+    static FlarkFloat4 broadcast(float x)                      { return { _mm_set1_ps(x) }; }
+    static FlarkFloat4 set(float a, float b, float c, float d) { return { _mm_setr_ps(a, b, c, d) }; }
+    static FlarkFloat4 load(const float* p)                    { return { _mm_loadu_ps(p) }; }
+    void store(float* p) const                                 { _mm_storeu_ps(p, v); }
+
+    friend FlarkFloat4 operator+(FlarkFloat4 a, FlarkFloat4 b) { return { _mm_add_ps(a.v, b.v) }; }
+    friend FlarkFloat4 operator-(FlarkFloat4 a, FlarkFloat4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+    friend FlarkFloat4 operator*(FlarkFloat4 a, FlarkFloat4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+    friend FlarkFloat4 operator/(FlarkFloat4 a, FlarkFloat4 b) { return { _mm_div_ps(a.v, b.v) }; }
+
+    static FlarkFloat4 min(FlarkFloat4 a, FlarkFloat4 b)       { return { _mm_min_ps(a.v, b.v) }; }
+    static FlarkFloat4 max(FlarkFloat4 a, FlarkFloat4 b)       { return { _mm_max_ps(a.v, b.v) }; }
+    FlarkFloat4 abs() const                                    { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), v) }; }
+    FlarkFloat4 withSignOf(FlarkFloat4 s) const                { const __m128 m = _mm_set1_ps(-0.0f); return { _mm_or_ps(_mm_andnot_ps(m, v), _mm_and_ps(m, s.v)) }; }
+
+    // Nearest integer, ties to even (|x| < 2^31)
+    FlarkFloat4 round() const                                  { return { _mm_cvtepi32_ps(_mm_cvtps_epi32(v)) }; }
+    // 2^x for integer-valued x in [-126, 127]
+    FlarkFloat4 pow2OfInteger() const                          { return { _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(v), _mm_set1_epi32(127)), 23)) }; }
+
+    // Lanes 2, 3, 0, 1
+    FlarkFloat4 swapHalves() const                             { return { _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)) }; }
+    // Lanes 0, 1 of a and 2, 3 of b
+    static FlarkFloat4 joinHalves(FlarkFloat4 a, FlarkFloat4 b) { return { _mm_shuffle_ps(a.v, b.v, _MM_SHUFFLE(3, 2, 1, 0)) }; }
+
+    float get0() const { return _mm_cvtss_f32(v); }
+    float get1() const { return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))); }
+
+    float sum() const
+    {
+        const __m128 pairs = _mm_add_ps(v, _mm_movehl_ps(v, v));
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+    }
+
+    float maxLane() const
+    {
+        const __m128 pairs = _mm_max_ps(v, _mm_movehl_ps(v, v));
+        return _mm_cvtss_f32(_mm_max_ss(pairs, _mm_shuffle_ps(pairs, pairs, _MM_SHUFFLE(1, 1, 1, 1))));
+    }
+#elif FLARKDJ_SIMD_NEON
+    float32x4_t v;
+
+    static FlarkFloat4 broadcast(float x)                      { return { vdupq_n_f32(x) }; }
+    static FlarkFloat4 set(float a, float b, float c, float d) { const float t[4] = { a, b, c, d }; return { vld1q_f32(t) }; }
+    static FlarkFloat4 load(const float* p)                    { return { vld1q_f32(p) }; }
+    void store(float* p) const                                 { vst1q_f32(p, v); }
+
+    friend FlarkFloat4 operator+(FlarkFloat4 a, FlarkFloat4 b) { return { vaddq_f32(a.v, b.v) }; }
+    friend FlarkFloat4 operator-(FlarkFloat4 a, FlarkFloat4 b) { return { vsubq_f32(a.v, b.v) }; }
+    friend FlarkFloat4 operator*(FlarkFloat4 a, FlarkFloat4 b) { return { vmulq_f32(a.v, b.v) }; }
+
+   #if defined(__aarch64__) || defined(_M_ARM64)
+    friend FlarkFloat4 operator/(FlarkFloat4 a, FlarkFloat4 b) { return { vdivq_f32(a.v, b.v) }; }
+    FlarkFloat4 round() const                                  { return { vrndnq_f32(v) }; }
+   #else
+    friend FlarkFloat4 operator/(FlarkFloat4 a, FlarkFloat4 b)
+    {
+        float x[4], y[4];
+        vst1q_f32(x, a.v);
+        vst1q_f32(y, b.v);
+        return set(x[0] / y[0], x[1] / y[1], x[2] / y[2], x[3] / y[3]);
+    }
+
+    // Adding and removing 1.5 * 2^23 rounds to nearest, ties to even (|x| < 2^22)
+    FlarkFloat4 round() const                                  { const float32x4_t m = vdupq_n_f32(12582912.0f); return { vsubq_f32(vaddq_f32(v, m), m) }; }
+   #endif
+
+    static FlarkFloat4 min(FlarkFloat4 a, FlarkFloat4 b)       { return { vminq_f32(a.v, b.v) }; }
+    static FlarkFloat4 max(FlarkFloat4 a, FlarkFloat4 b)       { return { vmaxq_f32(a.v, b.v) }; }
+    FlarkFloat4 abs() const                                    { return { vabsq_f32(v) }; }
+    FlarkFloat4 withSignOf(FlarkFloat4 s) const                { return { vbslq_f32(vdupq_n_u32(0x80000000u), s.v, v) }; }
+    FlarkFloat4 pow2OfInteger() const                          { return { vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(v), vdupq_n_s32(127)), 23)) }; }
+
+    FlarkFloat4 swapHalves() const                             { return { vcombine_f32(vget_high_f32(v), vget_low_f32(v)) }; }
+    static FlarkFloat4 joinHalves(FlarkFloat4 a, FlarkFloat4 b) { return { vcombine_f32(vget_low_f32(a.v), vget_high_f32(b.v)) }; }
+
+    float get0() const { return vgetq_lane_f32(v, 0); }
+    float get1() const { return vgetq_lane_f32(v, 1); }
+
+    float sum() const
+    {
+        const float32x2_t pairs = vadd_f32(vget_low_f32(v), vget_high_f32(v));
+        return vget_lane_f32(vpadd_f32(pairs, pairs), 0);
+    }
+
+    float maxLane() const
+    {
+        const float32x2_t pairs = vmax_f32(vget_low_f32(v), vget_high_f32(v));
+        return vget_lane_f32(vpmax_f32(pairs, pairs), 0);
+    }
+#else
+    float v[4];
+
+    static FlarkFloat4 broadcast(float x)                      { return { { x, x, x, x } }; }
+    static FlarkFloat4 set(float a, float b, float c, float d) { return { { a, b, c, d } }; }
+    static FlarkFloat4 load(const float* p)                    { return { { p[0], p[1], p[2], p[3] } }; }
+    void store(float* p) const                                 { for (int i = 0; i < 4; ++i) p[i] = v[i]; }
+
+    friend FlarkFloat4 operator+(FlarkFloat4 a, FlarkFloat4 b) { return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+    friend FlarkFloat4 operator-(FlarkFloat4 a, FlarkFloat4 b) { return { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+    friend FlarkFloat4 operator*(FlarkFloat4 a, FlarkFloat4 b) { return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+    friend FlarkFloat4 operator/(FlarkFloat4 a, FlarkFloat4 b) { return { { a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3] } }; }
+
+    static FlarkFloat4 min(FlarkFloat4 a, FlarkFloat4 b)       { return { { std::min(a.v[0], b.v[0]), std::min(a.v[1], b.v[1]), std::min(a.v[2], b.v[2]), std::min(a.v[3], b.v[3]) } }; }
+    static FlarkFloat4 max(FlarkFloat4 a, FlarkFloat4 b)       { return { { std::max(a.v[0], b.v[0]), std::max(a.v[1], b.v[1]), std::max(a.v[2], b.v[2]), std::max(a.v[3], b.v[3]) } }; }
+    FlarkFloat4 abs() const                                    { return { { std::abs(v[0]), std::abs(v[1]), std::abs(v[2]), std::abs(v[3]) } }; }
+    FlarkFloat4 withSignOf(FlarkFloat4 s) const                { return { { std::copysign(v[0], s.v[0]), std::copysign(v[1], s.v[1]), std::copysign(v[2], s.v[2]), std::copysign(v[3], s.v[3]) } }; }
+    FlarkFloat4 round() const                                  { return { { std::nearbyint(v[0]), std::nearbyint(v[1]), std::nearbyint(v[2]), std::nearbyint(v[3]) } }; }
+
+    FlarkFloat4 pow2OfInteger() const
+    {
+        FlarkFloat4 result;
+        for (int i = 0; i < 4; ++i)
+        {
+            const std::uint32_t bits = static_cast<std::uint32_t>(static_cast<int>(v[i]) + 127) << 23;
+            std::memcpy(&result.v[i], &bits, sizeof(float));
+        }
+        return result;
+    }
+
+    FlarkFloat4 swapHalves() const                             { return { { v[2], v[3], v[0], v[1] } }; }
+    static FlarkFloat4 joinHalves(FlarkFloat4 a, FlarkFloat4 b) { return { { a.v[0], a.v[1], b.v[2], b.v[3] } }; }
+
+    float get0() const { return v[0]; }
+    float get1() const { return v[1]; }
+
+    float sum() const { return (v[0] + v[2]) + (v[1] + v[3]); }
+    float maxLane() const { return std::max(std::max(v[0], v[2]), std::max(v[1], v[3])); }
+#endif
+
+    static FlarkFloat4 zero() { return broadcast(0.0f); }
+
+    // Lane i is base[offsets[i]]
+    static FlarkFloat4 gather(const float* base, const int* offsets)
+    {
+        return set(base[offsets[0]], base[offsets[1]], base[offsets[2]], base[offsets[3]]);
+    }
+};
+
+//==============================================================================
+// Eight float lanes: one AVX register, or a pair of 4-lane registers
+//==============================================================================
+struct FlarkFloat8
+{
+    static constexpr int width = 8;
+
+#if FLARKDJ_SIMD_AVX
+    __m256 v;
+
+    static FlarkFloat8 broadcast(float x)   { return { _mm256_set1_ps(x) }; }
+    static FlarkFloat8 load(const float* p) { return { _mm256_loadu_ps(p) }; }
+    void store(float* p) const              { _mm256_storeu_ps(p, v); }
+
+    friend FlarkFloat8 operator+(FlarkFloat8 a, FlarkFloat8 b) { return { _mm256_add_ps(a.v, b.v) }; }
+    friend FlarkFloat8 operator-(FlarkFloat8 a, FlarkFloat8 b) { return { _mm256_sub_ps(a.v, b.v) }; }
+    friend FlarkFloat8 operator*(FlarkFloat8 a, FlarkFloat8 b) { return { _mm256_mul_ps(a.v, b.v) }; }
+    friend FlarkFloat8 operator/(FlarkFloat8 a, FlarkFloat8 b) { return { _mm256_div_ps(a.v, b.v) }; }
+
+    static FlarkFloat8 min(FlarkFloat8 a, FlarkFloat8 b)       { return { _mm256_min_ps(a.v, b.v) }; }
+    static FlarkFloat8 max(FlarkFloat8 a, FlarkFloat8 b)       { return { _mm256_max_ps(a.v, b.v) }; }
+    FlarkFloat8 abs() const                                    { return { _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v) }; }
+
+    // Lane i is base[offsets[i]]
+    static FlarkFloat8 gather(const float* base, const int* offsets)
+    {
+       #if defined(__AVX2__)
+        return { _mm256_i32gather_ps(base, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(offsets)), 4) };
+       #else
+        return { _mm256_setr_ps(base[offsets[0]], base[offsets[1]], base[offsets[2]], base[offsets[3]],
+                                base[offsets[4]], base[offsets[5]], base[offsets[6]], base[offsets[7]]) };
+       #endif
+    }
+
+    float sum() const
+    {
+        return FlarkFloat4 { _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1)) }.sum();
+    }
+#else
+    FlarkFloat4 lo, hi;
+
+    static FlarkFloat8 broadcast(float x)   { const auto b = FlarkFloat4::broadcast(x); return { b, b }; }
+    static FlarkFloat8 load(const float* p) { return { FlarkFloat4::load(p), FlarkFloat4::load(p + 4) }; }
+    void store(float* p) const              { lo.store(p); hi.store(p + 4); }
+
+    friend FlarkFloat8 operator+(FlarkFloat8 a, FlarkFloat8 b) { return { a.lo + b.lo, a.hi + b.hi }; }
+    friend FlarkFloat8 operator-(FlarkFloat8 a, FlarkFloat8 b) { return { a.lo - b.lo, a.hi - b.hi }; }
+    friend FlarkFloat8 operator*(FlarkFloat8 a, FlarkFloat8 b) { return { a.lo * b.lo, a.hi * b.hi }; }
+    friend FlarkFloat8 operator/(FlarkFloat8 a, FlarkFloat8 b) { return { a.lo / b.lo, a.hi / b.hi }; }
+
+    static FlarkFloat8 min(FlarkFloat8 a, FlarkFloat8 b)       { return { FlarkFloat4::min(a.lo, b.lo), FlarkFloat4::min(a.hi, b.hi) }; }
+    static FlarkFloat8 max(FlarkFloat8 a, FlarkFloat8 b)       { return { FlarkFloat4::max(a.lo, b.lo), FlarkFloat4::max(a.hi, b.hi) }; }
+    FlarkFloat8 abs() const                                    { return { lo.abs(), hi.abs() }; }
+
+    static FlarkFloat8 gather(const float* base, const int* offsets)
+    {
+        return { FlarkFloat4::gather(base, offsets), FlarkFloat4::gather(base, offsets + 4) };
+    }
+
+    float sum() const { return (lo + hi).sum(); }
+#endif
+
+    static FlarkFloat8 zero() { return broadcast(0.0f); }
+};
+
+//==============================================================================
+// Sixteen float lanes: one AVX-512 register, or a pair of 8-lane registers
+//==============================================================================
+struct FlarkFloat16
+{
+    static constexpr int width = 16;
+
+#if FLARKDJ_SIMD_AVX512
+    __m512 v;
+
+    static FlarkFloat16 broadcast(float x)   { return { _mm512_set1_ps(x) }; }
+    static FlarkFloat16 load(const float* p) { return { _mm512_loadu_ps(p) }; }
+    void store(float* p) const               { _mm512_storeu_ps(p, v); }
+
+    friend FlarkFloat16 operator+(FlarkFloat16 a, FlarkFloat16 b) { return { _mm512_add_ps(a.v, b.v) }; }
+    friend FlarkFloat16 operator-(FlarkFloat16 a, FlarkFloat16 b) { return { _mm512_sub_ps(a.v, b.v) }; }
+    friend FlarkFloat16 operator*(FlarkFloat16 a, FlarkFloat16 b) { return { _mm512_mul_ps(a.v, b.v) }; }
+    friend FlarkFloat16 operator/(FlarkFloat16 a, FlarkFloat16 b) { return { _mm512_div_ps(a.v, b.v) }; }
+
+    // Zero-masked forms of min, max and gather: GCC 12 flags the undefined
+    // source operand of the plain intrinsics as maybe-uninitialized
+    static FlarkFloat16 min(FlarkFloat16 a, FlarkFloat16 b)       { return { _mm512_maskz_min_ps(0xFFFF, a.v, b.v) }; }
+    static FlarkFloat16 max(FlarkFloat16 a, FlarkFloat16 b)       { return { _mm512_maskz_max_ps(0xFFFF, a.v, b.v) }; }
+    FlarkFloat16 abs() const                                      { return { _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(v), _mm512_set1_epi32(0x7fffffff))) }; }
+
+    // Lane i is base[offsets[i]]
+    static FlarkFloat16 gather(const float* base, const int* offsets)
+    {
+        return { _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xFFFF, _mm512_loadu_si512(offsets), base, 4) };
+    }
+#else
+    FlarkFloat8 lo, hi;
+
+    static FlarkFloat16 broadcast(float x)   { const auto b = FlarkFloat8::broadcast(x); return { b, b }; }
+    static FlarkFloat16 load(const float* p) { return { FlarkFloat8::load(p), FlarkFloat8::load(p + 8) }; }
+    void store(float* p) const               { lo.store(p); hi.store(p + 8); }
+
+    friend FlarkFloat16 operator+(FlarkFloat16 a, FlarkFloat16 b) { return { a.lo + b.lo, a.hi + b.hi }; }
+    friend FlarkFloat16 operator-(FlarkFloat16 a, FlarkFloat16 b) { return { a.lo - b.lo, a.hi - b.hi }; }
+    friend FlarkFloat16 operator*(FlarkFloat16 a, FlarkFloat16 b) { return { a.lo * b.lo, a.hi * b.hi }; }
+    friend FlarkFloat16 operator/(FlarkFloat16 a, FlarkFloat16 b) { return { a.lo / b.lo, a.hi / b.hi }; }
+
+    static FlarkFloat16 min(FlarkFloat16 a, FlarkFloat16 b)       { return { FlarkFloat8::min(a.lo, b.lo), FlarkFloat8::min(a.hi, b.hi) }; }
+    static FlarkFloat16 max(FlarkFloat16 a, FlarkFloat16 b)       { return { FlarkFloat8::max(a.lo, b.lo), FlarkFloat8::max(a.hi, b.hi) }; }
+    FlarkFloat16 abs() const                                      { return { lo.abs(), hi.abs() }; }
+
+    static FlarkFloat16 gather(const float* base, const int* offsets)
+    {
+        return { FlarkFloat8::gather(base, offsets), FlarkFloat8::gather(base, offsets + 8) };
+    }
+#endif
+
+    static FlarkFloat16 zero() { return broadcast(0.0f); }
+};
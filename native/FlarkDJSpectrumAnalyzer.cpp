@@ -0,0 +1,226 @@
+#include "FlarkDJSpectrumAnalyzer.h"
+
+//==============================================================================
+FlarkDJSpectrumAnalyzer::FlarkDJSpectrumAnalyzer()
+    : juce::Thread("FlarkDJ spectrum analyzer")
+{
+}
+
+FlarkDJSpectrumAnalyzer::~FlarkDJSpectrumAnalyzer()
+{
+    setActive(false);
+}
+
+void FlarkDJSpectrumAnalyzer::setActive(bool shouldBeActive)
+{
+    if (shouldBeActive == active.load())
+        return;
+
+    if (shouldBeActive)
+    {
+        // Start from an empty history rather than whatever was left in the FIFO
+        needsConfigure.store(true);
+        active.store(true);
+        startThread(juce::Thread::Priority::low);
+    }
+    else
+    {
+        active.store(false);
+        stopThread(1000);
+    }
+}
+
+void FlarkDJSpectrumAnalyzer::setSettings(const Settings& newSettings)
+{
+    {
+        const juce::SpinLock::ScopedLockType lock(settingsLock);
+        settings = newSettings;
+        settings.fftOrder = juce::jlimit(8, 14, settings.fftOrder);
+        settings.overlap = juce::jlimit(0.0f, 0.9f, settings.overlap);
+        settings.smoothing = juce::jlimit(0.0f, 0.99f, settings.smoothing);
+        settings.numDisplayBands = juce::jlimit(8, 1024, settings.numDisplayBands);
+        settings.minDisplayFrequency = juce::jlimit(1.0f, 1000.0f, settings.minDisplayFrequency);
+    }
+
+    needsConfigure.store(true);
+}
+
+FlarkDJSpectrumAnalyzer::Settings FlarkDJSpectrumAnalyzer::getSettings() const
+{
+    const juce::SpinLock::ScopedLockType lock(settingsLock);
+    return settings;
+}
+
+void FlarkDJSpectrumAnalyzer::prepare(double newSampleRate)
+{
+    currentSampleRate.store(newSampleRate);
+    needsConfigure.store(true);
+}
+
+void FlarkDJSpectrumAnalyzer::getSpectrum(Spectrum& destination)
+{
+    const juce::SpinLock::ScopedLockType lock(readLock);
+    destination = published.read();
+}
+
+//==============================================================================
+void FlarkDJSpectrumAnalyzer::pushSamples(const float* left, const float* right, int numSamples)
+{
+    if (! active.load(std::memory_order_relaxed) || fifo.getFreeSpace() < numSamples)
+        return;
+
+    const auto scope = fifo.write(numSamples);
+    const float* channels[] = { left, right };
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        fifoBuffer.copyFrom(ch, scope.startIndex1, channels[ch], scope.blockSize1);
+        if (scope.blockSize2 > 0)
+            fifoBuffer.copyFrom(ch, scope.startIndex2, channels[ch] + scope.blockSize1, scope.blockSize2);
+    }
+}
+
+//==============================================================================
+void FlarkDJSpectrumAnalyzer::run()
+{
+    while (! threadShouldExit())
+    {
+        if (needsConfigure.exchange(false))
+            configure();
+
+        readFromFifo();
+        wait(10);
+    }
+}
+
+void FlarkDJSpectrumAnalyzer::configure()
+{
+    activeSettings = getSettings();
+    sampleRate = currentSampleRate.load();
+
+    fftSize = 1 << activeSettings.fftOrder;
+    hopSize = juce::jmax(1, juce::roundToInt(fftSize * (1.0f - activeSettings.overlap)));
+    fft = std::make_unique<juce::dsp::FFT>(activeSettings.fftOrder);
+
+    window.resize(static_cast<size_t>(fftSize));
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), static_cast<size_t>(fftSize),
+                                                              juce::dsp::WindowingFunction<float>::hann, false);
+
+    history.assign(static_cast<size_t>(fftSize), 0.0f);
+    fftData.assign(static_cast<size_t>(fftSize) * 2, 0.0f);
+    smoothedMagnitudes.assign(static_cast<size_t>(fftSize / 2 + 1), 0.0f);
+    historyPos = 0;
+    samplesUntilFrame = fftSize;
+
+    // Display bands, each spanning the bins inside it; bands narrower than a
+    // bin (at the low end) interpolate at their centre instead
+    const double binHz = sampleRate / fftSize;
+    const double minFrequency = juce::jmin(static_cast<double>(activeSettings.minDisplayFrequency), sampleRate * 0.25);
+    const double maxFrequency = sampleRate * 0.5;
+    const int numBands = activeSettings.numDisplayBands;
+
+    bands.resize(static_cast<size_t>(numBands));
+    for (int i = 0; i < numBands; ++i)
+    {
+        const double low = minFrequency * std::pow(maxFrequency / minFrequency, i / static_cast<double>(numBands));
+        const double high = minFrequency * std::pow(maxFrequency / minFrequency, (i + 1) / static_cast<double>(numBands));
+
+        bands[static_cast<size_t>(i)] = { static_cast<int>(std::ceil(low / binHz)),
+                                          juce::jmin(fftSize / 2, static_cast<int>(std::floor(high / binHz))),
+                                          static_cast<float>(std::sqrt(low * high) / binHz) };
+    }
+
+    // Drop audio queued before the change
+    const auto discard = fifo.read(fifo.getNumReady());
+    juce::ignoreUnused(discard);
+}
+
+void FlarkDJSpectrumAnalyzer::readFromFifo()
+{
+    while (fifo.getNumReady() > 0)
+    {
+        const auto scope = fifo.read(juce::jmin(fifo.getNumReady(), samplesUntilFrame));
+
+        auto append = [this](int start, int size)
+        {
+            const auto* left = fifoBuffer.getReadPointer(0, start);
+            const auto* right = fifoBuffer.getReadPointer(1, start);
+
+            for (int i = 0; i < size; ++i)
+            {
+                history[static_cast<size_t>(historyPos)] = (left[i] + right[i]) * 0.5f;
+                historyPos = (historyPos + 1) & (fftSize - 1);
+            }
+        };
+
+        append(scope.startIndex1, scope.blockSize1);
+        append(scope.startIndex2, scope.blockSize2);
+
+        samplesUntilFrame -= scope.blockSize1 + scope.blockSize2;
+
+        if (samplesUntilFrame == 0)
+        {
+            analyseFrame();
+            samplesUntilFrame = hopSize;
+        }
+    }
+}
+
+void FlarkDJSpectrumAnalyzer::analyseFrame()
+{
+    auto& spectrum = published.getWriteBuffer();
+    const int numBins = fftSize / 2 + 1;
+
+    // Oldest sample first
+    spectrum.waveform.resize(static_cast<size_t>(fftSize));
+    for (int i = 0; i < fftSize; ++i)
+        spectrum.waveform[static_cast<size_t>(i)] = history[static_cast<size_t>((historyPos + i) & (fftSize - 1))];
+
+    std::fill(fftData.begin(), fftData.end(), 0.0f);
+    juce::FloatVectorOperations::multiply(fftData.data(), spectrum.waveform.data(), window.data(), fftSize);
+    fft->performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // A Hann window sums to fftSize / 2, so this scales a full-scale sine to 1
+    const float scale = 4.0f / static_cast<float>(fftSize);
+    const float smoothing = activeSettings.smoothing;
+
+    spectrum.magnitudesDb.resize(static_cast<size_t>(numBins));
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        auto& smoothed = smoothedMagnitudes[static_cast<size_t>(bin)];
+        smoothed = smoothing * smoothed + (1.0f - smoothing) * fftData[static_cast<size_t>(bin)] * scale;
+        spectrum.magnitudesDb[static_cast<size_t>(bin)] = juce::jmax(floorDb, juce::Decibels::gainToDecibels(smoothed, floorDb));
+    }
+
+    // Peak, refined by a parabola through the neighbouring bins (DC excluded)
+    const auto& db = spectrum.magnitudesDb;
+    const int peakBin = static_cast<int>(std::max_element(db.begin() + 1, db.end() - 1) - db.begin());
+    const float a = db[static_cast<size_t>(peakBin - 1)], b = db[static_cast<size_t>(peakBin)], c = db[static_cast<size_t>(peakBin + 1)];
+    const float denominator = a - 2.0f * b + c;
+    const float offset = denominator < 0.0f ? 0.5f * (a - c) / denominator : 0.0f;
+
+    spectrum.peakFrequency = static_cast<float>((peakBin + offset) * sampleRate / fftSize);
+    spectrum.peakDb = b - 0.25f * (a - c) * offset;
+
+    spectrum.displayDb.resize(bands.size());
+    for (size_t i = 0; i < bands.size(); ++i)
+    {
+        const auto& band = bands[i];
+
+        if (band.lastBin >= band.firstBin)
+        {
+            spectrum.displayDb[i] = *std::max_element(db.begin() + band.firstBin, db.begin() + band.lastBin + 1);
+        }
+        else
+        {
+            const int bin = juce::jlimit(0, numBins - 2, static_cast<int>(band.centreBin));
+            const float frac = juce::jlimit(0.0f, 1.0f, band.centreBin - static_cast<float>(bin));
+            spectrum.displayDb[i] = db[static_cast<size_t>(bin)] + frac * (db[static_cast<size_t>(bin + 1)] - db[static_cast<size_t>(bin)]);
+        }
+    }
+
+    spectrum.sampleRate = sampleRate;
+    spectrum.fftSize = fftSize;
+    spectrum.frameIndex = ++frameIndex;
+    published.publish();
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <atomic>
+#include <vector>
+#include "FlarkDJPerformance.h"
+
+/**
+ * FlarkDJ Spectrum Analyzer
+ *
+ * Windowed FFT of the processor's output for the editor's display. The audio
+ * thread only copies each block into a lock-free FIFO; a background thread
+ * mixes it to mono, runs a Hann-windowed FFT every hop and publishes
+ * magnitude bins, the peak frequency, a log-frequency display vector and the
+ * latest waveform frame.
+ *
+ * The analysis thread only runs while the analyzer is active (an editor is
+ * open), so headless renders pay one atomic load per block. If the analysis
+ * thread falls behind, blocks are dropped rather than the audio thread waiting.
+ */
+class FlarkDJSpectrumAnalyzer : private juce::Thread
+{
+public:
+    struct Settings
+    {
+        int fftOrder = 11;                 // FFT size is 2^fftOrder (8 to 14)
+        float overlap = 0.5f;              // share of each frame repeated in the next (0 to 0.9)
+        float smoothing = 0.8f;            // magnitude averaging between frames (0 to 0.99), as Web Audio's AnalyserNode
+        int numDisplayBands = 96;
+        float minDisplayFrequency = 20.0f;
+    };
+
+    struct Spectrum
+    {
+        double sampleRate = 0.0;
+        int fftSize = 0;
+        juce::int64 frameIndex = 0;        // counts analysed frames; unchanged means nothing new
+
+        std::vector<float> magnitudesDb;   // fftSize / 2 + 1 bins in dBFS; a full-scale sine reads 0 dB
+        float peakFrequency = 0.0f;        // Hz, interpolated between bins
+        float peakDb = -120.0f;
+        std::vector<float> displayDb;      // log-spaced bands from minDisplayFrequency to Nyquist
+        std::vector<float> waveform;       // the last fftSize mono samples
+
+        float getBinFrequency(int bin) const
+        {
+            return fftSize > 0 ? static_cast<float>(bin * sampleRate / fftSize) : 0.0f;
+        }
+    };
+
+    static constexpr float floorDb = -120.0f;
+    static constexpr int fifoSize = 1 << 15;
+
+    FlarkDJSpectrumAnalyzer();
+    ~FlarkDJSpectrumAnalyzer() override;
+
+    //==============================================================================
+    // Message thread
+    void setActive(bool shouldBeActive);
+    bool isActive() const { return active.load(); }
+
+    void setSettings(const Settings& newSettings);
+    Settings getSettings() const;
+
+    // From prepareToPlay; the analysis restarts at the new rate
+    void prepare(double sampleRate);
+
+    // Any thread, one at a time. Copies the latest spectrum (reusing the
+    // destination's storage once it has the right size).
+    void getSpectrum(Spectrum& destination);
+
+    //==============================================================================
+    // Audio thread: one copy per channel, nothing else
+    void pushSamples(const float* left, const float* right, int numSamples);
+
+private:
+    void run() override;
+    void configure();
+    void readFromFifo();
+    void analyseFrame();
+
+    // Audio thread -> analysis thread
+    juce::AbstractFifo fifo { fifoSize };
+    juce::AudioBuffer<float> fifoBuffer { 2, fifoSize };
+    std::atomic<bool> active { false };
+
+    std::atomic<double> currentSampleRate { 44100.0 };
+    std::atomic<bool> needsConfigure { true };
+    mutable juce::SpinLock settingsLock;
+    Settings settings;
+
+    // Analysis thread only
+    Settings activeSettings;
+    double sampleRate = 44100.0;
+    int fftSize = 0, hopSize = 0;
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<float> window, history, fftData, smoothedMagnitudes;
+    int historyPos = 0, samplesUntilFrame = 0;
+    juce::int64 frameIndex = 0;
+
+    struct Band { int firstBin, lastBin; float centreBin; };
+    std::vector<Band> bands;
+
+    FlarkTripleBuffer<Spectrum> published;
+    juce::SpinLock readLock;
+
+    JUCE_DECLARE_NON_COPYABLE(FlarkDJSpectrumAnalyzer)
+};
@@ -0,0 +1,170 @@
+#include "FlarkDJTrace.h"
+
+#if FLARKDJ_TRACING
+
+std::atomic<FlarkDJTracer*> FlarkDJTracer::activeTracer { nullptr };
+std::atomic<int> FlarkDJTracer::sessionCounter { 0 };
+
+//==============================================================================
+FlarkDJTracer::FlarkDJTracer()
+    : juce::Thread("FlarkDJ trace writer")
+{
+    const auto path = juce::SystemStats::getEnvironmentVariable("FLARKDJ_TRACE_FILE", {});
+    if (path.isEmpty())
+        return;
+
+    const juce::File file(path);
+    file.deleteFile();
+    output = std::make_unique<juce::FileOutputStream>(file);
+
+    if (output->failedToOpen())
+    {
+        DBG("FlarkDJ: cannot write trace to " << path);
+        output.reset();
+        return;
+    }
+
+    buffers = std::make_unique<ThreadBuffer[]>(maxThreads);
+    startTicks = juce::Time::getHighResolutionTicks();
+    session = ++sessionCounter;
+
+    *output << "{\"traceEvents\":[\n";
+    writeEvent("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"FlarkDJ\"}}");
+
+    activeTracer.store(this, std::memory_order_release);
+    startThread(juce::Thread::Priority::low);
+}
+
+FlarkDJTracer::~FlarkDJTracer()
+{
+    if (output == nullptr)
+        return;
+
+    activeTracer.store(nullptr, std::memory_order_release);
+    stopThread(2000);
+
+    // Whatever is left, then close the JSON
+    drain();
+    *output << "\n]}\n";
+    output->flush();
+}
+
+//==============================================================================
+FlarkDJTracer::ThreadBuffer* FlarkDJTracer::getThreadBuffer() noexcept
+{
+    // Each thread claims one ring per recording session, without locking or allocating
+    struct Claim
+    {
+        int session = 0;
+        ThreadBuffer* buffer = nullptr;
+    };
+
+    thread_local Claim claim;
+
+    auto* tracer = activeTracer.load(std::memory_order_acquire);
+    if (tracer == nullptr)
+        return nullptr;
+
+    if (claim.session != tracer->session)
+    {
+        const int index = tracer->numClaimedBuffers.fetch_add(1);
+        claim.session = tracer->session;
+        claim.buffer = index < maxThreads ? &tracer->buffers[static_cast<size_t>(index)] : nullptr;
+    }
+
+    return claim.buffer;
+}
+
+void FlarkDJTracer::record(const char* name, juce::int64 beginTicks, juce::int64 endTicks) noexcept
+{
+    auto* buffer = getThreadBuffer();
+    if (buffer == nullptr)
+        return;
+
+    const auto write = buffer->writePos.load(std::memory_order_relaxed);
+
+    if (write - buffer->readPos.load(std::memory_order_acquire) >= static_cast<juce::uint32>(eventsPerThread))
+    {
+        buffer->numDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer->events[write & (eventsPerThread - 1)] = { name, beginTicks, endTicks };
+    buffer->writePos.store(write + 1, std::memory_order_release);
+}
+
+void FlarkDJTracer::nameCurrentThread(const char* name) noexcept
+{
+    if (auto* buffer = getThreadBuffer())
+        if (buffer->threadName.load(std::memory_order_relaxed) == nullptr)
+            buffer->threadName.store(name, std::memory_order_release);
+}
+
+//==============================================================================
+void FlarkDJTracer::run()
+{
+    while (! threadShouldExit())
+    {
+        drain();
+        wait(100);
+    }
+}
+
+void FlarkDJTracer::drain()
+{
+    const double ticksPerMicrosecond = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) / 1.0e6;
+    const int numBuffers = juce::jmin(numClaimedBuffers.load(), static_cast<int>(maxThreads));
+
+    for (int i = 0; i < numBuffers; ++i)
+    {
+        auto& buffer = buffers[static_cast<size_t>(i)];
+        const int tid = i + 1;
+
+        if (! threadNameWritten[i])
+        {
+            if (auto* name = buffer.threadName.load(std::memory_order_acquire))
+            {
+                writeEvent("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + juce::String(tid)
+                           + ",\"args\":{\"name\":\"" + juce::String(name) + "\"}}");
+                threadNameWritten[i] = true;
+            }
+        }
+
+        const auto write = buffer.writePos.load(std::memory_order_acquire);
+        auto read = buffer.readPos.load(std::memory_order_relaxed);
+
+        for (; read != write; ++read)
+        {
+            const auto& event = buffer.events[read & (eventsPerThread - 1)];
+            const double ts = static_cast<double>(event.begin - startTicks) / ticksPerMicrosecond;
+            const double dur = static_cast<double>(event.end - event.begin) / ticksPerMicrosecond;
+
+            writeEvent("{\"name\":\"" + juce::String(event.name) + "\",\"cat\":\"flarkdj\",\"ph\":\"X\",\"ts\":"
+                       + juce::String(ts, 3) + ",\"dur\":" + juce::String(dur, 3)
+                       + ",\"pid\":1,\"tid\":" + juce::String(tid) + "}");
+        }
+
+        buffer.readPos.store(read, std::memory_order_release);
+
+        // Report drops as instant events so gaps in the timeline are explained
+        if (const auto dropped = buffer.numDropped.exchange(0, std::memory_order_relaxed))
+        {
+            const double ts = static_cast<double>(juce::Time::getHighResolutionTicks() - startTicks) / ticksPerMicrosecond;
+            writeEvent("{\"name\":\"dropped " + juce::String(static_cast<int>(dropped)) + " events\",\"ph\":\"i\",\"s\":\"t\",\"ts\":"
+                       + juce::String(ts, 3) + ",\"pid\":1,\"tid\":" + juce::String(tid) + "}");
+        }
+    }
+
+    output->flush();
+}
+
+void FlarkDJTracer::writeEvent(const juce::String& json)
+{
+    if (! firstEvent)
+        *output << ",\n";
+
+    *output << json;
+    firstEvent = false;
+}
+
+#endif
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+/**
+ * FlarkDJ Tracing
+ *
+ * Optional timeline tracing, compiled in with -DFLARKDJ_ENABLE_TRACING=ON
+ * (which defines FLARKDJ_TRACING=1). With tracing compiled out the macros
+ * below expand to nothing.
+ *
+ * Scoped events are written into per-thread lock-free ring buffers; a
+ * background thread drains them into a Chrome trace-event JSON file that
+ * chrome://tracing or ui.perfetto.dev can open. Recording starts when the
+ * first processor is created with FLARKDJ_TRACE_FILE set, e.g.
+ *
+ *     FLARKDJ_TRACE_FILE=/tmp/flarkdj-trace.json ./FlarkDJ
+ *
+ * Event names must be string literals (only the pointer is stored). Events
+ * are dropped, not blocked on, when a thread's ring is full.
+ */
+
+#ifndef FLARKDJ_TRACING
+ #define FLARKDJ_TRACING 0
+#endif
+
+#if FLARKDJ_TRACING
+
+#include <atomic>
+
+class FlarkDJTracer : private juce::Thread
+{
+public:
+    static constexpr int maxThreads = 32;
+    static constexpr int eventsPerThread = 1 << 14;
+
+    // Shared between all processor instances via juce::SharedResourcePointer
+    FlarkDJTracer();
+    ~FlarkDJTracer() override;
+
+    // Records a finished event on the calling thread. Safe on the audio thread.
+    static void record(const char* name, juce::int64 beginTicks, juce::int64 endTicks) noexcept;
+
+    // Labels the calling thread's track in the trace
+    static void nameCurrentThread(const char* name) noexcept;
+
+    class ScopedEvent
+    {
+    public:
+        explicit ScopedEvent(const char* eventName) noexcept
+            : name(eventName), begin(juce::Time::getHighResolutionTicks()) {}
+
+        ~ScopedEvent() { record(name, begin, juce::Time::getHighResolutionTicks()); }
+
+    private:
+        const char* name;
+        const juce::int64 begin;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedEvent)
+    };
+
+private:
+    struct Event
+    {
+        const char* name;
+        juce::int64 begin, end;
+    };
+
+    // Single-producer (the owning thread), single-consumer (the writer) ring
+    struct ThreadBuffer
+    {
+        std::atomic<const char*> threadName { nullptr };
+        std::atomic<juce::uint32> writePos { 0 }, readPos { 0 };
+        std::atomic<juce::uint32> numDropped { 0 };
+        Event events[eventsPerThread];
+    };
+
+    static ThreadBuffer* getThreadBuffer() noexcept;
+
+    void run() override;
+    void drain();
+    void writeEvent(const juce::String& json);
+
+    std::unique_ptr<ThreadBuffer[]> buffers;
+    std::atomic<int> numClaimedBuffers { 0 };
+    bool threadNameWritten[maxThreads] {};
+
+    std::unique_ptr<juce::FileOutputStream> output;
+    juce::int64 startTicks = 0;
+    bool firstEvent = true;
+    int session = 0;
+
+    static std::atomic<FlarkDJTracer*> activeTracer;
+    static std::atomic<int> sessionCounter;
+
+    JUCE_DECLARE_NON_COPYABLE(FlarkDJTracer)
+};
+
+#define FLARKDJ_TRACE_SCOPE(name)   const FlarkDJTracer::ScopedEvent JUCE_JOIN_MACRO(flarkdjTraceEvent_, __LINE__)(name)
+#define FLARKDJ_TRACE_THREAD(name)  FlarkDJTracer::nameCurrentThread(name)
+
+// Class member that keeps the tracer alive while its owner exists
+#define FLARKDJ_TRACE_SESSION       juce::SharedResourcePointer<FlarkDJTracer> flarkdjTraceSession
+
+#else
+
+#define FLARKDJ_TRACE_SCOPE(name)
+#define FLARKDJ_TRACE_THREAD(name)
+#define FLARKDJ_TRACE_SESSION       static_assert(true, "")
+
+#endif
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * FlarkDJ Work-Stealing Thread Pool
+ *
+ * Runs a fixed batch of tasks on a set of worker threads. Tasks are dealt
+ * round-robin into per-worker queues; a worker takes from the front of its own
+ * queue and, when that is empty, steals from the back of another worker's.
+ * Long and short jobs (e.g. audio files of very different lengths) therefore
+ * balance out without a shared queue being hammered by every worker.
+ */
+class FlarkWorkStealingPool
+{
+public:
+    // A task receives the index of the worker running it, so callers can keep
+    // per-worker state (such as one processor instance per worker)
+    using Task = std::function<void(int workerIndex)>;
+
+    // cpuCores optionally pins worker i to cpuCores[i % cpuCores.size()]
+    explicit FlarkWorkStealingPool(int numWorkersToUse, std::vector<int> cpuCores = {})
+        : numWorkers(juce::jmax(1, numWorkersToUse)), cores(std::move(cpuCores)),
+          queues(static_cast<size_t>(numWorkers))
+    {
+    }
+
+    int getNumWorkers() const { return numWorkers; }
+
+    // Thread affinity masks are 32 bits wide, so only CPUs 0-31 can be pinned
+    static constexpr int maxPinnableCpus = 32;
+    static bool canPin(int core) { return juce::isPositiveAndBelow(core, maxPinnableCpus); }
+
+    // Runs every task and returns when all have finished
+    void run(std::vector<Task> tasks)
+    {
+        for (size_t i = 0; i < tasks.size(); ++i)
+            queues[i % queues.size()].tasks.push_back(std::move(tasks[i]));
+
+        std::vector<std::thread> threads;
+        threads.reserve(static_cast<size_t>(numWorkers));
+
+        for (int i = 0; i < numWorkers; ++i)
+            threads.emplace_back([this, i] { workerLoop(i); });
+
+        for (auto& t : threads)
+            t.join();
+    }
+
+private:
+    struct WorkQueue
+    {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(int workerIndex)
+    {
+        if (! cores.empty())
+        {
+            const int core = cores[static_cast<size_t>(workerIndex) % cores.size()];
+
+            // Callers reject cores that cannot be pinned up front
+            jassert(canPin(core));
+
+            if (canPin(core))
+                juce::Thread::setCurrentThreadAffinityMask(1u << core);
+        }
+
+        Task task;
+        while (takeTask(workerIndex, task))
+            task(workerIndex);
+    }
+
+    bool takeTask(int workerIndex, Task& task)
+    {
+        // Own queue first, oldest task first
+        {
+            auto& own = queues[static_cast<size_t>(workerIndex)];
+            std::lock_guard<std::mutex> guard(own.lock);
+
+            if (! own.tasks.empty())
+            {
+                task = std::move(own.tasks.front());
+                own.tasks.pop_front();
+                return true;
+            }
+        }
+
+        // Then steal the newest task from the other queues
+        for (int offset = 1; offset < numWorkers; ++offset)
+        {
+            auto& victim = queues[static_cast<size_t>((workerIndex + offset) % numWorkers)];
+            std::lock_guard<std::mutex> guard(victim.lock);
+
+            if (! victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.back());
+                victim.tasks.pop_back();
+                return true;
+            }
+        }
+
+        // The batch is fixed, so an empty sweep means all work has been taken
+        return false;
+    }
+
+    const int numWorkers;
+    const std::vector<int> cores;
+    std::vector<WorkQueue> queues;
+
+    JUCE_DECLARE_NON_COPYABLE(FlarkWorkStealingPool)
+};